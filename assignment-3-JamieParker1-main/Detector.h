@@ -1,5 +1,6 @@
 #ifndef DETECTOR_H
 #define DETECTOR_H
+#include <memory>
 
 using namespace std;
 class detector
@@ -7,52 +8,139 @@ class detector
 private:
   string type;                               // Type of the detector (e.g., tracker, calorimeter)
   map<string, double> particle_efficiencies; // Efficiencies for detecting each particle type
+  vector<double> id_efficiencies;            // Efficiency for each particle type ID, no_efficiency where the map has none
+  map<string, shared_ptr<const efficiency_curve>> particle_curves; // Kinematics-dependent efficiencies, used in place of the flat ones
+  vector<shared_ptr<const efficiency_curve>> id_curves;           // Curve for each particle type ID, null where the map has none
 public:
+  static constexpr double no_efficiency = -1; // Marks a particle type the detector has no efficiency for
+
   // Default constructor
   detector() : type(""), particle_efficiencies({}) {}
 
-  // Paramaterised constructor
-  detector(string type, map<string, double> particle_efficiencies)
-      : type(type), particle_efficiencies(particle_efficiencies) {}
+  // Paramaterised constructor, optionally with efficiency curves for some particle types
+  detector(string type, map<string, double> particle_efficiencies, const map<string, efficiency_curve> &curves = {})
+      : type(type), particle_efficiencies(particle_efficiencies)
+  {
+    for (const auto &pair : curves)
+    {
+      particle_curves[pair.first] = make_shared<const efficiency_curve>(pair.second);
+    }
+  }
 
   // Destructor
   ~detector() {}
 
   // Getter functions
   string get_type() const {return type; }
-  map<string, double> get_particle_efficiencies() const { return particle_efficiencies; }
+  const map<string, double> &get_particle_efficiencies() const { return particle_efficiencies; }
+  const map<string, shared_ptr<const efficiency_curve>> &get_particle_curves() const { return particle_curves; }
+
+  // Returns the efficiency for a particle type, or nullptr if the detector has none. Uses the
+  // particle's type ID when both were registered with the manager, and the type name otherwise.
+  const double *find_efficiency(const particle &p) const
+  {
+    if (p.get_id() < id_efficiencies.size())
+    {
+      const double &efficiency = id_efficiencies[p.get_id()];
+      return efficiency == no_efficiency ? nullptr : &efficiency;
+    }
+    auto it = particle_efficiencies.find(p.get_type());
+    return it == particle_efficiencies.end() ? nullptr : &it->second;
+  }
+
+  // Returns the efficiency curve for a particle type, or nullptr if its efficiency is flat
+  const efficiency_curve *find_efficiency_curve(const particle &p) const
+  {
+    if (p.get_id() < id_curves.size())
+    {
+      return id_curves[p.get_id()].get();
+    }
+    auto it = particle_curves.find(p.get_type());
+    return it == particle_curves.end() ? nullptr : it->second.get();
+  }
+
+  // Returns the efficiency for a particle instance, from its curve if it has one, or -1 if the detector has none
+  double get_efficiency(const particle_instance &p) const
+  {
+    if (const efficiency_curve *curve = find_efficiency_curve(p))
+    {
+      return curve->evaluate(p);
+    }
+    const double *efficiency = find_efficiency(p);
+    return efficiency ? *efficiency : no_efficiency;
+  }
+
+  // Records the efficiency and curve for a registered particle type under its type ID
+  void resolve_particle_id(const particle &p)
+  {
+    if (id_efficiencies.size() <= p.get_id())
+    {
+      id_efficiencies.resize(p.get_id() + 1, no_efficiency);
+      id_curves.resize(p.get_id() + 1);
+    }
+    auto it = particle_efficiencies.find(p.get_type());
+    id_efficiencies[p.get_id()] = it == particle_efficiencies.end() ? no_efficiency : it->second;
+    auto curve = particle_curves.find(p.get_type());
+    id_curves[p.get_id()] = curve == particle_curves.end() ? nullptr : curve->second;
+  }
 
   // 
-  void print_info();
+  void print_info() const;
+  void print_efficiencies() const;
 };
 
-class detector_instance : public detector {
+class detector_instance {
 private:
+    shared_ptr<const detector> definition; // Detector type, shared with the manager and every other instance of it
     bool status;   // Status of the detector (true for on, false for off)
-    vector<particle_instance*> particles_tracked; // Particles tracked by the detector
+    vector<size_t> particles_tracked; // Indices into the simulation's particles of the particles detected
+    double radius; // Radius of the detector's barrel layer in metres, only used by layered runs
 
 public:
-    // Constructor that takes an existing detector object, status, and optionally a list of particles tracked
-    detector_instance(const detector& d, bool status, const vector<particle_instance*>& particles_tracked = {}) 
-        : detector(d), status(status), particles_tracked(particles_tracked) {}
+    // Constructor that shares an existing detector definition
+    detector_instance(shared_ptr<const detector> definition, bool status, double radius = 0)
+        : definition(move(definition)), status(status), particles_tracked({}), radius(radius) {}
 
-    // Destructor - handle the deletion of particle_instance pointers if ownership is transferred
+    // Constructor that takes a standalone detector object, copying it once into a new shared definition
+    detector_instance(const detector& d, bool status, double radius = 0)
+        : definition(make_shared<const detector>(d)), status(status), particles_tracked({}), radius(radius) {}
+
+    // Destructor
     ~detector_instance() {}
 
+    // Getters for the shared definition
+    const detector& get_definition() const { return *definition; }
+    string get_type() const { return definition->get_type(); }
+    const map<string, double> &get_particle_efficiencies() const { return definition->get_particle_efficiencies(); }
+    const double *find_efficiency(const particle &p) const { return definition->find_efficiency(p); }
+    const efficiency_curve *find_efficiency_curve(const particle &p) const { return definition->find_efficiency_curve(p); }
+    double get_efficiency(const particle_instance &p) const { return definition->get_efficiency(p); }
+
     // Getter for status
     bool get_status() const { return status; }
 
-    // Getter for particles tracked
-    const vector<particle_instance*>& get_particles_tracked() const { return particles_tracked; }
+    // Getter and setter for the layer radius
+    double get_radius() const { return radius; }
+    void set_radius(double new_radius) { radius = new_radius; }
+
+    // Getter for the indices of the particles tracked
+    const vector<size_t>& get_particles_tracked() const { return particles_tracked; }
+
+    // Preallocates the hit buffer for a run over a number of particles, discarding earlier hits
+    void reset_tracking(size_t number_of_particles)
+    {
+        particles_tracked.clear();
+        particles_tracked.reserve(number_of_particles);
+    }
 
-    // Function to add a particle instance to the tracking list
-    void track_particle(particle_instance* particle) {particles_tracked.push_back(particle); }
+    // Function to add a particle's index to the tracking list
+    void track_particle(size_t particle_index) {particles_tracked.push_back(particle_index); }
 
     // Function to change the detector's status
     void set_status(bool new_status) {status = new_status; }
 
     // Function to print out all detector info
-    void print_info();
+    void print_info() const;
 
     
 };
@@ -0,0 +1,65 @@
+#ifndef EFFICIENCY_CURVE_H
+#define EFFICIENCY_CURVE_H
+#include <vector>
+#include <algorithm>
+#include <utility>
+
+using namespace std;
+
+// Kinematic quantity a detector's efficiency can depend on
+enum class kinematic_variable
+{
+  beta,    // v/c
+  momentum // MeV/c, from the rest mass and beta
+};
+
+// Piecewise-linear efficiency as a function of one kinematic variable. Evaluation finds the
+// segment by binary search over the points and interpolates with the segment's precomputed slope,
+// so the curve is exact at every value, kinks included, however closely the points are spaced.
+// Values outside the table are clamped to its end points.
+class efficiency_curve
+{
+private:
+  kinematic_variable variable;
+  vector<pair<double, double>> points; // (variable, efficiency) as given, for printing
+  vector<double> knots;                // Variable at each point, stored contiguously for the search
+  vector<double> values;               // Efficiency at each point
+  vector<double> slopes;               // Efficiency per unit of the variable on each segment
+
+public:
+  // Paramaterised constructor, taking points in strictly increasing order of the variable with
+  // efficiencies between 0 and 1
+  efficiency_curve(kinematic_variable variable, const vector<pair<double, double>> &points);
+
+  // Getter functions
+  kinematic_variable get_variable() const { return variable; }
+  const vector<pair<double, double>> &get_points() const { return points; }
+
+  // Returns the efficiency at a value of the variable
+  double evaluate(double x) const
+  {
+    if (!(x > knots.front()))
+    {
+      return values.front();
+    }
+    if (x >= knots.back())
+    {
+      return values.back();
+    }
+    const size_t segment = static_cast<size_t>(upper_bound(knots.begin(), knots.end(), x) - knots.begin()) - 1;
+    return values[segment] + (x - knots[segment]) * slopes[segment];
+  }
+
+  // Evaluates the curve for a column of values in one pass, giving the same results as evaluate()
+  void evaluate(const double *x, double *efficiencies, size_t count) const
+  {
+    for (size_t i = 0; i < count; ++i)
+    {
+      efficiencies[i] = evaluate(x[i]);
+    }
+  }
+
+  // Returns the efficiency for a particle instance, from its beta or momentum
+  double evaluate(const particle_instance &p) const { return evaluate(variable == kinematic_variable::beta ? p.get_beta() : p.get_momentum()); }
+};
+#endif
@@ -1,6 +1,8 @@
 #ifndef MANAGER_H
 #define MANAGER_H
 #include <string>
+#include <unordered_map>
+#include <memory>
 
 using namespace std;
 
@@ -8,12 +10,16 @@ class manager
 {
 private:
   vector<particle> defined_particles; // List of predefined and user-created particles
-  vector<detector> defined_detectors; // List of predefined and user-created detectors
+  vector<shared_ptr<const detector>> defined_detectors; // List of predefined and user-created detectors, shared with their instances
+
+  // Index of each type by name. Types are only ever appended, so a type's position, which is its ID, never changes.
+  unordered_map<string, size_t> particle_ids;
+  unordered_map<string, size_t> detector_ids;
 
 public:
   void add_particle_type(string type, double rest_mass, int charge); // Non interactive creation of a particle
 
-  void add_detector_type(string type, map<string, double> particle_efficiencies); // Non interactive creation of a detector
+  void add_detector_type(string type, map<string, double> particle_efficiencies, const map<string, efficiency_curve> &curves = {}); // Non interactive creation of a detector
   void add_detector_type_interface();                                             // Interactive creation of a detector
 
   void edit_particle_type(string type); // Edit properties of an existing particle
@@ -22,11 +28,15 @@ public:
   void delete_particle_type(string type); // Delete a particle type
   void delete_detector_type(string type); // Delete a detector type
 
-  void update_detectors_for_new_particle_type(const particle &particle); // Updates all detectors with a default efficiency for a new particle type
+  void update_detectors_for_new_particle_type(const particle &particle); // Records a new particle type's ID in every detector
+
+  // Returns the type with a given name, or nullptr if it is not defined
+  const particle *find_particle_type(const string &type) const;
+  shared_ptr<const detector> find_detector_type(const string &type) const;
 
   // Getters
-  vector<particle>& get_defined_particles() {return this->defined_particles; } 
-  vector<detector> get_defined_detectors() const { return defined_detectors; }
+  const vector<particle> &get_defined_particles() const { return defined_particles; }
+  const vector<shared_ptr<const detector>> &get_defined_detectors() const { return defined_detectors; }
 };
 #endif
 
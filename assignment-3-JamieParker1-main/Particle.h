@@ -3,6 +3,7 @@
 
 #include "constants.h"
 #include <stdexcept> // Include this for std::invalid_argument
+#include <cmath>
 using namespace std;
 
 //int speed_of_light = 299792458; // m/s
@@ -13,7 +14,10 @@ private:
   string type;      // Type of the particle (e.g., electron, muon)
   int charge;       // Charge of the particle
   double rest_mass; // Rest mass of the particle in MeV
+  size_t id = no_id; // Type ID given by the manager, an index into its defined particles
 public:
+  static constexpr size_t no_id = static_cast<size_t>(-1); // ID of a particle type not registered with a manager
+
   // Default constructor
   particle() : type(""), rest_mass(0), charge(0){}
 
@@ -28,9 +32,13 @@ public:
   string get_type() const { return type; }
   double get_rest_mass() const { return rest_mass; }
   int get_charge() const { return charge; }
+  size_t get_id() const { return id; }
+
+  // Setter for the type ID, only called by the manager when the type is registered
+  void set_id(size_t new_id) { id = new_id; }
 
   //
-  void print_info();
+  void print_info() const;
 };
 
 class particle_instance : public particle
@@ -58,8 +66,11 @@ public:
   // Getter for beta
   double get_beta() const { return beta; }
 
+  // Returns the momentum in MeV/c, gamma * m * beta, which is infinite for a massive particle at the speed of light
+  double get_momentum() const { return get_rest_mass() == 0 ? 0 : get_rest_mass() * beta / sqrt(1 - beta * beta); }
+
   // Print out all particle info
-  void print_info();
+  void print_info() const;
 
 };
 #endif //PARTICLE_H
\ No newline at end of file
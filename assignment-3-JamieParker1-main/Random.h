@@ -0,0 +1,92 @@
+#ifndef RANDOM_H
+#define RANDOM_H
+
+#include <array>
+#include <cstdint>
+#include <limits>
+
+using namespace std;
+
+// Counter-based Philox4x32-10 generator (Salmon et al., "Parallel random numbers: as easy as 1, 2, 3").
+// Every draw is a pure function of (seed, stream, index), so any partition of the work can compute
+// its own numbers directly and results are identical however the work is split between threads.
+class philox_stream
+{
+private:
+  array<uint32_t, 2> key; // From the seed
+  uint64_t stream;        // Upper half of the 128-bit counter
+
+  // Multiplies two 32-bit words, returning the high and low halves of the product
+  static void multiply(uint32_t a, uint32_t b, uint32_t &high, uint32_t &low)
+  {
+    const uint64_t product = uint64_t(a) * b;
+    high = static_cast<uint32_t>(product >> 32);
+    low = static_cast<uint32_t>(product);
+  }
+
+public:
+  // Paramaterised constructor, seed selects the key and stream selects an independent sequence
+  explicit philox_stream(uint64_t seed, uint64_t stream = 0)
+      : key({static_cast<uint32_t>(seed), static_cast<uint32_t>(seed >> 32)}), stream(stream) {}
+
+  // Getter functions
+  uint64_t get_seed() const { return uint64_t(key[0]) | uint64_t(key[1]) << 32; }
+  uint64_t get_stream() const { return stream; }
+
+  // Returns an independent stream with the same seed, e.g. one per thread or per partition
+  philox_stream split(uint64_t new_stream) const { return philox_stream(get_seed(), new_stream); }
+
+  // Returns the four 32-bit words at a position in the stream
+  array<uint32_t, 4> generate(uint64_t index) const
+  {
+    array<uint32_t, 4> counter = {static_cast<uint32_t>(index), static_cast<uint32_t>(index >> 32),
+                                  static_cast<uint32_t>(stream), static_cast<uint32_t>(stream >> 32)};
+    array<uint32_t, 2> round_key = key;
+    for (int round = 0; round < 10; ++round)
+    {
+      uint32_t high0, low0, high1, low1;
+      multiply(0xD2511F53u, counter[0], high0, low0);
+      multiply(0xCD9E8D57u, counter[2], high1, low1);
+      counter = {high1 ^ counter[1] ^ round_key[0], low1, high0 ^ counter[3] ^ round_key[1], low0};
+      round_key[0] += 0x9E3779B9u;
+      round_key[1] += 0xBB67AE85u;
+    }
+    return counter;
+  }
+
+  // Returns one of the two 64-bit halves of a block of four words
+  static uint64_t half(const array<uint32_t, 4> &block, uint64_t which)
+  {
+    return which ? uint64_t(block[2]) | uint64_t(block[3]) << 32 : uint64_t(block[0]) | uint64_t(block[1]) << 32;
+  }
+
+  // Returns 64 random bits at a position in the stream. Positions 2n and 2n + 1 are the two halves
+  // of block n, so sequential consumers can generate each block once.
+  uint64_t bits(uint64_t index) const { return half(generate(index >> 1), index & 1); }
+
+  // Returns a uniform double in [0, 1) with 53 random bits at a position in the stream
+  double uniform(uint64_t index) const { return (bits(index) >> 11) * 0x1.0p-53; }
+};
+
+// Sequential view of a philox_stream that satisfies UniformRandomBitGenerator, so it can drive the
+// standard distributions. Each call returns the next 64-bit value in the stream.
+class philox_engine
+{
+private:
+  philox_stream stream;
+  uint64_t index;
+
+public:
+  using result_type = uint64_t;
+
+  // Paramaterised constructor, starting at a position in the stream
+  explicit philox_engine(const philox_stream &stream, uint64_t index = 0) : stream(stream), index(index) {}
+
+  static constexpr result_type min() { return 0; }
+  static constexpr result_type max() { return numeric_limits<result_type>::max(); }
+  result_type operator()() { return stream.bits(index++); }
+
+  // Skips ahead by a number of draws in constant time
+  void discard(uint64_t count) { index += count; }
+};
+#endif
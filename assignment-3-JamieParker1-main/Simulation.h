@@ -5,6 +5,9 @@
 #include <vector>
 #include <map>
 #include <string>
+#include <random>
+#include <cstdint>
+#include <utility>
 
 
 class simulation
@@ -12,25 +15,55 @@ class simulation
 private:
   vector<detector_instance> detectors; // List of detector_instances in the simulation
   vector<particle_instance> particles; // List of particles to simulate
+  uint64_t seed;                       // Seed of the random stream, a run is reproducible for a given seed
+
+  // Returns the particle types in the simulation, in order of first appearance
+  vector<string> get_particle_types() const;
 
 public:
-  // Default constructor
-  simulation() : detectors({}), particles({}) {}
+  // Default constructor, seeded from the system's random device
+  simulation() : detectors({}), particles({}), seed(random_device{}()) {}
+
+  // Paramaterised constructor, taking ownership of the detectors and particles without copying them
+  simulation(vector<detector_instance> &&detectors, vector<particle_instance> &&particles, uint64_t seed = random_device{}())
+      : detectors(move(detectors)), particles(move(particles)), seed(seed) {}
 
-  // Paramaterised constructor
-  simulation(vector<detector_instance> detectors, vector<particle_instance> particles)
-      : detectors(detectors), particles(particles) {}
+  // A simulation owns its whole configuration, so it can be moved but not copied
+  simulation(const simulation &) = delete;
+  simulation &operator=(const simulation &) = delete;
+  simulation(simulation &&) = default;
+  simulation &operator=(simulation &&) = default;
 
   // Destructor
   ~simulation() {}
 
   // Adds detector to simulation
-  void add_detector(const detector_instance &newDetector){detectors.push_back(newDetector);}
+  void add_detector(detector_instance newDetector){detectors.push_back(move(newDetector));}
 
   // Adds particle to simulation
-  void add_particle(const particle_instance &newParticle){particles.push_back(newParticle);}
+  void add_particle(particle_instance newParticle){particles.push_back(move(newParticle));}
+
+  // Getters
+  const vector<detector_instance> &get_detectors() const { return detectors; }
+  const vector<particle_instance> &get_particles() const { return particles; }
+
+  // Getter and setter for the seed
+  uint64_t get_seed() const { return seed; }
+  void set_seed(uint64_t new_seed) { seed = new_seed; }
+
+  // Runs simulation, printing a line for every print_every-th particle (none if 0) and a summary per detector
+  void run_simulation(size_t print_every = 1);
+
+  // Runs simulation in statistics mode, returning per-detector, per-type counters and joint-detection
+  // histograms without any per-particle output. Detections are the same as run_headless for the same seed.
+  simulation_statistics run_statistics(unsigned number_of_threads = 1) const;
+
+  // Runs simulation without console output, returning a detector x particle hit matrix.
+  // Gives the same detections as run_simulation for the same seed, whatever the number of threads.
+  hit_matrix run_headless(unsigned number_of_threads = 1) const;
 
-  // Runs simulation
-  void run_simulation(); 
+  // Runs simulation with each detector as a barrel layer at its radius, returning the hits in the
+  // order the particles reach the layers. Detections are the same as run_headless for the same seed.
+  vector<hit_event> run_layered(unsigned number_of_threads = 1) const;
 };
 #endif
\ No newline at end of file
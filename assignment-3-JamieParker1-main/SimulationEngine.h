@@ -0,0 +1,200 @@
+#ifndef SIMULATION_ENGINE_H
+#define SIMULATION_ENGINE_H
+
+#include "Random.h"
+
+#include <cstdint>
+#include <vector>
+#include <string>
+#include <memory>
+#include <queue>
+#include <functional>
+#include <utility>
+
+using namespace std;
+
+// Compact detector x particle result of a headless simulation, one bit per trial
+class hit_matrix
+{
+private:
+  size_t number_of_detectors;
+  size_t number_of_particles;
+  size_t words_per_detector;  // 64 particles per word
+  vector<uint64_t> hit_bits;  // Row per detector
+
+public:
+  // Default constructor
+  hit_matrix() : number_of_detectors(0), number_of_particles(0), words_per_detector(0), hit_bits({}) {}
+
+  // Paramaterised constructor, with every bit cleared
+  hit_matrix(size_t number_of_detectors, size_t number_of_particles)
+      : number_of_detectors(number_of_detectors), number_of_particles(number_of_particles),
+        words_per_detector((number_of_particles + 63) / 64), hit_bits(number_of_detectors * ((number_of_particles + 63) / 64), 0) {}
+
+  // Getter functions
+  size_t get_number_of_detectors() const { return number_of_detectors; }
+  size_t get_number_of_particles() const { return number_of_particles; }
+  bool is_hit(size_t detector, size_t particle) const { return (hit_bits[detector * words_per_detector + particle / 64] >> (particle % 64)) & 1; }
+
+  // Gives direct access to one detector's row of 64-particle words
+  uint64_t *get_row(size_t detector) { return hit_bits.data() + detector * words_per_detector; }
+  const uint64_t *get_row(size_t detector) const { return hit_bits.data() + detector * words_per_detector; }
+  size_t get_words_per_detector() const { return words_per_detector; }
+
+  // Counts how many particles a detector detected
+  size_t count_hits(size_t detector) const;
+};
+
+// Particles of a run as columns, one entry per particle
+struct particle_columns
+{
+  vector<uint32_t> type_ids; // Engine column of each particle's type
+  vector<double> betas;      // Needed for efficiency curves and layered runs
+  vector<double> momenta;    // MeV/c, only needed when a detector has an efficiency curve
+};
+
+// Headless detector simulation. Detector efficiencies are compiled into a dense
+// [detector x particle type] table of integer thresholds, and every detection is drawn from a
+// Philox stream at position detector * particles + particle, so no state is shared between trials
+// and the particles can be split across threads without changing the result.
+class simulation_engine
+{
+private:
+  vector<string> detector_types;       // Type of each detector row
+  vector<string> particle_types;       // Type of each particle type column
+  vector<uint64_t> detection_thresholds; // [detector * particle_types.size() + type], out of 2^53
+  vector<shared_ptr<const efficiency_curve>> curves; // Every efficiency curve used by an active detector
+  vector<int32_t> curve_slots;                       // [detector * particle_types.size() + type], position in detector_curves or -1 when flat
+  vector<vector<uint32_t>> detector_curves;          // Curves used by each detector
+  vector<uint8_t> sensitive;                         // [detector * particle_types.size() + type], 1 if the detector is on and has an efficiency for the type
+  philox_stream random;
+
+  // Draws the trials of every detector for the particles in words [first_word, last_word) of the hit rows
+  void run_words(const particle_columns &particles, hit_matrix &hits, size_t first_word, size_t last_word) const;
+
+public:
+  // Paramaterised constructor, compiling the efficiencies of the given detector instances for the given particle types.
+  // Detectors that are switched off, and particle types a detector has no efficiency for, never detect.
+  simulation_engine(const vector<detector_instance> &detectors, const vector<string> &particle_types, uint64_t seed);
+
+  // Getter functions
+  size_t get_number_of_detectors() const { return detector_types.size(); }
+  const vector<string> &get_detector_types() const { return detector_types; }
+  const vector<string> &get_particle_types() const { return particle_types; }
+  uint64_t get_seed() const { return random.get_seed(); }
+
+  // Returns the column of a particle type, throwing if it was not compiled into the engine
+  uint32_t get_particle_type_id(const string &type) const;
+  // Converts particle instances into a column of particle type ids
+  vector<uint32_t> get_particle_type_ids(const vector<particle_instance> &particles) const;
+  // Converts particle instances into the type id and kinematics columns of a run
+  particle_columns get_particle_columns(const vector<particle_instance> &particles) const;
+  // Returns true if a detector is on and has an efficiency for a particle type, i.e. each particle of the type is a trial
+  bool is_sensitive(size_t detector, size_t type) const { return sensitive[detector * particle_types.size() + type]; }
+  // Returns true if any active detector has an efficiency curve, so runs need the kinematics columns
+  bool has_efficiency_curves() const { return !curves.empty(); }
+
+  // Draws every particle-detector trial and returns the hits. The particles are partitioned between
+  // threads in blocks of 64, and the hits are bit-identical for a given seed whatever the thread count.
+  hit_matrix run(const particle_columns &particles, unsigned number_of_threads = 1) const;
+};
+
+// Aggregated results of runs, kept in tables whose size depends only on the numbers of detectors and
+// types, so statistics over millions of particles cost no output and no per-particle memory
+class simulation_statistics
+{
+public:
+  static constexpr size_t max_joint_detectors = 16; // Detectors covered by the joint-detection histogram
+
+private:
+  vector<string> detector_types;
+  vector<string> particle_types;
+  vector<uint64_t> particles_per_type; // [type]
+  vector<uint64_t> trials;             // [detector * types + type], particles the detector was sensitive to
+  vector<uint64_t> detections;         // [detector * types + type]
+  size_t joint_detectors;              // The first joint_detectors detectors form the histogram's bitmask
+  vector<uint64_t> joint_detections;   // [type << joint_detectors | mask], particles detected by exactly the detectors in mask
+
+public:
+  // Paramaterised constructor, with empty tables for an engine's detectors and types
+  explicit simulation_statistics(const simulation_engine &engine);
+
+  // Adds the hits of a run with the same engine
+  void add_run(const simulation_engine &engine, const particle_columns &particles, const hit_matrix &hits);
+
+  // Getter functions
+  size_t get_number_of_detectors() const { return detector_types.size(); }
+  size_t get_number_of_types() const { return particle_types.size(); }
+  size_t get_joint_detectors() const { return joint_detectors; }
+  uint64_t get_particles(size_t type) const { return particles_per_type[type]; }
+  uint64_t get_trials(size_t detector, size_t type) const { return trials[detector * particle_types.size() + type]; }
+  uint64_t get_detections(size_t detector, size_t type) const { return detections[detector * particle_types.size() + type]; }
+  uint64_t get_joint_detections(size_t type, uint32_t mask) const { return joint_detections[(type << joint_detectors) | mask]; }
+
+  // Returns the measured efficiency of a detector for a type, 0 if it had no trials
+  double get_efficiency(size_t detector, size_t type) const;
+
+  // Returns the Wilson score interval on the efficiency, z = 1.96 for 95% confidence
+  pair<double, double> get_wilson_interval(size_t detector, size_t type, double z = 1.96) const;
+
+  // Prints the efficiency table and the non-empty joint-detection bins
+  void print() const;
+};
+
+// One detection in a layered run, at the time the particle reaches the detector's layer
+struct hit_event
+{
+  double time;       // Seconds after the particles leave the interaction point
+  uint32_t detector; // Row of the detector in the engine
+  uint32_t particle; // Index of the particle in the run
+
+  // Orders by time, then detector and particle so equal times come out in a fixed order
+  bool operator>(const hit_event &other) const
+  {
+    return time != other.time ? time > other.time : detector != other.detector ? detector > other.detector : particle > other.particle;
+  }
+};
+
+// Layered barrel geometry. Each detector is a cylindrical layer at a radius, every particle leaves
+// the interaction point at t = 0 and travels outward at its speed, and the hits come out of an
+// event queue in the order the particles reach the layers. Sorting the particles by speed once
+// puts every layer's hits in time order, so the queue only merges one stream per layer. Hits that
+// reach a layer at the same time, such as every hit of a layer at radius 0, are put back in
+// particle order before they are queued, so events come out in (time, detector, particle) order.
+// step() releases hits up to a time so a consumer such as a trigger can work through the run in
+// fixed latency windows.
+class layered_simulation
+{
+private:
+  vector<double> radii;          // Metres, per detector row
+  hit_matrix hits;               // Which detectors detect which particles
+  vector<double> inverse_speeds; // Seconds per metre for each particle
+  vector<uint32_t> speed_order;  // Moving particles, fastest first
+  vector<size_t> cursors;        // Position in speed_order of each layer's next unread particle
+  vector<vector<uint32_t>> tied_hits; // Each layer's hits at its current time not yet queued, last particle first
+  priority_queue<hit_event, vector<hit_event>, greater<hit_event>> queue; // Next hit of each layer
+
+  // Queues a layer's next hit, reading the next run of equal-time hits from its cursor when the current run is used up
+  void queue_next_hit(uint32_t detector);
+
+public:
+  // Paramaterised constructor, taking the radius of each of the engine's detectors in metres
+  explicit layered_simulation(vector<double> radii);
+
+  // Draws the detections with the engine and orders the moving particles by speed. Flight
+  // times are computed in batches over contiguous columns.
+  void start(const simulation_engine &engine, const particle_columns &particles, unsigned number_of_threads = 1, size_t batch_size = 4096);
+
+  // Moves every hit up to and including a time into the output in time order, returning how many were added
+  size_t step(double until_time, vector<hit_event> &output);
+
+  // Returns true once every hit has been released
+  bool finished() const { return queue.empty(); }
+
+  // Time of the next hit, infinite once finished
+  double get_next_time() const;
+
+  // Getter for the detections drawn by start()
+  const hit_matrix &get_hits() const { return hits; }
+};
+#endif
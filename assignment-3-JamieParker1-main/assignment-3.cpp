@@ -5,13 +5,20 @@
 #include <limits>
 #include <cmath>
 #include <cstdlib>
-#include <ctime>
 #include <set>
+#include <algorithm>
 #include <sstream>
 #include <iomanip>
+#include <bitset>
+#include <cstdint>
+#include <thread>
+#include <memory>
+#include <utility>
 
 #include "Particle.h"
+#include "EfficiencyCurve.h"
 #include "Detector.h"
+#include "SimulationEngine.h"
 #include "Simulation.h"
 #include "Manager.h"
 #include "constants.h"
@@ -22,21 +29,21 @@ const double electron_rest_mass = 0.511; // MeV - ish
 const double muon_rest_mass = 105.7;     // MeV - ish
 
 // Displays all defined detector types
-void output_defined_detectors(manager system)
+void output_defined_detectors(const manager &system)
 {
   cout << "Defined Detector Types:\n";
-  auto detectors = system.get_defined_detectors();
+  const auto &detectors = system.get_defined_detectors();
   for (auto it = detectors.begin(); it != detectors.end(); ++it)
   {
-    cout << distance(detectors.begin(), it) << ". " << it->get_type() << endl;
+    cout << distance(detectors.begin(), it) << ". " << (*it)->get_type() << endl;
   }
 };
 
 // Displays all defined particle types
-void output_defined_particles(manager system)
+void output_defined_particles(const manager &system)
 {
   cout << "Defined Particle Types:\n";
-  auto particles = system.get_defined_particles();
+  const auto &particles = system.get_defined_particles();
   for (auto it = particles.begin(); it != particles.end(); ++it)
   {
     cout << distance(particles.begin(), it) << ". " << it->get_type() << endl;
@@ -56,76 +63,98 @@ void clear_screen()
 }
 
 // Finds and returns particle object reference from given type
-particle &get_particle_type_obj(const std::string &type, manager &system)
+const particle &get_particle_type_obj(const std::string &type, const manager &system)
 {
-  auto &particles = system.get_defined_particles(); // Get a reference to the particles
-  for (auto &p : particles)
+  const particle *p = system.find_particle_type(type);
+  if (p == nullptr)
   {
-    if (p.get_type() == type)
-    {
-      return p;
-    }
+    throw std::runtime_error("Particle of type '" + type + "' not found.");
   }
-  // If no match is found
-  throw std::runtime_error("Particle of type '" + type + "' not found.");
+  return *p;
 }
 
-// Finds and returns detector object reference from given type
-detector get_detector_type_obj(string type, manager system)
+// Finds and returns the shared detector definition of the given type
+shared_ptr<const detector> get_detector_type_obj(const string &type, const manager &system)
 {
-  for (const auto &det : system.get_defined_detectors())
+  shared_ptr<const detector> det = system.find_detector_type(type);
+  if (det == nullptr)
   {
-    if (det.get_type() == type)
-    {
-      return det;
-    }
+    throw runtime_error("Detector of type '" + type + "' not found.");
   }
-  // If no match is found
-  throw runtime_error("Detector of type '" + type + "' not found.");
+  return det;
+}
+
+// Returns the particle type with a given name, or nullptr if it is not defined
+const particle *manager::find_particle_type(const string &type) const
+{
+  auto it = particle_ids.find(type);
+  return it == particle_ids.end() ? nullptr : &defined_particles[it->second];
+}
+
+// Returns the detector type with a given name, or nullptr if it is not defined
+shared_ptr<const detector> manager::find_detector_type(const string &type) const
+{
+  auto it = detector_ids.find(type);
+  return it == detector_ids.end() ? nullptr : defined_detectors[it->second];
 }
 
 // Adds a new particle type to the system, if it doesn't already exist
 void manager::add_particle_type(string type, double rest_mass, int charge)
 {
   // Check if the particle type already exists
-  for (const auto &particle : defined_particles)
+  if (particle_ids.count(type))
   {
-    if (particle.get_type() == type)
-    {
-      cout << "A particle type with the name '" << type << "' already exists. No new particle added." << endl;
-      return; // Exit the function to prevent adding a duplicate particle
-    }
+    cout << "A particle type with the name '" << type << "' already exists. No new particle added." << endl;
+    return; // Exit the function to prevent adding a duplicate particle
   }
 
-  // If the particle type does not exist, create a new particle instance
+  // If the particle type does not exist, create a new particle instance with the next ID
   particle new_particle(type, rest_mass, charge);
+  new_particle.set_id(defined_particles.size());
+  particle_ids.emplace(type, defined_particles.size());
   defined_particles.push_back(new_particle);
+  update_detectors_for_new_particle_type(new_particle);
   cout << "New particle type '" << type << "' added successfully.\n"
        << endl;
 }
 
 // Adds a new detector type to the system, if it doesn't already exist
-void manager::add_detector_type(string type, map<string, double> particle_efficiencies)
+void manager::add_detector_type(string type, map<string, double> particle_efficiencies, const map<string, efficiency_curve> &curves)
 {
   // Check if the detector type already exists
-  for (const auto &detector : defined_detectors)
+  if (detector_ids.count(type))
   {
-    if (detector.get_type() == type)
-    {
-      cout << "A detector type with the name '" << type << "' already exists. No new detector added." << endl;
-      return; // Exit the function to prevent adding a duplicate detector
-    }
+    cout << "A detector type with the name '" << type << "' already exists. No new detector added." << endl;
+    return; // Exit the function to prevent adding a duplicate detector
   }
 
-  // If the detector type does not exist, create a new particle instance
-  detector new_detector(type, particle_efficiencies);
-  defined_detectors.push_back(new_detector);
+  // If the detector type does not exist, create a new detector that refers to the defined particles by ID
+  auto new_detector = make_shared<detector>(type, particle_efficiencies, curves);
+  for (const auto &p : defined_particles)
+  {
+    new_detector->resolve_particle_id(p);
+  }
+  detector_ids.emplace(type, defined_detectors.size());
+  defined_detectors.push_back(move(new_detector));
   cout << "New detector type '" << type << "' added successfully.\n"
        << endl;
 }
 
+// Records a new particle type's ID in every detector, using the efficiency the detector was
+// given for that name if it was defined before the particle type. Definitions are immutable once
+// shared, so each detector is replaced by an updated copy and existing instances keep the old one.
+void manager::update_detectors_for_new_particle_type(const particle &particle)
+{
+  for (auto &definition : defined_detectors)
+  {
+    auto updated = make_shared<detector>(*definition);
+    updated->resolve_particle_id(particle);
+    definition = move(updated);
+  }
+}
+
 // Prints all information about a particle type
-void particle::print_info()
+void particle::print_info() const
 {
   cout << "Particle Type Info:" << endl;
   cout << "Type: " << get_type() << endl;
@@ -134,7 +163,7 @@ void particle::print_info()
 }
 
 // Prints all information about a specific particle instance
-void particle_instance::print_info()
+void particle_instance::print_info() const
 {
   cout << "Particle Instance Info:" << endl;
   cout << "Type: " << get_type() << endl;
@@ -145,34 +174,46 @@ void particle_instance::print_info()
 }
 
 // Prints all information about a detector type
-void detector::print_info()
+void detector::print_info() const
 {
   cout << "Detector Type Info:" << endl;
   cout << "Type: " << get_type() << endl;
+  print_efficiencies();
+}
+
+// Prints a detector type's flat efficiencies and efficiency curves
+void detector::print_efficiencies() const
+{
   cout << "Particle Efficiencies(0-1):\n";
   for (const auto &pair : get_particle_efficiencies())
   {
     cout << pair.first << ": " << pair.second << endl;
   }
+  for (const auto &pair : get_particle_curves())
+  {
+    cout << pair.first << ": curve in " << (pair.second->get_variable() == kinematic_variable::beta ? "beta" : "momentum (MeV/c)") << " through";
+    for (const auto &point : pair.second->get_points())
+    {
+      cout << " (" << point.first << ", " << point.second << ")";
+    }
+    cout << endl;
+  }
 }
 
 // Prints all information about a specific detector instance
-void detector_instance::print_info()
+void detector_instance::print_info() const
 {
   cout << "Detector Instance Info:" << endl;
   cout << "Type: " << get_type() << endl;
   cout << "Status: " << (get_status() ? "On" : "Off") << endl;
   cout << "Tracked Particles: " << get_particles_tracked().size() << endl;
-  cout << "Particle Efficiencies(0-1):\n";
-  for (const auto &pair : get_particle_efficiencies())
-  {
-    cout << pair.first << ": " << pair.second << endl;
-  }
+  get_definition().print_efficiencies();
 }
 
 // Runs a simulation, displaying included detectors and particles,
-// and shows which detectors detected which particles
-void simulation::run_simulation()
+// and shows which detectors detected which particles. Only every
+// print_every-th particle gets a line of output, none if it is 0.
+void simulation::run_simulation(size_t print_every)
 {
   cout << "\033[1mRunning simulation\033[0m\n"
        << "Detectors included:\n";
@@ -184,43 +225,68 @@ void simulation::run_simulation()
        << "Particles included:\n";
   for (size_t i = 0; i < particles.size(); ++i)
   {
-    cout << i + 1 << ". " << particles[i].get_type() << endl;
+    if (print_every != 0 && i % print_every == 0)
+    {
+      cout << i + 1 << ". " << particles[i].get_type() << endl;
+    }
+  }
+  if (print_every != 1)
+  {
+    cout << "(" << particles.size() << " particles in total)" << endl;
   }
   cout << std::endl;
 
-  srand(static_cast<unsigned int>(time(nullptr)));
+  const philox_stream random(seed);
+  for (auto &detector : detectors)
+  {
+    detector.reset_tracking(particles.size());
+  }
 
   // Iterate over each particle in the simulation
+  vector<detector_instance *> detected_by, not_detected_by; // Track which detectors detected the particle
   for (size_t i = 0; i < particles.size(); ++i)
   {
-    vector<detector_instance *> detected_by, not_detected_by; // Track which detectors detected the particle
+    const bool print = print_every != 0 && i % print_every == 0;
+    detected_by.clear();
+    not_detected_by.clear();
 
     // Iterate over each detector
-    for (auto &detector : detectors)
+    for (size_t d = 0; d < detectors.size(); ++d)
     {
-      map<string, double> efficiencies = detector.get_particle_efficiencies();
-      auto it = efficiencies.find(particles[i].get_type());
+      detector_instance &detector = detectors[d];
+      const double efficiency = detector.get_efficiency(particles[i]);
 
       if (detector.get_status() == 0)
       {
-        not_detected_by.push_back(&detector);
+        if (print)
+        {
+          not_detected_by.push_back(&detector);
+        }
       }
-      else if (it != efficiencies.end())
+      else if (efficiency != detector::no_efficiency)
       {
-        double randValue = static_cast<double>(rand()) / RAND_MAX;
-        if (randValue < it->second)
+        // Same stream position as run_headless, so both agree for a given seed
+        double randValue = random.uniform(d * particles.size() + i);
+        if (randValue < efficiency)
         { // Particle is detected
-          detector.track_particle(&particles[i]);
-          detected_by.push_back(&detector);
+          detector.track_particle(i);
+          if (print)
+          {
+            detected_by.push_back(&detector);
+          }
         }
-        else
+        else if (print)
         {
           not_detected_by.push_back(&detector);
         }
       }
     }
 
-    // Output results for each particle
+    // Output results for each sampled particle
+    if (!print)
+    {
+      continue;
+    }
     cout << "Particle " << i + 1 << ": " << particles[i].get_type() << " (" << particles[i].get_velocity() << " m/s  - " << fixed << setprecision(3) << particles[i].get_beta() <<"c)";
     if (!detected_by.empty())
     {
@@ -254,9 +320,607 @@ void simulation::run_simulation()
   cout << endl;
 }
 
+// Checks the points of an efficiency curve and builds its knot and slope tables
+efficiency_curve::efficiency_curve(kinematic_variable variable, const vector<pair<double, double>> &points)
+    : variable(variable), points(points)
+{
+  if (points.empty())
+  {
+    throw invalid_argument("An efficiency curve needs at least one point.");
+  }
+  for (size_t i = 0; i < points.size(); ++i)
+  {
+    if (!(points[i].second >= 0.0 && points[i].second <= 1.0))
+    {
+      throw invalid_argument("Efficiency curve values must be between 0 and 1.");
+    }
+    if (i > 0 && !(points[i].first > points[i - 1].first))
+    {
+      throw invalid_argument("Efficiency curve points must be in strictly increasing order.");
+    }
+  }
+
+  // A single point is a flat curve with no segments
+  knots.reserve(points.size());
+  values.reserve(points.size());
+  slopes.reserve(points.size() - 1);
+  for (size_t i = 0; i < points.size(); ++i)
+  {
+    knots.push_back(points[i].first);
+    values.push_back(points[i].second);
+    if (i > 0)
+    {
+      slopes.push_back((points[i].second - points[i - 1].second) / (points[i].first - points[i - 1].first));
+    }
+  }
+}
+
+// Counts how many particles a detector detected
+size_t hit_matrix::count_hits(size_t detector) const
+{
+  size_t hits = 0;
+  const uint64_t *row = get_row(detector);
+  for (size_t word = 0; word < words_per_detector; ++word)
+  {
+    hits += bitset<64>(row[word]).count();
+  }
+  return hits;
+}
+
+// Compiles each detector's efficiency map into a row of integer thresholds. A trial is a hit when
+// the top 53 bits of its random number fall below the threshold, which is exactly philox_stream::uniform < efficiency.
+// Types with an efficiency curve get a slot naming the curve instead, evaluated per particle at run time.
+simulation_engine::simulation_engine(const vector<detector_instance> &detectors, const vector<string> &particle_types, uint64_t seed)
+    : particle_types(particle_types), detection_thresholds(detectors.size() * particle_types.size(), 0),
+      curve_slots(detectors.size() * particle_types.size(), -1), detector_curves(detectors.size()),
+      sensitive(detectors.size() * particle_types.size(), 0), random(seed)
+{
+  const double scale = static_cast<double>(uint64_t(1) << 53);
+  detector_types.reserve(detectors.size());
+  for (size_t d = 0; d < detectors.size(); ++d)
+  {
+    detector_types.push_back(detectors[d].get_type());
+    if (!detectors[d].get_status())
+    {
+      continue;
+    }
+    const map<string, double> &efficiencies = detectors[d].get_particle_efficiencies();
+    const auto &detector_curve_map = detectors[d].get_definition().get_particle_curves();
+    for (size_t t = 0; t < particle_types.size(); ++t)
+    {
+      auto curve = detector_curve_map.find(particle_types[t]);
+      if (curve != detector_curve_map.end())
+      {
+        curve_slots[d * particle_types.size() + t] = static_cast<int32_t>(detector_curves[d].size());
+        detector_curves[d].push_back(static_cast<uint32_t>(curves.size()));
+        curves.push_back(curve->second);
+        sensitive[d * particle_types.size() + t] = 1;
+        continue;
+      }
+      auto it = efficiencies.find(particle_types[t]);
+      if (it != efficiencies.end())
+      {
+        sensitive[d * particle_types.size() + t] = 1;
+        const double efficiency = min(max(it->second, 0.0), 1.0);
+        detection_thresholds[d * particle_types.size() + t] = static_cast<uint64_t>(ceil(efficiency * scale));
+      }
+    }
+  }
+}
+
+// Returns the column of a particle type, throwing if it was not compiled into the engine
+uint32_t simulation_engine::get_particle_type_id(const string &type) const
+{
+  for (size_t t = 0; t < particle_types.size(); ++t)
+  {
+    if (particle_types[t] == type)
+    {
+      return static_cast<uint32_t>(t);
+    }
+  }
+  throw invalid_argument("Particle type '" + type + "' is not known to the simulation engine.");
+}
+
+// Converts particle instances into a column of particle type ids
+vector<uint32_t> simulation_engine::get_particle_type_ids(const vector<particle_instance> &particles) const
+{
+  vector<uint32_t> ids;
+  ids.reserve(particles.size());
+  for (const auto &particle : particles)
+  {
+    ids.push_back(get_particle_type_id(particle.get_type()));
+  }
+  return ids;
+}
+
+// Converts particle instances into the type id and kinematics columns of a run
+particle_columns simulation_engine::get_particle_columns(const vector<particle_instance> &particles) const
+{
+  particle_columns columns;
+  columns.type_ids = get_particle_type_ids(particles);
+  columns.betas.reserve(particles.size());
+  for (const auto &particle : particles)
+  {
+    columns.betas.push_back(particle.get_beta());
+  }
+  if (has_efficiency_curves())
+  {
+    columns.momenta.reserve(particles.size());
+    for (const auto &particle : particles)
+    {
+      columns.momenta.push_back(particle.get_momentum());
+    }
+  }
+  return columns;
+}
+
+// Draws the trials of every detector for the particles in words [first_word, last_word) of the hit rows
+void simulation_engine::run_words(const particle_columns &particles, hit_matrix &hits, size_t first_word, size_t last_word) const
+{
+  const vector<uint32_t> &particle_type_ids = particles.type_ids;
+  const size_t number_of_detectors = detector_types.size();
+  const size_t number_of_types = particle_types.size();
+  const size_t number_of_particles = particle_type_ids.size();
+  for (size_t d = 0; d < number_of_detectors; ++d)
+  {
+    const uint64_t *thresholds = detection_thresholds.data() + d * number_of_types;
+    const int32_t *slots = curve_slots.data() + d * number_of_types;
+    const vector<uint32_t> &curves_used = detector_curves[d];
+    if (curves_used.empty() && all_of(thresholds, thresholds + number_of_types, [](uint64_t threshold)
+                                      { return threshold == 0; }))
+    {
+      continue; // Detector is off or blind to every type
+    }
+
+    uint64_t *row = hits.get_row(d);
+    uint64_t index = d * number_of_particles + first_word * 64;
+    array<uint32_t, 4> block = random.generate(index >> 1);
+    for (size_t word_index = first_word; word_index < last_word; ++word_index)
+    {
+      const size_t first = word_index * 64;
+      const size_t last = min(first + 64, number_of_particles);
+
+      uint64_t word = 0;
+      for (size_t p = first; p < last; ++p, ++index)
+      {
+        // Each Philox block holds the draws of two neighbouring trials
+        if ((index & 1) == 0)
+        {
+          block = random.generate(index >> 1);
+        }
+        const uint64_t draw = philox_stream::half(block, index & 1) >> 11;
+        const uint32_t type = particle_type_ids[p];
+        bool hit;
+        if (slots[type] < 0)
+        {
+          hit = draw < thresholds[type];
+        }
+        else
+        {
+          // Compared as doubles, which is exact since draw * 2^-53 is the stream's uniform value
+          const efficiency_curve &curve = *curves[curves_used[slots[type]]];
+          hit = draw * 0x1.0p-53 < curve.evaluate(curve.get_variable() == kinematic_variable::beta ? particles.betas[p] : particles.momenta[p]);
+        }
+        word |= uint64_t(hit) << (p - first);
+      }
+      row[word_index] = word;
+    }
+  }
+}
+
+// Draws every particle-detector trial and returns the hits. Trial (particle, detector) always uses
+// stream position detector * particles + particle, so results depend only on the seed. Each thread
+// owns whole 64-particle words, so no two threads write to the same word.
+hit_matrix simulation_engine::run(const particle_columns &particles, unsigned number_of_threads) const
+{
+  for (uint32_t id : particles.type_ids)
+  {
+    if (id >= particle_types.size())
+    {
+      throw invalid_argument("Particle type id out of range.");
+    }
+  }
+  if (has_efficiency_curves() && (particles.betas.size() != particles.type_ids.size() || particles.momenta.size() != particles.type_ids.size()))
+  {
+    throw invalid_argument("Efficiency curves need the beta and momentum of every particle.");
+  }
+
+  hit_matrix hits(detector_types.size(), particles.type_ids.size());
+  const size_t number_of_words = hits.get_words_per_detector();
+  const size_t number_of_partitions = min<size_t>(max(number_of_threads, 1u), max<size_t>(number_of_words, 1));
+  if (number_of_partitions == 1)
+  {
+    run_words(particles, hits, 0, number_of_words);
+    return hits;
+  }
+
+  vector<thread> workers;
+  workers.reserve(number_of_partitions);
+  for (size_t partition = 0; partition < number_of_partitions; ++partition)
+  {
+    const size_t first_word = number_of_words * partition / number_of_partitions;
+    const size_t last_word = number_of_words * (partition + 1) / number_of_partitions;
+    workers.emplace_back([&, first_word, last_word]()
+                         { run_words(particles, hits, first_word, last_word); });
+  }
+  for (auto &worker : workers)
+  {
+    worker.join();
+  }
+  return hits;
+}
+
+// Paramaterised constructor, with empty tables for an engine's detectors and types
+simulation_statistics::simulation_statistics(const simulation_engine &engine)
+    : detector_types(engine.get_detector_types()), particle_types(engine.get_particle_types()),
+      particles_per_type(particle_types.size(), 0), trials(detector_types.size() * particle_types.size(), 0),
+      detections(detector_types.size() * particle_types.size(), 0), joint_detectors(min(detector_types.size(), max_joint_detectors)),
+      joint_detections(particle_types.size() << joint_detectors, 0) {}
+
+// Adds the hits of a run with the same engine. Works through 64 particles at a time, with each
+// detector's word of hits loaded once.
+void simulation_statistics::add_run(const simulation_engine &engine, const particle_columns &particles, const hit_matrix &hits)
+{
+  const size_t number_of_detectors = detector_types.size();
+  const size_t number_of_types = particle_types.size();
+  if (engine.get_number_of_detectors() != number_of_detectors || engine.get_particle_types().size() != number_of_types ||
+      hits.get_number_of_detectors() != number_of_detectors || hits.get_number_of_particles() != particles.type_ids.size())
+  {
+    throw invalid_argument("Statistics, engine, particles and hits do not match.");
+  }
+
+  vector<uint64_t> type_counts(number_of_types, 0);
+  vector<uint64_t> words(number_of_detectors);
+  const size_t number_of_particles = particles.type_ids.size();
+  for (size_t word_index = 0; word_index < hits.get_words_per_detector(); ++word_index)
+  {
+    for (size_t d = 0; d < number_of_detectors; ++d)
+    {
+      words[d] = hits.get_row(d)[word_index];
+    }
+    const size_t first = word_index * 64;
+    const size_t last = min(first + 64, number_of_particles);
+    for (size_t p = first; p < last; ++p)
+    {
+      const uint32_t type = particles.type_ids[p];
+      const unsigned bit = static_cast<unsigned>(p - first);
+      uint32_t mask = 0;
+      for (size_t d = 0; d < number_of_detectors; ++d)
+      {
+        const uint64_t hit = (words[d] >> bit) & 1;
+        detections[d * number_of_types + type] += hit;
+        if (d < joint_detectors)
+        {
+          mask |= static_cast<uint32_t>(hit) << d;
+        }
+      }
+      ++joint_detections[(size_t(type) << joint_detectors) | mask];
+      ++type_counts[type];
+    }
+  }
+
+  for (size_t t = 0; t < number_of_types; ++t)
+  {
+    particles_per_type[t] += type_counts[t];
+    for (size_t d = 0; d < number_of_detectors; ++d)
+    {
+      if (engine.is_sensitive(d, t))
+      {
+        trials[d * number_of_types + t] += type_counts[t];
+      }
+    }
+  }
+}
+
+// Returns the measured efficiency of a detector for a type, 0 if it had no trials
+double simulation_statistics::get_efficiency(size_t detector, size_t type) const
+{
+  const uint64_t n = get_trials(detector, type);
+  return n == 0 ? 0 : static_cast<double>(get_detections(detector, type)) / n;
+}
+
+// Returns the Wilson score interval on the efficiency, the whole range [0, 1] if it had no trials
+pair<double, double> simulation_statistics::get_wilson_interval(size_t detector, size_t type, double z) const
+{
+  const double n = static_cast<double>(get_trials(detector, type));
+  if (n == 0)
+  {
+    return {0.0, 1.0};
+  }
+  const double p = get_detections(detector, type) / n;
+  const double z2 = z * z;
+  const double denominator = 1 + z2 / n;
+  const double centre = (p + z2 / (2 * n)) / denominator;
+  const double half_width = z / denominator * sqrt(p * (1 - p) / n + z2 / (4 * n * n));
+  return {max(0.0, centre - half_width), min(1.0, centre + half_width)};
+}
+
+// Prints the efficiency table and the non-empty joint-detection bins
+void simulation_statistics::print() const
+{
+  const ios::fmtflags flags = cout.flags();
+  const streamsize precision = cout.precision();
+  cout << "\033[1mSimulation statistics\033[0m\n";
+  for (size_t t = 0; t < particle_types.size(); ++t)
+  {
+    cout << particle_types[t] << ": " << particles_per_type[t] << " particles\n";
+    for (size_t d = 0; d < detector_types.size(); ++d)
+    {
+      if (get_trials(d, t) == 0)
+      {
+        continue;
+      }
+      const auto interval = get_wilson_interval(d, t);
+      cout << "  Detector " << d + 1 << ". " << detector_types[d] << " - detected " << get_detections(d, t) << "/" << get_trials(d, t)
+           << ", efficiency " << fixed << setprecision(4) << get_efficiency(d, t)
+           << " (95% CI " << interval.first << " - " << interval.second << ")\n";
+    }
+    for (uint32_t mask = 0; mask < (uint32_t(1) << joint_detectors); ++mask)
+    {
+      const uint64_t count = get_joint_detections(t, mask);
+      if (count == 0)
+      {
+        continue;
+      }
+      cout << "  " << (mask == 0 ? "Not detected" : "Detected by exactly ");
+      for (size_t d = 0; d < joint_detectors; ++d)
+      {
+        if (mask >> d & 1)
+        {
+          cout << d + 1 << ". " << detector_types[d] << ((mask >> (d + 1)) != 0 ? ", " : "");
+        }
+      }
+      cout << ": " << count << "\n";
+    }
+  }
+  if (joint_detectors < detector_types.size())
+  {
+    cout << "Joint detections cover the first " << joint_detectors << " detectors only.\n";
+  }
+  cout << endl;
+  cout.flags(flags);
+  cout.precision(precision);
+}
+
+// Paramaterised constructor
+layered_simulation::layered_simulation(vector<double> radii) : radii(move(radii))
+{
+  for (double radius : this->radii)
+  {
+    if (!(radius >= 0))
+    {
+      throw invalid_argument("Detector radii must be non-negative.");
+    }
+  }
+}
+
+// Queues a layer's next hit. Flight times never decrease along speed_order, so the hits that reach
+// the layer at one time are contiguous there, and are read as a run and sorted by particle.
+void layered_simulation::queue_next_hit(uint32_t detector)
+{
+  vector<uint32_t> &tied = tied_hits[detector];
+  size_t &cursor = cursors[detector];
+  if (tied.empty())
+  {
+    while (cursor < speed_order.size() && !hits.is_hit(detector, speed_order[cursor]))
+    {
+      ++cursor;
+    }
+    if (cursor == speed_order.size())
+    {
+      return;
+    }
+    const double time = radii[detector] * inverse_speeds[speed_order[cursor]];
+    for (; cursor < speed_order.size() && radii[detector] * inverse_speeds[speed_order[cursor]] == time; ++cursor)
+    {
+      if (hits.is_hit(detector, speed_order[cursor]))
+      {
+        tied.push_back(speed_order[cursor]);
+      }
+    }
+    sort(tied.begin(), tied.end(), greater<uint32_t>());
+  }
+  const uint32_t particle = tied.back();
+  tied.pop_back();
+  queue.push(hit_event{radii[detector] * inverse_speeds[particle], detector, particle});
+}
+
+// Draws the detections with the engine and orders the moving particles by speed
+void layered_simulation::start(const simulation_engine &engine, const particle_columns &particles, unsigned number_of_threads, size_t batch_size)
+{
+  if (radii.size() != engine.get_number_of_detectors())
+  {
+    throw invalid_argument("A layered simulation needs one radius per detector.");
+  }
+  if (particles.betas.size() != particles.type_ids.size())
+  {
+    throw invalid_argument("A layered simulation needs the beta of every particle.");
+  }
+
+  hits = engine.run(particles, number_of_threads);
+  const size_t number_of_particles = particles.type_ids.size();
+  inverse_speeds.resize(number_of_particles);
+  speed_order.clear();
+  speed_order.reserve(number_of_particles);
+  const size_t batch = max<size_t>(batch_size, 1);
+  for (size_t first = 0; first < number_of_particles; first += batch)
+  {
+    const size_t last = min(first + batch, number_of_particles);
+    for (size_t p = first; p < last; ++p)
+    {
+      inverse_speeds[p] = 1.0 / (particles.betas[p] * speed_of_light);
+    }
+    for (size_t p = first; p < last; ++p)
+    {
+      // A particle at rest never reaches a layer
+      if (!isinf(inverse_speeds[p]))
+      {
+        speed_order.push_back(static_cast<uint32_t>(p));
+      }
+    }
+  }
+
+  // Every layer's flight times are a fixed multiple of the inverse speed, so this one ordering is
+  // the time order of every layer. Rounding or a zero radius can still give distinct speeds the
+  // same flight time, and queue_next_hit() puts those back in particle order.
+  sort(speed_order.begin(), speed_order.end(), [this](uint32_t a, uint32_t b)
+       { return inverse_speeds[a] < inverse_speeds[b]; });
+
+  queue = priority_queue<hit_event, vector<hit_event>, greater<hit_event>>();
+  cursors.assign(radii.size(), 0);
+  tied_hits.assign(radii.size(), {});
+  for (size_t d = 0; d < radii.size(); ++d)
+  {
+    queue_next_hit(static_cast<uint32_t>(d));
+  }
+}
+
+// Moves every hit up to and including a time into the output in time order
+size_t layered_simulation::step(double until_time, vector<hit_event> &output)
+{
+  size_t released = 0;
+  while (!queue.empty() && queue.top().time <= until_time)
+  {
+    const hit_event event = queue.top();
+    queue.pop();
+    output.push_back(event);
+    ++released;
+    queue_next_hit(event.detector);
+  }
+  return released;
+}
+
+// Time of the next hit, infinite once finished
+double layered_simulation::get_next_time() const
+{
+  return queue.empty() ? numeric_limits<double>::infinity() : queue.top().time;
+}
+
+// Returns the particle types in the simulation, in order of first appearance
+vector<string> simulation::get_particle_types() const
+{
+  vector<string> particle_types;
+  for (const auto &particle : particles)
+  {
+    if (find(particle_types.begin(), particle_types.end(), particle.get_type()) == particle_types.end())
+    {
+      particle_types.push_back(particle.get_type());
+    }
+  }
+  return particle_types;
+}
+
+// Runs the simulation with the detectors as barrel layers at their radii, returning every hit in time order
+vector<hit_event> simulation::run_layered(unsigned number_of_threads) const
+{
+  vector<double> radii;
+  radii.reserve(detectors.size());
+  for (const auto &detector : detectors)
+  {
+    radii.push_back(detector.get_radius());
+  }
+
+  simulation_engine engine(detectors, get_particle_types(), seed);
+  layered_simulation layers(move(radii));
+  layers.start(engine, engine.get_particle_columns(particles), number_of_threads);
+  vector<hit_event> events;
+  layers.step(numeric_limits<double>::infinity(), events);
+  return events;
+}
+
+// Runs the simulation in statistics mode, accumulating counters instead of printing a line per particle
+simulation_statistics simulation::run_statistics(unsigned number_of_threads) const
+{
+  simulation_engine engine(detectors, get_particle_types(), seed);
+  const particle_columns columns = engine.get_particle_columns(particles);
+  simulation_statistics statistics(engine);
+  statistics.add_run(engine, columns, engine.run(columns, number_of_threads));
+  return statistics;
+}
+
+// Runs the simulation without any console output, returning which detectors detected which particles
+hit_matrix simulation::run_headless(unsigned number_of_threads) const
+{
+  simulation_engine engine(detectors, get_particle_types(), seed);
+  return engine.run(engine.get_particle_columns(particles), number_of_threads);
+}
+
+// Returns test particles cycling through the defined types, with velocities drawn from a seeded stream.
+// Simulations draw their detections from stream 0 of their seed, so the velocities come from stream 1
+// and stay independent of the detections when both use the same seed.
+vector<particle_instance> make_test_particles(const manager &system, size_t count, uint64_t seed)
+{
+  const vector<particle> &types = system.get_defined_particles();
+  const philox_stream random = philox_stream(seed).split(1);
+  vector<particle_instance> particles;
+  particles.reserve(count);
+  for (size_t i = 0; i < count; ++i)
+  {
+    particles.push_back(particle_instance(types[i % types.size()], random.uniform(i) * speed_of_light));
+  }
+  return particles;
+}
+
+// Returns true if the hits of a headless run are exactly the particles tracked by a simulation's last run_simulation
+bool matches_tracked_particles(const simulation &sim, const hit_matrix &hits)
+{
+  const vector<detector_instance> &detectors = sim.get_detectors();
+  for (size_t d = 0; d < detectors.size(); ++d)
+  {
+    const vector<size_t> &tracked = detectors[d].get_particles_tracked();
+    if (hits.count_hits(d) != tracked.size())
+    {
+      return false;
+    }
+    for (size_t particle : tracked)
+    {
+      if (!hits.is_hit(d, particle))
+      {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+// Returns true if two hit matrices hold the same detections
+bool same_hits(const hit_matrix &a, const hit_matrix &b)
+{
+  if (a.get_number_of_detectors() != b.get_number_of_detectors() || a.get_number_of_particles() != b.get_number_of_particles())
+  {
+    return false;
+  }
+  for (size_t d = 0; d < a.get_number_of_detectors(); ++d)
+  {
+    if (!equal(a.get_row(d), a.get_row(d) + a.get_words_per_detector(), b.get_row(d)))
+    {
+      return false;
+    }
+  }
+  return true;
+}
+
+// Returns true if hit events are in (time, detector, particle) order
+bool is_time_ordered(const vector<hit_event> &events)
+{
+  return adjacent_find(events.begin(), events.end(), [](const hit_event &a, const hit_event &b)
+                       { return a > b; }) == events.end();
+}
+
+// Prints how many particles each detector of a headless run detected
+void print_hit_counts(const simulation &sim, const hit_matrix &hits)
+{
+  for (size_t d = 0; d < hits.get_number_of_detectors(); ++d)
+  {
+    cout << "Detector " << d + 1 << ". " << sim.get_detectors()[d].get_type() << " - detected " << hits.count_hits(d)
+         << " of " << hits.get_number_of_particles() << " particles.\n";
+  }
+  cout << endl;
+}
+
 // Tests the implementation by running simulations with predefined
 // particle and detector instances.
-void test_implementation(manager system)
+void test_implementation(const manager &system)
 {
   clear_screen();
   vector<particle_instance> test_particles_instances;
@@ -273,21 +937,72 @@ void test_implementation(manager system)
   test_particles_instances.push_back(particle_instance(get_particle_type_obj("antimuon", system), 1000));
 
   // Create simulation for each type of detector
-  simulation tracker_test_sim = simulation({detector_instance(get_detector_type_obj("tracker", system), 1)}, test_particles_instances);
-  simulation calorimeter_test_sim = simulation({detector_instance(get_detector_type_obj("calorimeter", system), 1)}, test_particles_instances);
-  simulation muon_chamber_test_sim = simulation({detector_instance(get_detector_type_obj("muon chamber", system), 1)}, test_particles_instances);
+  // Each simulation takes its own copy of the test particles, the detector definitions are shared
+  simulation tracker_test_sim = simulation({detector_instance(get_detector_type_obj("tracker", system), 1)}, vector<particle_instance>(test_particles_instances));
+  simulation calorimeter_test_sim = simulation({detector_instance(get_detector_type_obj("calorimeter", system), 1)}, vector<particle_instance>(test_particles_instances));
+  simulation muon_chamber_test_sim = simulation({detector_instance(get_detector_type_obj("muon chamber", system), 1)}, vector<particle_instance>(test_particles_instances));
 
   // Create simulation including all detector types for showcase
   simulation all = simulation({detector_instance(get_detector_type_obj("tracker", system), 1),
                                detector_instance(get_detector_type_obj("tracker", system), 1),
                                detector_instance(get_detector_type_obj("muon chamber", system), 1)},
-                              test_particles_instances);
+                              move(test_particles_instances));
 
   clear_screen();
   tracker_test_sim.run_simulation();
   calorimeter_test_sim.run_simulation();
   muon_chamber_test_sim.run_simulation();
   all.run_simulation();
+
+  // The same particles through a layered barrel, with hits in the order the particles reach the layers
+  simulation layered({detector_instance(get_detector_type_obj("tracker", system), 1, 0.1),
+                      detector_instance(get_detector_type_obj("calorimeter", system), 1, 1.5),
+                      detector_instance(get_detector_type_obj("muon chamber", system), 1, 5.0)},
+                     vector<particle_instance>(all.get_particles()), all.get_seed());
+  cout << "\033[1mLayered run\033[0m\n";
+  const ios::fmtflags flags = cout.flags();
+  cout << scientific;
+  for (const hit_event &event : layered.run_layered())
+  {
+    cout << "t = " << event.time << " s: particle " << event.particle + 1 << ". " << layered.get_particles()[event.particle].get_type()
+         << " reaches detector " << event.detector + 1 << ". " << layered.get_detectors()[event.detector].get_type() << endl;
+  }
+  cout << endl;
+  cout.flags(flags);
+
+  // The headless engine must detect the same particles as run_simulation for the same seed
+  cout << "\033[1mHeadless run\033[0m\n"
+       << "Detections " << (matches_tracked_particles(all, all.run_headless()) ? "match" : "DO NOT match") << " the simulation above.\n"
+       << endl;
+
+  // A large run with no per-particle output, including detectors with fractional and velocity-dependent efficiencies
+  const uint64_t seed = 2024;
+  const detector noisy_tracker("noisy tracker", {{"electron", 0.9}, {"muon", 0.8}, {"antielectron", 0.9}, {"antimuon", 0.8}});
+  simulation large({detector_instance(get_detector_type_obj("tracker", system), 1, 0.1),
+                    detector_instance(get_detector_type_obj("calorimeter", system), 1, 1.5),
+                    detector_instance(get_detector_type_obj("muon chamber", system), 1, 5.0),
+                    detector_instance(noisy_tracker, 1, 0.0),
+                    detector_instance(get_detector_type_obj("time of flight", system), 1, 1.0)},
+                   make_test_particles(system, 1000000, seed), seed);
+  const unsigned number_of_threads = max(thread::hardware_concurrency(), 2u);
+  const hit_matrix hits = large.run_headless(number_of_threads);
+  cout << "\033[1mHeadless run of " << large.get_particles().size() << " particles on " << number_of_threads << " threads\033[0m\n"
+       << "Detections " << (same_hits(hits, large.run_headless(1)) ? "match" : "DO NOT match") << " a single-threaded run with seed " << seed << ".\n";
+  print_hit_counts(large, hits);
+
+  // Every detection of the large run as a time-ordered stream, the noisy tracker at radius 0 giving every hit the same time
+  const vector<hit_event> events = large.run_layered(number_of_threads);
+  size_t total_hits = 0;
+  for (size_t d = 0; d < hits.get_number_of_detectors(); ++d)
+  {
+    total_hits += hits.count_hits(d);
+  }
+  cout << "Layered run released " << events.size() << " of " << total_hits << " hits, "
+       << (is_time_ordered(events) ? "in" : "NOT in") << " (time, detector, particle) order.\n"
+       << endl;
+
+  // The same run in statistics mode, as efficiency tables instead of a line per particle
+  large.run_statistics(number_of_threads).print();
 };
 
 // Prompts the user for a yes/no input and returns true for yes and
@@ -369,7 +1084,7 @@ double get_valid_velocity()
 
 // Allows the user to customize the simulation by selecting detectors
 // and particles to include in the simulation.
-void custom_usage(manager system)
+void custom_usage(const manager &system)
 {
   clear_screen();
   cout << "\n\033[1mChoose Defined Detectors to include in simulation\033[0m\n";
@@ -386,16 +1101,12 @@ void custom_usage(manager system)
     getline(cin, detector_type);
 
     // Attempt to find a detector by type
-    bool found = false;
-    for (const auto &det : system.get_defined_detectors())
+    shared_ptr<const detector> det = system.find_detector_type(detector_type);
+    bool found = det != nullptr;
+    if (found)
     {
-      if (det.get_type() == detector_type)
-      {
-        bool status = get_on_off_input("Enter the status of the detector");
-        selected_detector_instances.push_back(detector_instance(det, status));
-        found = true;
-        break; // Exit loop after finding and adding the detector
-      }
+      bool status = get_on_off_input("Enter the status of the detector");
+      selected_detector_instances.push_back(detector_instance(move(det), status));
     }
 
     if (!found)
@@ -422,16 +1133,12 @@ void custom_usage(manager system)
     getline(cin, particle_type);
 
     // Attempt to find a particle by type
-    bool found = false;
-    for (const auto &p : system.get_defined_particles())
+    const particle *p = system.find_particle_type(particle_type);
+    bool found = p != nullptr;
+    if (found)
     {
-      if (p.get_type() == particle_type)
-      {
-        double velocity = get_valid_velocity();
-        selected_particle_instances.push_back(particle_instance(p, velocity));
-        found = true;
-        break; // Exit loop after finding and adding the particle
-      }
+      double velocity = get_valid_velocity();
+      selected_particle_instances.push_back(particle_instance(*p, velocity));
     }
 
     if (!found)
@@ -446,7 +1153,7 @@ void custom_usage(manager system)
 
   // Proceed with the simulation once detectors and particle selected
   cout << endl;
-  simulation sim(selected_detector_instances, selected_particle_instances);
+  simulation sim(move(selected_detector_instances), move(selected_particle_instances));
   sim.run_simulation();
 }
 
@@ -540,7 +1247,7 @@ void edit_particles(manager &system)
     {
     case 1:
       cout << "\n\033[1mDefined Particle Types:\033[0m\n";
-      for (auto &particle : system.get_defined_particles())
+      for (const auto &particle : system.get_defined_particles())
       {
         particle.print_info();
         cout << "-----------------------\n";
@@ -572,7 +1279,7 @@ void add_detector_type_interface(manager &system)
   char continueInput = 'y';
 
   // Initialize particle efficiencies to 0 for all defined particles
-  auto defined_particles = system.get_defined_particles();
+  const auto &defined_particles = system.get_defined_particles();
   for (const auto &p : defined_particles)
   {
     particle_efficiencies[p.get_type()] = 0.0;
@@ -657,9 +1364,9 @@ void edit_detectors(manager &system)
     {
     case 1:
       cout << "\n\033[1mDefined Detector Types:\033[0m\n";
-      for (auto &detector : system.get_defined_detectors())
+      for (const auto &detector : system.get_defined_detectors())
       {
-        detector.print_info();
+        detector->print_info();
         cout << "-----------------------\n";
       }
       break;
@@ -733,7 +1440,7 @@ void display_help_text()
   cout << "\033[1mHELP SECTION: Program Description\033[0m\n\n"
        << "This simulation program is designed for testing particle detection systems. It includes three components, particles, detectors, and simulations. These work together to demonstrate how different detectors interact with various types of particles. The user can choose which particles and detectors take part in a given simulation.\n\n"
        << "\033[1mTest Implementation:\033[0m\n"
-       << "- The test implementation runs predefined simulations using the set of particles and detectors, indicated in the project assignment,to demonstrate how the system functions. This mode automatically configures the simulation with specific particles and detectors to show how particles are detected or missed based on the detector’s efficiency and type.\n\n"
+       << "- The test implementation runs predefined simulations using the set of particles and detectors, indicated in the project assignment,to demonstrate how the system functions. This mode automatically configures the simulation with specific particles and detectors to show how particles are detected or missed based on the detector’s efficiency and type. It then runs the particles through a layered barrel, and a million seeded particles through the headless engine, the layered barrel and statistics mode, checking that the threaded and single-threaded runs agree.\n\n"
        << "\033[1mCustom Usage:\033[0m\n"
        << "- In the custom usage mode, users have the ability to define their own particles and detectors, including specifying the efficiency of detectors in detecting certain particles. Users can choose from predefined particle types or add new ones, specify their properties (like rest mass and charge), and do the same for detectors. The user can also specify the velocity of individual particles in this mode. This mode works with different simulation setups and shows the full capabilities of the program.\n\n"
        << "The program provides options for adding, editing, and viewing the properties of particles and detectors, allowing users to fully customize their simulation experience.\n\n"
@@ -752,6 +1459,10 @@ int main()
   system.add_detector_type("tracker", {{"electron", 1}, {"muon", 1}, {"antielectron", 1}, {"antimuon", 1}});
   system.add_detector_type("calorimeter", {{"electron", 1}, {"muon", 0}, {"antielectron", 1}, {"antimuon", 0}});
   system.add_detector_type("muon chamber", {{"electron", 0}, {"muon", 1}, {"antielectron", 0}, {"antimuon", 1}});
+  // Time of flight only separates slow particles, so its efficiency drops sharply near the speed of light
+  const efficiency_curve time_of_flight_beta(kinematic_variable::beta, {{0.0, 0.99}, {0.95, 0.99}, {0.96, 0.3}, {1.0, 0.1}});
+  const efficiency_curve time_of_flight_momentum(kinematic_variable::momentum, {{0.0, 0.99}, {300.0, 0.99}, {320.0, 0.3}, {2000.0, 0.1}});
+  system.add_detector_type("time of flight", {}, {{"electron", time_of_flight_beta}, {"antielectron", time_of_flight_beta}, {"muon", time_of_flight_momentum}, {"antimuon", time_of_flight_momentum}});
 
   // Code to choose whether user wants to see test implementation or custom use
   double choice;  // Variable to store initial choice input
@@ -1,4 +1,7 @@
 // Lepton.h - Interface file
+#ifndef LEPTON_H
+#define LEPTON_H
+
 #include <vector>
 #include <iostream>
 #include <string>
@@ -40,3 +43,5 @@ public:
 };
 
 std::ostream& operator<<(std::ostream& os, const Lepton& lepton);
+
+#endif // LEPTON_H
@@ -0,0 +1,189 @@
+// LeptonArray.cpp - Implementation file
+#include "LeptonArray.h"
+#include <algorithm>
+#include <cstdlib>
+#include <limits>
+
+// Returns the index of a type name, storing it the first time it is seen
+std::uint32_t LeptonArray::find_or_add_type(const std::string &particleType)
+{
+  // Only a handful of distinct types are expected, so a linear search beats hashing
+  for (std::uint32_t i = 0; i < types.size(); ++i)
+  {
+    if (types[i] == particleType)
+    {
+      return i;
+    }
+  }
+  types.push_back(particleType);
+  return static_cast<std::uint32_t>(types.size() - 1);
+}
+
+// Element-wise operations need arrays of the same length
+void LeptonArray::check_same_size(const LeptonArray &other) const
+{
+  if (size() != other.size())
+  {
+    std::cerr << "Error: Lepton arrays must be the same size." << std::endl;
+    exit(1);
+  }
+}
+
+void LeptonArray::reserve(size_t number_of_leptons)
+{
+  E.reserve(number_of_leptons);
+  Px.reserve(number_of_leptons);
+  Py.reserve(number_of_leptons);
+  Pz.reserve(number_of_leptons);
+  rest_mass.reserve(number_of_leptons);
+  charge.reserve(number_of_leptons);
+  type_index.reserve(number_of_leptons);
+}
+
+void LeptonArray::emplace_back(double E, double px, double py, double pz, double mass, double q, const std::string &particleType)
+{
+  // Validate the energy component as the Lepton constructor does
+  if (E < 0.0)
+  {
+    std::cerr << "Error: Energy cannot be negative." << std::endl;
+    exit(1);
+  }
+  this->E.push_back(E);
+  Px.push_back(px);
+  Py.push_back(py);
+  Pz.push_back(pz);
+  rest_mass.push_back(mass);
+  charge.push_back(q);
+  type_index.push_back(find_or_add_type(particleType));
+}
+
+void LeptonArray::push_back(const Lepton &lepton)
+{
+  emplace_back(lepton.get_E(), lepton.get_Px(), lepton.get_Py(), lepton.get_Pz(), lepton.get_rest_mass(), lepton.get_charge(), lepton.get_type());
+}
+
+void LeptonArray::clear()
+{
+  E.clear();
+  Px.clear();
+  Py.clear();
+  Pz.clear();
+  rest_mass.clear();
+  charge.clear();
+  type_index.clear();
+  types.clear();
+}
+
+Lepton LeptonArray::get_lepton(size_t i) const
+{
+  return Lepton(E[i], Px[i], Py[i], Pz[i], rest_mass[i], charge[i], get_type(i));
+}
+
+FourVector LeptonArray::sum() const
+{
+  FourVector total = {0, 0, 0, 0};
+  for (size_t i = 0; i < size(); ++i)
+  {
+    total.E += E[i];
+    total.Px += Px[i];
+    total.Py += Py[i];
+    total.Pz += Pz[i];
+  }
+  return total;
+}
+
+LeptonArray LeptonArray::sum(const LeptonArray &other) const
+{
+  check_same_size(other);
+  const size_t n = size();
+  LeptonArray result;
+  result.E.resize(n);
+  result.Px.resize(n);
+  result.Py.resize(n);
+  result.Pz.resize(n);
+  result.rest_mass.resize(n);
+  result.charge.resize(n);
+  result.type_index.resize(n);
+
+  // Four momentum columns, one contiguous pass each
+  for (size_t i = 0; i < n; ++i)
+  {
+    result.E[i] = E[i] + other.E[i];
+    result.Px[i] = Px[i] + other.Px[i];
+    result.Py[i] = Py[i] + other.Py[i];
+    result.Pz[i] = Pz[i] + other.Pz[i];
+  }
+
+  // Combined types depend only on the pair of type indices, so each name is built once
+  std::vector<std::uint32_t> combined_type(types.size() * other.types.size(), std::numeric_limits<std::uint32_t>::max());
+  const double not_a_number = std::numeric_limits<double>::quiet_NaN(); // Placeholder, as in Lepton::operator+
+  for (size_t i = 0; i < n; ++i)
+  {
+    const std::string &type = types[type_index[i]];
+    const std::string &other_type = other.types[other.type_index[i]];
+    std::uint32_t &combined = combined_type[type_index[i] * other.types.size() + other.type_index[i]];
+    if (combined == std::numeric_limits<std::uint32_t>::max())
+    {
+      combined = result.find_or_add_type("Combined " + type + " and " + other_type);
+    }
+    result.type_index[i] = combined;
+    const bool same_type = type == other_type;
+    result.rest_mass[i] = same_type ? rest_mass[i] : not_a_number;
+    result.charge[i] = same_type ? charge[i] : not_a_number;
+  }
+  return result;
+}
+
+double LeptonArray::dot_product(size_t i, size_t j) const
+{
+  // E1*E2 - (px1*px2 + py1*py2 + pz1*pz2)
+  return E[i] * E[j] - (Px[i] * Px[j] + Py[i] * Py[j] + Pz[i] * Pz[j]);
+}
+
+std::vector<double> LeptonArray::dot_product(const LeptonArray &other) const
+{
+  check_same_size(other);
+  std::vector<double> result(size());
+  for (size_t i = 0; i < size(); ++i)
+  {
+    result[i] = E[i] * other.E[i] - (Px[i] * other.Px[i] + Py[i] * other.Py[i] + Pz[i] * other.Pz[i]);
+  }
+  return result;
+}
+
+std::vector<double> LeptonArray::dot_product_matrix(const LeptonArray &other) const
+{
+  const size_t rows = size();
+  const size_t columns = other.size();
+  std::vector<double> matrix(rows * columns);
+
+  // Columns are processed in tiles small enough to stay in cache while every row passes over them
+  const size_t tile = 1024;
+  for (size_t first = 0; first < columns; first += tile)
+  {
+    const size_t last = std::min(columns, first + tile);
+    for (size_t i = 0; i < rows; ++i)
+    {
+      const double e = E[i], px = Px[i], py = Py[i], pz = Pz[i];
+      double *row = matrix.data() + i * columns;
+      for (size_t j = first; j < last; ++j)
+      {
+        row[j] = e * other.E[j] - (px * other.Px[j] + py * other.Py[j] + pz * other.Pz[j]);
+      }
+    }
+  }
+  return matrix;
+}
+
+std::vector<double> LeptonArray::dot_product_matrix() const
+{
+  return dot_product_matrix(*this);
+}
+
+std::ostream& operator<<(std::ostream& os, const FourVector& four_vector) {
+    os << "E=" << four_vector.E << " MeV\n"
+       << "Px=" << four_vector.Px << " MeV\n"
+       << "Py=" << four_vector.Py << " MeV\n"
+       << "Pz=" << four_vector.Pz << " MeV\n";
+    return os;
+}
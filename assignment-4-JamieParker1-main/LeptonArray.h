@@ -0,0 +1,81 @@
+// LeptonArray.h - Interface file
+#ifndef LEPTON_ARRAY_H
+#define LEPTON_ARRAY_H
+
+#include "Lepton.h"
+
+#include <cstdint>
+#include <iostream>
+#include <string>
+#include <vector>
+
+// Four-momentum (E, Px, Py, Pz) returned by value from LeptonArray operations
+struct FourVector {
+    double E;
+    double Px;
+    double Py;
+    double Pz;
+};
+
+// Collection of leptons stored as one contiguous array per field, so a lepton costs no heap
+// allocation of its own and batched operations stream through each component in order.
+// Type names are stored once each and referenced by index.
+class LeptonArray {
+private:
+    std::vector<double> E, Px, Py, Pz;
+    std::vector<double> rest_mass;
+    std::vector<double> charge;
+    std::vector<std::uint32_t> type_index;
+    std::vector<std::string> types; // Distinct type names
+
+    std::uint32_t find_or_add_type(const std::string &particleType);
+    void check_same_size(const LeptonArray &other) const;
+
+public:
+    LeptonArray() = default;
+
+    // Reserves storage for a number of leptons in every column
+    void reserve(size_t number_of_leptons);
+
+    // Appends a lepton, with the same arguments and energy check as the Lepton constructor
+    void emplace_back(double E, double px, double py, double pz, double mass, double q, const std::string &particleType);
+    void push_back(const Lepton &lepton);
+
+    size_t size() const { return E.size(); }
+    void clear();
+
+    double get_E(size_t i) const { return E[i]; }
+    double get_Px(size_t i) const { return Px[i]; }
+    double get_Py(size_t i) const { return Py[i]; }
+    double get_Pz(size_t i) const { return Pz[i]; }
+    double get_rest_mass(size_t i) const { return rest_mass[i]; }
+    double get_charge(size_t i) const { return charge[i]; }
+    const std::string &get_type(size_t i) const { return types[type_index[i]]; }
+
+    // Direct access to the columns for batched processing
+    const double *get_E_data() const { return E.data(); }
+    const double *get_Px_data() const { return Px.data(); }
+    const double *get_Py_data() const { return Py.data(); }
+    const double *get_Pz_data() const { return Pz.data(); }
+
+    // Copies one entry out as a standalone Lepton
+    Lepton get_lepton(size_t i) const;
+
+    // Total four-momentum of every lepton
+    FourVector sum() const;
+    // Element-wise four-momentum addition, following the same type, mass and charge rules as Lepton::operator+
+    LeptonArray sum(const LeptonArray &other) const;
+
+    // Four-momentum dot product of two entries
+    double dot_product(size_t i, size_t j) const;
+    // Element-wise dot products with another array of the same size
+    std::vector<double> dot_product(const LeptonArray &other) const;
+    // Row-major size() x other.size() matrix of dot products between every pair of entries
+    std::vector<double> dot_product_matrix(const LeptonArray &other) const;
+    // Symmetric size() x size() matrix of dot products within this array
+    std::vector<double> dot_product_matrix() const;
+};
+
+std::ostream& operator<<(std::ostream& os, const FourVector& four_vector);
+
+#endif // LEPTON_ARRAY_H
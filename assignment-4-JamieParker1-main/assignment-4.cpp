@@ -9,6 +9,7 @@
 using namespace std;
 
 #include "Lepton.h"
+#include "LeptonArray.h"
 
 // Clears console screen based on operating system
 void clear_screen()
@@ -81,6 +82,33 @@ int main()
   Lepton another_antimuon = move(test_particles[6]);
   cout << "\033[1mAntimuon Moved by Assignment:\033[0m \n" << another_antimuon << endl;
 
+  // Contiguous storage, one array per field, so millions of leptons need no per-lepton allocation
+  cout << "\033[1mStoring one million leptons in a LeptonArray with one contiguous array per field\033[0m\n";
+  LeptonArray lepton_array;
+  lepton_array.reserve(1000000);
+  for (int i = 0; i < 1000000; ++i)
+  {
+    lepton_array.emplace_back(511, i % 7, i % 11, i % 13, 0.511, -1, "Electron");
+  }
+  cout << "\033[1m-Total four momentum:\033[0m\n" << lepton_array.sum();
+
+  // Pairwise dot products of the first four particles, computed in one batched pass
+  LeptonArray first_particles;
+  for (int i = 0; i < 4; ++i)
+  {
+    first_particles.push_back(test_particles[i]);
+  }
+  vector<double> dot_products = first_particles.dot_product_matrix();
+  cout << "\033[1m-Dot product matrix of the first four particles (MeV)^2:\033[0m\n";
+  for (size_t i = 0; i < first_particles.size(); ++i)
+  {
+    for (size_t j = 0; j < first_particles.size(); ++j)
+    {
+      cout << dot_products[i * first_particles.size() + j] << (j + 1 < first_particles.size() ? " " : "\n");
+    }
+  }
+  cout << endl;
+
   cout << "\033[1mEnding program\n\033[0m";
 
   return 0;
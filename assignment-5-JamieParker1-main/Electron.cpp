@@ -6,7 +6,7 @@
 
  
 // Constructor without label with validity check
-Electron::Electron(std::unique_ptr<FourMomentum> four_momentum, const std::vector<double> &energy_deposited_in_layers, bool is_antiparticle)
+Electron::Electron(std::unique_ptr<FourMomentum> four_momentum, const LayerEnergies &energy_deposited_in_layers, bool is_antiparticle)
     : Lepton("electron", -1, std::move(four_momentum), is_antiparticle), energy_deposited_in_layers(energy_deposited_in_layers)
 {
   if(!is_valid_energy_deposit())
@@ -16,7 +16,7 @@ Electron::Electron(std::unique_ptr<FourMomentum> four_momentum, const std::vecto
 }
 
 // Constructor with label with validity check
-Electron::Electron(const std::string &label, std::unique_ptr<FourMomentum> four_momentum, const std::vector<double> &energy_deposited_in_layers, bool is_antiparticle)
+Electron::Electron(const std::string &label, std::unique_ptr<FourMomentum> four_momentum, const LayerEnergies &energy_deposited_in_layers, bool is_antiparticle)
     : Lepton("electron", label, -1, std::move(four_momentum), is_antiparticle), energy_deposited_in_layers(energy_deposited_in_layers)
 {
   if(!is_valid_energy_deposit())
@@ -31,7 +31,7 @@ Electron::Electron(const Electron &other)
 
 // Move constructor 
 Electron::Electron(Electron &&other) noexcept
-    : Lepton(std::move(other)), energy_deposited_in_layers(std::move(other.energy_deposited_in_layers)) {}
+    : Lepton(std::move(other)), energy_deposited_in_layers(other.energy_deposited_in_layers) {}
 
 // Destructor
 Electron::~Electron() {}
@@ -53,13 +53,13 @@ Electron &Electron::operator=(Electron &&other) noexcept
   if(this != &other)
   {
     Lepton::operator=(std::move(other));
-    energy_deposited_in_layers = std::move(other.energy_deposited_in_layers);
+    energy_deposited_in_layers = other.energy_deposited_in_layers;
   }
   return *this;
 }
 
 // Getter and Setter implementations
-void Electron::set_energy_deposited_in_layers(const std::vector<double> &energies)
+void Electron::set_energy_deposited_in_layers(const LayerEnergies &energies)
 {
   energy_deposited_in_layers = energies;
   if(!is_valid_energy_deposit())
@@ -68,7 +68,7 @@ void Electron::set_energy_deposited_in_layers(const std::vector<double> &energie
   }
 }
 
-const std::vector<double> &Electron::get_energy_deposited_in_layers() const
+const LayerEnergies &Electron::get_energy_deposited_in_layers() const
 {
   return energy_deposited_in_layers;
 }
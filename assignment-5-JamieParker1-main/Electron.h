@@ -3,20 +3,23 @@
 
 #include "Lepton.h"
 #include "FourMomentum.h"
-#include <vector>
+#include <array>
 #include <string>
  
+// Energy deposited in each calorimeter layer, stored inline in the electron
+using LayerEnergies = std::array<double, 4>;
+
 // Electron class
 class Electron : public Lepton
 {
 private:
-  std::vector<double> energy_deposited_in_layers; // Specific to electrons
+  LayerEnergies energy_deposited_in_layers; // Specific to electrons
   bool is_valid_energy_deposit() const;
 
 public:
   // Constructors
-  Electron(std::unique_ptr<FourMomentum> four_momentum, const std::vector<double> &energy_deposited_in_layers, bool is_antiparticle = false);
-  Electron(const std::string &label, std::unique_ptr<FourMomentum> four_momentum, const std::vector<double> &energy_deposited_in_layers, bool is_antiparticle = false);
+  Electron(std::unique_ptr<FourMomentum> four_momentum, const LayerEnergies &energy_deposited_in_layers, bool is_antiparticle = false);
+  Electron(const std::string &label, std::unique_ptr<FourMomentum> four_momentum, const LayerEnergies &energy_deposited_in_layers, bool is_antiparticle = false);
 
   // Special member functions
   Electron(const Electron &other);                // Copy constructor
@@ -26,8 +29,8 @@ public:
   Electron &operator=(Electron &&other) noexcept; // Move assignment operator
 
   // Getters and Setters
-  void set_energy_deposited_in_layers(const std::vector<double> &energies);
-  const std::vector<double> &get_energy_deposited_in_layers() const;
+  void set_energy_deposited_in_layers(const LayerEnergies &energies);
+  const LayerEnergies &get_energy_deposited_in_layers() const;
 
   // Virtual function overrides
   virtual void print() const override;
@@ -122,9 +122,9 @@ void test_implementation()
 
   // Creating an Electrons
   test_particles.push_back(std::make_unique<Electron>(
-      "Electron 1", std::make_unique<FourMomentum>(1, 2, 3, 0.511), std::vector<double>{0.2, 0.3, 0.4, 0.1}));
+      "Electron 1", std::make_unique<FourMomentum>(1, 2, 3, 0.511), LayerEnergies{0.2, 0.3, 0.4, 0.1}));
   test_particles.push_back(std::make_unique<Electron>(
-      "Electron 2", std::make_unique<FourMomentum>(1, 5, 6, 0.511), std::vector<double>{0.6, 0.1, 0.1, 0.2}));
+      "Electron 2", std::make_unique<FourMomentum>(1, 5, 6, 0.511), LayerEnergies{0.6, 0.1, 0.1, 0.2}));
   // Creating muons
   test_particles.push_back(std::make_unique<Muon>(
       "Muon 1", std::make_unique<FourMomentum>(4, 5, 6, 0.511), 1));
@@ -136,7 +136,7 @@ void test_implementation()
       "Muon 4", std::make_unique<FourMomentum>(4, 5, 6, 0.511), 1));
   // Creating anti-electron
   test_particles.push_back(std::make_unique<Electron>(
-      "Anti-electron 1", std::make_unique<FourMomentum>(1, 2, 3, 0.511), std::vector<double>{0.2, 0.3, 0.4, 0.1}, true));
+      "Anti-electron 1", std::make_unique<FourMomentum>(1, 2, 3, 0.511), LayerEnergies{0.2, 0.3, 0.4, 0.1}, true));
   // Creating anti-muon
   test_particles.push_back(std::make_unique<Muon>(
       "Anti-muon 1", std::make_unique<FourMomentum>(1, 2, 3, 0.511), 0, true));
@@ -157,7 +157,7 @@ void test_implementation()
       "Tau 1", std::make_unique<FourMomentum>(5, 5, 5, 5), DecayType::Leptonic, decay_products1));
 
   // Instantiate decay products for antitau
-  auto antielectron = std::make_shared<Electron>("Decay Electron", std::make_unique<FourMomentum>(3, 3, 3, 3), std::vector<double>{1, 1, 0.5, 0.5}, true);
+  auto antielectron = std::make_shared<Electron>("Decay Electron", std::make_unique<FourMomentum>(3, 3, 3, 3), LayerEnergies{1, 1, 0.5, 0.5}, true);
   auto electron_neutrino = std::make_shared<Neutrino>("Decay Neutrino", std::make_unique<FourMomentum>(1, 1, 1, 1), "electron", 1);
   auto antitau_neutrino = std::make_shared<Neutrino>("Decay Neutrino", std::make_unique<FourMomentum>(1, 1, 1, 1), "tau", 1, true);
   // Group the decay products in a vector
@@ -186,7 +186,7 @@ void test_implementation()
 
   print_loading_string("\n\033[4mCreating a new Electron outside the original vector:\033[0m", 4, true);
   auto new_electron = std::make_unique<Electron>(
-      "New Electron", std::make_unique<FourMomentum>(1, 3, 4, 0.511), std::vector<double>{0.3, 0.2, 0.1, 0.4});
+      "New Electron", std::make_unique<FourMomentum>(1, 3, 4, 0.511), LayerEnergies{0.3, 0.2, 0.1, 0.4});
 
   std::cout << "New Electron created: \n\n";
   new_electron->print();
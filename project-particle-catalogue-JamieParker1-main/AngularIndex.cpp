@@ -0,0 +1,183 @@
+#include "AngularIndex.h"
+#include "FastMath.h"
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+namespace
+{
+  constexpr double two_pi = 2 * fast_math::pi;
+
+  // Azimuth difference folded into [0, pi]
+  double get_abs_delta_phi(double phi_a, double phi_b)
+  {
+    const double delta_phi = std::fabs(phi_a - phi_b);
+    return delta_phi > fast_math::pi ? two_pi - delta_phi : delta_phi;
+  }
+
+  bool is_nearer(const AngularNeighbour &a, const AngularNeighbour &b)
+  {
+    return a.delta_r < b.delta_r || (a.delta_r == b.delta_r && a.index < b.index);
+  }
+}
+
+// Constructor
+AngularGrid::AngularGrid(double cell_size) : cell_size(cell_size)
+{
+  if (!(cell_size > 0))
+  {
+    throw std::invalid_argument("Error: Angular grid cell size must be greater than 0.");
+  }
+  phi_cells = std::max<size_t>(1, static_cast<size_t>(two_pi / cell_size));
+  phi_cell_width = two_pi / phi_cells;
+  cell_start.assign(eta_cells * phi_cells + 1, 0);
+}
+
+size_t AngularGrid::get_eta_cell(double eta) const
+{
+  const double position = std::floor((eta - eta_low) / cell_size);
+  return static_cast<size_t>(std::min(std::max(position, 0.0), static_cast<double>(eta_cells - 1)));
+}
+
+size_t AngularGrid::get_phi_cell(double phi) const
+{
+  // phi = pi falls one past the last cell and wraps to the first, as -pi does
+  const double position = std::floor((phi + fast_math::pi) / phi_cell_width);
+  const long long cell = static_cast<long long>(position) % static_cast<long long>(phi_cells);
+  return static_cast<size_t>(cell < 0 ? cell + static_cast<long long>(phi_cells) : cell);
+}
+
+void AngularGrid::build(const double *eta, const double *phi, size_t count)
+{
+  if (count >= no_index)
+  {
+    throw std::length_error("Error: Too many entries for an angular grid.");
+  }
+
+  // Rows span the finite eta range of the entries, capped at eta_limit
+  double low = eta_limit, high = -eta_limit;
+  for (size_t i = 0; i < count; ++i)
+  {
+    low = std::min(low, eta[i]);
+    high = std::max(high, eta[i]);
+  }
+  low = std::max(low, -eta_limit);
+  high = std::min(high, eta_limit);
+  eta_low = count == 0 || low > high ? 0 : low;
+  eta_cells = count == 0 || low > high ? 1 : static_cast<size_t>((high - low) / cell_size) + 1;
+
+  // Counting sort of the entries by cell
+  std::vector<std::uint32_t> cells(count);
+  cell_start.assign(eta_cells * phi_cells + 1, 0);
+  for (size_t i = 0; i < count; ++i)
+  {
+    cells[i] = static_cast<std::uint32_t>(get_eta_cell(eta[i]) * phi_cells + get_phi_cell(phi[i]));
+    ++cell_start[cells[i] + 1];
+  }
+  for (size_t cell = 0; cell + 1 < cell_start.size(); ++cell)
+  {
+    cell_start[cell + 1] += cell_start[cell];
+  }
+  std::vector<std::uint32_t> next(cell_start.begin(), cell_start.end() - 1);
+  cell_eta.resize(count);
+  cell_phi.resize(count);
+  cell_index.resize(count);
+  for (size_t i = 0; i < count; ++i)
+  {
+    const std::uint32_t position = next[cells[i]]++;
+    cell_eta[position] = eta[i];
+    cell_phi[position] = phi[i];
+    cell_index[position] = static_cast<std::uint32_t>(i);
+  }
+}
+
+bool AngularGrid::covers_all_cells(double eta, double radius) const
+{
+  return get_eta_cell(eta - radius) == 0 && get_eta_cell(eta + radius) == eta_cells - 1 && 2 * radius + phi_cell_width >= two_pi;
+}
+
+void AngularGrid::collect_within(double eta, double phi, double radius, std::uint32_t exclude, std::vector<AngularNeighbour> &neighbours) const
+{
+  const size_t first_row = get_eta_cell(eta - radius);
+  const size_t last_row = get_eta_cell(eta + radius);
+  // A window narrower than the circle visits the cells from phi - radius to phi + radius, wrapping
+  size_t first_column = 0, columns = phi_cells;
+  if (2 * radius + phi_cell_width < two_pi)
+  {
+    first_column = get_phi_cell(phi - radius);
+    columns = std::min(phi_cells, (get_phi_cell(phi + radius) + phi_cells - first_column) % phi_cells + 1);
+  }
+
+  const double radius_2 = radius * radius;
+  for (size_t row = first_row; row <= last_row; ++row)
+  {
+    for (size_t step = 0; step < columns; ++step)
+    {
+      const size_t cell = row * phi_cells + (first_column + step) % phi_cells;
+      for (std::uint32_t position = cell_start[cell]; position < cell_start[cell + 1]; ++position)
+      {
+        const double delta_eta = cell_eta[position] - eta;
+        const double delta_phi = get_abs_delta_phi(cell_phi[position], phi);
+        const double delta_r_2 = delta_eta * delta_eta + delta_phi * delta_phi;
+        if (delta_r_2 <= radius_2 && cell_index[position] != exclude)
+        {
+          neighbours.push_back(AngularNeighbour{cell_index[position], std::sqrt(delta_r_2)});
+        }
+      }
+    }
+  }
+}
+
+void AngularGrid::find_within(double eta, double phi, double radius, std::vector<AngularNeighbour> &neighbours, std::uint32_t exclude) const
+{
+  neighbours.clear();
+  if (std::isnan(eta) || std::isnan(phi) || !(radius >= 0))
+  {
+    return;
+  }
+  phi = std::remainder(phi, two_pi);
+  collect_within(eta, phi, radius, exclude, neighbours);
+  std::sort(neighbours.begin(), neighbours.end(), [](const AngularNeighbour &a, const AngularNeighbour &b)
+            { return a.index < b.index; });
+}
+
+void AngularGrid::find_nearest(double eta, double phi, size_t k, std::vector<AngularNeighbour> &neighbours, std::uint32_t exclude) const
+{
+  neighbours.clear();
+  if (k == 0 || std::isnan(eta) || std::isnan(phi))
+  {
+    return;
+  }
+  phi = std::remainder(phi, two_pi);
+
+  for (double radius = cell_size;; radius *= 2)
+  {
+    if (covers_all_cells(eta, radius))
+    {
+      // Entries merged into the edge rows can be further than any radius tried, so measure every entry
+      neighbours.clear();
+      for (size_t position = 0; position < cell_index.size(); ++position)
+      {
+        if (cell_index[position] != exclude)
+        {
+          const double delta_eta = cell_eta[position] - eta;
+          const double delta_phi = get_abs_delta_phi(cell_phi[position], phi);
+          neighbours.push_back(AngularNeighbour{cell_index[position], std::sqrt(delta_eta * delta_eta + delta_phi * delta_phi)});
+        }
+      }
+      break;
+    }
+    neighbours.clear();
+    collect_within(eta, phi, radius, exclude, neighbours);
+    // Everything within radius was found, so the k nearest are exact once there are k of them
+    if (neighbours.size() >= k)
+    {
+      break;
+    }
+  }
+
+  const size_t found = std::min(k, neighbours.size());
+  std::partial_sort(neighbours.begin(), neighbours.begin() + found, neighbours.end(), is_nearer);
+  neighbours.resize(found);
+}
@@ -0,0 +1,167 @@
+#ifndef ANGULAR_INDEX_H
+#define ANGULAR_INDEX_H
+
+#include "Particle.h"
+#include "ParticleCatalogue.h"
+
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+// Entry returned by an angular query
+struct AngularNeighbour
+{
+  std::uint32_t index; // Position in the indexed columns or catalogue
+  double delta_r;      // sqrt(delta_eta^2 + delta_phi^2) from the query point
+};
+
+// Uniform grid over (eta, phi) with square cells, stored as one contiguous run of entries per cell.
+// A radius query only visits the cells overlapping the query window, so for a fixed density it
+// costs O(1) cells instead of a scan of every entry. phi wraps around, and rows beyond |eta| =
+// eta_limit are merged into the edge rows, which queries filter by exact distance like any other.
+class AngularGrid
+{
+private:
+  double cell_size;
+  double eta_low = 0;
+  size_t eta_cells = 1;
+  size_t phi_cells = 1;
+  double phi_cell_width = 0;
+  std::vector<std::uint32_t> cell_start; // Offsets of each cell's run, with one past the end last
+  std::vector<double> cell_eta, cell_phi;
+  std::vector<std::uint32_t> cell_index; // Position of each entry in the built columns
+
+  size_t get_eta_cell(double eta) const;
+  size_t get_phi_cell(double phi) const;
+  // Appends every entry within radius of (eta, phi), with delta_r, skipping exclude
+  void collect_within(double eta, double phi, double radius, std::uint32_t exclude, std::vector<AngularNeighbour> &neighbours) const;
+  // Returns true if a query of this radius visits every cell
+  bool covers_all_cells(double eta, double radius) const;
+
+public:
+  static constexpr double eta_limit = 10;
+  static constexpr std::uint32_t no_index = std::numeric_limits<std::uint32_t>::max();
+
+  // Constructor. Throws unless the cell size is greater than 0. Around the size of the typical query
+  // radius works best.
+  explicit AngularGrid(double cell_size = 0.4);
+
+  // Replaces the contents with count entries, eta and phi (in [-pi, pi]) given as columns
+  void build(const double *eta, const double *phi, size_t count);
+  size_t size() const { return cell_index.size(); }
+  double get_cell_size() const { return cell_size; }
+
+  // Finds every entry within radius of (eta, phi), sorted by index. An entry can be excluded, e.g.
+  // the query particle itself.
+  void find_within(double eta, double phi, double radius, std::vector<AngularNeighbour> &neighbours, std::uint32_t exclude = no_index) const;
+  // Finds the k entries nearest to (eta, phi), sorted by distance then index. The radius searched
+  // doubles from one cell until k entries are inside it, so the result is exact.
+  void find_nearest(double eta, double phi, size_t k, std::vector<AngularNeighbour> &neighbours, std::uint32_t exclude = no_index) const;
+};
+
+// Angular index over the particles of a catalogue. It is built on the first query and rebuilt on a
+// later query only if the catalogue's particles or any particle's four momentum changed since,
+// using ParticleCatalogue::get_revision and Particle::get_kinematics_revision. Indices refer to
+// positions in the catalogue. The catalogue must outlive the index, and queries may rebuild it, so
+// one index must not be queried from several threads at once.
+template <typename T>
+class AngularIndex
+{
+private:
+  const ParticleCatalogue<T> *catalogue;
+  AngularGrid grid;
+  std::vector<double> eta, phi;
+  bool is_built = false;
+  std::uint64_t catalogue_revision = 0;
+  std::uint64_t kinematics_revision = 0;
+
+  void rebuild()
+  {
+    std::vector<double> px, py, pz;
+    px.reserve(catalogue->get_number_of_particles());
+    py.reserve(catalogue->get_number_of_particles());
+    pz.reserve(catalogue->get_number_of_particles());
+    catalogue->get_view().for_each([&px, &py, &pz](const T *particle)
+                                   {
+      const FourMomentum &four_momentum = particle->get_four_momentum();
+      px.push_back(four_momentum.get_Px());
+      py.push_back(four_momentum.get_Py());
+      pz.push_back(four_momentum.get_Pz()); });
+    eta.resize(px.size());
+    phi.resize(px.size());
+    compute_eta(px.data(), py.data(), pz.data(), px.size(), eta.data());
+    compute_phi(px.data(), py.data(), px.size(), phi.data());
+    grid.build(eta.data(), phi.data(), eta.size());
+    catalogue_revision = catalogue->get_revision();
+    kinematics_revision = Particle::get_kinematics_revision();
+    is_built = true;
+  }
+
+public:
+  // Constructor. Nothing is built until the first query.
+  explicit AngularIndex(const ParticleCatalogue<T> &catalogue, double cell_size = 0.4)
+      : catalogue(&catalogue), grid(cell_size) {}
+
+  // Returns true if the index matches the catalogue without a rebuild
+  bool is_current() const
+  {
+    return is_built && catalogue_revision == catalogue->get_revision() && kinematics_revision == Particle::get_kinematics_revision();
+  }
+
+  // Rebuilds the index if it is out of date
+  void update()
+  {
+    if (!is_current())
+    {
+      rebuild();
+    }
+  }
+
+  // Pseudorapidity and azimuth of a particle, as indexed
+  double get_eta(size_t particle)
+  {
+    update();
+    return eta[particle];
+  }
+  double get_phi(size_t particle)
+  {
+    update();
+    return phi[particle];
+  }
+
+  // Finds the other particles within delta_r <= radius of a particle, sorted by index
+  std::vector<AngularNeighbour> find_within(size_t particle, double radius)
+  {
+    update();
+    std::vector<AngularNeighbour> neighbours;
+    grid.find_within(eta[particle], phi[particle], radius, neighbours, static_cast<std::uint32_t>(particle));
+    return neighbours;
+  }
+  // Finds the particles within delta_r <= radius of a point, sorted by index
+  std::vector<AngularNeighbour> find_within(double point_eta, double point_phi, double radius)
+  {
+    update();
+    std::vector<AngularNeighbour> neighbours;
+    grid.find_within(point_eta, point_phi, radius, neighbours);
+    return neighbours;
+  }
+
+  // Finds the k other particles nearest to a particle, sorted by distance
+  std::vector<AngularNeighbour> find_nearest(size_t particle, size_t k)
+  {
+    update();
+    std::vector<AngularNeighbour> neighbours;
+    grid.find_nearest(eta[particle], phi[particle], k, neighbours, static_cast<std::uint32_t>(particle));
+    return neighbours;
+  }
+  // Finds the k particles nearest to a point, sorted by distance
+  std::vector<AngularNeighbour> find_nearest(double point_eta, double point_phi, size_t k)
+  {
+    update();
+    std::vector<AngularNeighbour> neighbours;
+    grid.find_nearest(point_eta, point_phi, k, neighbours);
+    return neighbours;
+  }
+};
+
+#endif // ANGULAR_INDEX_H
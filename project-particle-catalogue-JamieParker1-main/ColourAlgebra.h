@@ -0,0 +1,91 @@
+#ifndef COLOUR_ALGEBRA_H
+#define COLOUR_ALGEBRA_H
+
+#include "Particle.h"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+
+// Net colour charge of a group of particles packed into one integer as three signed 8-bit counts,
+// red in bits 0-7, green in bits 8-15 and blue in bits 16-23. The packing is linear, so combining
+// charges is integer addition and the conjugate is negation, for up to 127 partons of one colour.
+using PackedColour = std::int32_t;
+
+namespace ColourAlgebra
+{
+  constexpr std::size_t number_of_colours = 7; // Number of values of the Colour enum, including None
+
+  constexpr PackedColour red = 1;
+  constexpr PackedColour green = 1 << 8;
+  constexpr PackedColour blue = 1 << 16;
+  constexpr PackedColour white = red + green + blue; // One of each colour, e.g. a baryon
+
+  // Packed value of each Colour, in enum order
+  constexpr std::array<PackedColour, number_of_colours> packed_values = {red, green, blue, -red, -green, -blue, 0};
+  // Anticolour of each Colour, in enum order
+  constexpr std::array<Colour, number_of_colours> anti_colours = {Colour::AntiRed, Colour::AntiGreen, Colour::AntiBlue, Colour::Red, Colour::Green, Colour::Blue, Colour::None};
+
+  // Returns the position of a colour in the tables, throwing for values outside the enum
+  constexpr std::size_t index(Colour colour)
+  {
+    const std::size_t position = static_cast<std::size_t>(colour);
+    if (position >= number_of_colours)
+    {
+      throw std::invalid_argument("Error: Unrecognised Colour");
+    }
+    return position;
+  }
+
+  // Constant-time operations on packed colours
+  constexpr PackedColour pack(Colour colour) { return packed_values[index(colour)]; }
+  constexpr PackedColour combine(PackedColour a, PackedColour b) { return a + b; }
+  constexpr PackedColour conjugate(PackedColour colour) { return -colour; }
+
+  // Signed count of red in a packed colour, used to test the other two against
+  constexpr int red_count(PackedColour colour) { return ((colour & 0xFF) ^ 0x80) - 0x80; }
+
+  // Neutral when the counts of all three colours are equal, e.g. red + antired or red + green + blue
+  constexpr bool is_neutral(PackedColour colour) { return colour == red_count(colour) * white; }
+  // Colourless when every count is zero, as required for a gluon's colour and anticolour
+  constexpr bool is_colourless(PackedColour colour) { return colour == 0; }
+  constexpr bool is_anti(Colour colour) { return index(colour) >= 3 && colour != Colour::None; }
+  constexpr Colour anti(Colour colour) { return anti_colours[index(colour)]; }
+
+  // Lookup tables of colour neutrality for every combination of two and three colours
+  constexpr std::array<std::array<bool, number_of_colours>, number_of_colours> make_two_body_table()
+  {
+    std::array<std::array<bool, number_of_colours>, number_of_colours> table{};
+    for (std::size_t first = 0; first < number_of_colours; ++first)
+    {
+      for (std::size_t second = 0; second < number_of_colours; ++second)
+      {
+        table[first][second] = is_neutral(packed_values[first] + packed_values[second]);
+      }
+    }
+    return table;
+  }
+  constexpr std::array<std::array<std::array<bool, number_of_colours>, number_of_colours>, number_of_colours> make_three_body_table()
+  {
+    std::array<std::array<std::array<bool, number_of_colours>, number_of_colours>, number_of_colours> table{};
+    for (std::size_t first = 0; first < number_of_colours; ++first)
+    {
+      for (std::size_t second = 0; second < number_of_colours; ++second)
+      {
+        for (std::size_t third = 0; third < number_of_colours; ++third)
+        {
+          table[first][second][third] = is_neutral(packed_values[first] + packed_values[second] + packed_values[third]);
+        }
+      }
+    }
+    return table;
+  }
+  constexpr auto two_body_neutral = make_two_body_table();
+  constexpr auto three_body_neutral = make_three_body_table();
+
+  static_assert(two_body_neutral[0][3] && !two_body_neutral[0][1], "Red + AntiRed is neutral, Red + Green is not");
+  static_assert(three_body_neutral[0][1][2] && three_body_neutral[3][4][5], "Red + Green + Blue and its conjugate are neutral");
+}
+
+#endif // COLOUR_ALGEBRA_H
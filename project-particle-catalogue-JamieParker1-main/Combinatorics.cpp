@@ -0,0 +1,272 @@
+#include "Combinatorics.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <stdexcept>
+#include <tuple>
+
+namespace
+{
+  constexpr size_t tile_size = 256; // Columns per tile, small enough for the tile and its m^2 buffer to stay in L1
+
+  // Particles of one flavour and charge group gathered into contiguous columns
+  struct Group
+  {
+    std::vector<double> energy, px, py, pz;
+    std::vector<std::int32_t> charge_thirds;
+    std::vector<std::uint32_t> indices; // Position of each particle in the event
+
+    size_t size() const { return indices.size(); }
+
+    void add(const EventColumns &event, size_t particle)
+    {
+      energy.push_back(event.get_energy()[particle]);
+      px.push_back(event.get_px()[particle]);
+      py.push_back(event.get_py()[particle]);
+      pz.push_back(event.get_pz()[particle]);
+      charge_thirds.push_back(event.get_charge_thirds()[particle]);
+      indices.push_back(static_cast<std::uint32_t>(particle));
+    }
+  };
+
+  // Mass window on m^2. A window starting at 0 also accepts m^2 slightly below 0 from rounding.
+  void get_mass_squared_window(const CombinationCuts &cuts, double &min_squared, double &max_squared)
+  {
+    if (cuts.min_mass > cuts.max_mass)
+    {
+      throw std::invalid_argument("Error: Minimum mass cut is above the maximum mass cut.");
+    }
+    min_squared = cuts.min_mass > 0 ? cuts.min_mass * cuts.min_mass : -std::numeric_limits<double>::infinity();
+    max_squared = cuts.max_mass * cuts.max_mass;
+  }
+
+  // Number of flavour keys the particles are grouped by
+  size_t count_flavour_keys(const EventColumns &event, const CombinationCuts &cuts)
+  {
+    if (!cuts.same_flavour || event.get_number_of_particles() == 0)
+    {
+      return 1;
+    }
+    const auto &ids = event.get_flavour_ids();
+    return *std::max_element(ids.begin(), ids.end()) + 1;
+  }
+
+  // Appends every pair (a[i], b[j]) inside the mass window. With triangle set, a and b are the same
+  // group and only j > i is visited. Each tile of b is first filled with m^2 by a loop with no
+  // branches, which the compiler vectorises, then scanned for the pairs inside the window.
+  void find_pairs_in_groups(const Group &a, const Group &b, bool triangle, double min_squared, double max_squared, std::vector<PairCandidate> &candidates)
+  {
+    double mass_squared[tile_size];
+    for (size_t tile_start = 0; tile_start < b.size(); tile_start += tile_size)
+    {
+      const size_t tile_end = std::min(b.size(), tile_start + tile_size);
+      const size_t rows = triangle ? std::min(a.size(), tile_end) : a.size();
+      for (size_t i = 0; i < rows; ++i)
+      {
+        const size_t first = triangle ? std::max(tile_start, i + 1) : tile_start;
+        const double energy = a.energy[i], px = a.px[i], py = a.py[i], pz = a.pz[i];
+        for (size_t j = first; j < tile_end; ++j)
+        {
+          const double sum_energy = energy + b.energy[j];
+          const double sum_px = px + b.px[j];
+          const double sum_py = py + b.py[j];
+          const double sum_pz = pz + b.pz[j];
+          mass_squared[j - tile_start] = sum_energy * sum_energy - (sum_px * sum_px + sum_py * sum_py + sum_pz * sum_pz);
+        }
+        for (size_t j = first; j < tile_end; ++j)
+        {
+          const double value = mass_squared[j - tile_start];
+          if (value >= min_squared && value <= max_squared)
+          {
+            const std::uint32_t first_index = std::min(a.indices[i], b.indices[j]);
+            const std::uint32_t second_index = std::max(a.indices[i], b.indices[j]);
+            candidates.push_back(PairCandidate{first_index, second_index, std::sqrt(std::max(0.0, value))});
+          }
+        }
+      }
+    }
+  }
+}
+
+void EventColumns::add_particle(const Particle &particle)
+{
+  const FourMomentum &four_momentum = particle.get_four_momentum();
+  energy.push_back(four_momentum.get_energy());
+  px.push_back(four_momentum.get_Px());
+  py.push_back(four_momentum.get_Py());
+  pz.push_back(four_momentum.get_Pz());
+  charge_thirds.push_back(static_cast<std::int32_t>(std::lround(particle.get_charge() * 3)));
+
+  // Particles and antiparticles share a flavour
+  std::string type = particle.get_type();
+  if (type.compare(0, 4, "anti") == 0)
+  {
+    type = type.substr(4);
+  }
+  const std::string flavour = type + "/" + particle.get_flavour();
+  auto it = std::find(flavours.begin(), flavours.end(), flavour);
+  if (it == flavours.end())
+  {
+    flavours.push_back(flavour);
+    it = flavours.end() - 1;
+  }
+  flavour_ids.push_back(static_cast<std::uint32_t>(it - flavours.begin()));
+}
+
+void EventColumns::append(const EventColumns &other, size_t first, size_t count)
+{
+  energy.insert(energy.end(), other.energy.begin() + first, other.energy.begin() + first + count);
+  px.insert(px.end(), other.px.begin() + first, other.px.begin() + first + count);
+  py.insert(py.end(), other.py.begin() + first, other.py.begin() + first + count);
+  pz.insert(pz.end(), other.pz.begin() + first, other.pz.begin() + first + count);
+  charge_thirds.insert(charge_thirds.end(), other.charge_thirds.begin() + first, other.charge_thirds.begin() + first + count);
+
+  // Flavour ids are local to each set of columns, so map other's ids to ours once per flavour
+  std::vector<std::uint32_t> flavour_map(other.flavours.size(), std::numeric_limits<std::uint32_t>::max());
+  for (size_t particle = first; particle < first + count; ++particle)
+  {
+    std::uint32_t &id = flavour_map[other.flavour_ids[particle]];
+    if (id == std::numeric_limits<std::uint32_t>::max())
+    {
+      const std::string &flavour = other.flavours[other.flavour_ids[particle]];
+      auto it = std::find(flavours.begin(), flavours.end(), flavour);
+      if (it == flavours.end())
+      {
+        flavours.push_back(flavour);
+        it = flavours.end() - 1;
+      }
+      id = static_cast<std::uint32_t>(it - flavours.begin());
+    }
+    flavour_ids.push_back(id);
+  }
+}
+
+void EventColumns::reserve(size_t number_of_particles)
+{
+  energy.reserve(number_of_particles);
+  px.reserve(number_of_particles);
+  py.reserve(number_of_particles);
+  pz.reserve(number_of_particles);
+  charge_thirds.reserve(number_of_particles);
+  flavour_ids.reserve(number_of_particles);
+}
+
+void EventColumns::clear()
+{
+  energy.clear();
+  px.clear();
+  py.clear();
+  pz.clear();
+  charge_thirds.clear();
+  flavour_ids.clear();
+  flavours.clear();
+}
+
+void find_pairs(const EventColumns &event, const CombinationCuts &cuts, std::vector<PairCandidate> &candidates)
+{
+  candidates.clear();
+  double min_squared, max_squared;
+  get_mass_squared_window(cuts, min_squared, max_squared);
+
+  // Group by flavour key and charge sign (0 negative, 1 neutral, 2 positive). Neutral particles
+  // cannot be in an opposite-sign pair, so with that cut they are never enumerated.
+  const size_t flavour_keys = count_flavour_keys(event, cuts);
+  std::vector<Group> groups(flavour_keys * 3);
+  for (size_t particle = 0; particle < event.get_number_of_particles(); ++particle)
+  {
+    const size_t flavour_key = cuts.same_flavour ? event.get_flavour_ids()[particle] : 0;
+    const std::int32_t charge = event.get_charge_thirds()[particle];
+    const size_t sign = cuts.opposite_sign ? (charge > 0) - (charge < 0) + 1 : 0;
+    groups[flavour_key * 3 + sign].add(event, particle);
+  }
+
+  for (size_t flavour_key = 0; flavour_key < flavour_keys; ++flavour_key)
+  {
+    if (cuts.opposite_sign)
+    {
+      find_pairs_in_groups(groups[flavour_key * 3 + 2], groups[flavour_key * 3], false, min_squared, max_squared, candidates);
+    }
+    else
+    {
+      find_pairs_in_groups(groups[flavour_key * 3], groups[flavour_key * 3], true, min_squared, max_squared, candidates);
+    }
+  }
+  std::sort(candidates.begin(), candidates.end(), [](const PairCandidate &a, const PairCandidate &b)
+            { return std::tie(a.first, a.second) < std::tie(b.first, b.second); });
+}
+
+std::vector<PairCandidate> find_pairs(const EventColumns &event, const CombinationCuts &cuts)
+{
+  std::vector<PairCandidate> candidates;
+  find_pairs(event, cuts, candidates);
+  return candidates;
+}
+
+void find_triples(const EventColumns &event, const CombinationCuts &cuts, std::vector<TripleCandidate> &candidates)
+{
+  candidates.clear();
+  double min_squared, max_squared;
+  get_mass_squared_window(cuts, min_squared, max_squared);
+  const bool has_max_mass = std::isfinite(max_squared);
+  const std::int32_t max_net_charge = cuts.opposite_sign ? 3 : std::numeric_limits<std::int32_t>::max();
+
+  const size_t flavour_keys = count_flavour_keys(event, cuts);
+  std::vector<Group> groups(flavour_keys);
+  for (size_t particle = 0; particle < event.get_number_of_particles(); ++particle)
+  {
+    groups[cuts.same_flavour ? event.get_flavour_ids()[particle] : 0].add(event, particle);
+  }
+
+  std::vector<double> mass_squared;
+  std::vector<std::uint8_t> charge_passes;
+  for (const Group &group : groups)
+  {
+    const size_t n = group.size();
+    mass_squared.resize(n);
+    charge_passes.resize(n);
+    for (size_t i = 0; i < n; ++i)
+    {
+      for (size_t j = i + 1; j + 1 < n; ++j)
+      {
+        const double energy = group.energy[i] + group.energy[j];
+        const double px = group.px[i] + group.px[j];
+        const double py = group.py[i] + group.py[j];
+        const double pz = group.pz[i] + group.pz[j];
+        // Adding a physical particle never lowers the invariant mass, so this pair cannot start a triple in the window
+        if (has_max_mass && energy * energy - (px * px + py * py + pz * pz) > max_squared)
+        {
+          continue;
+        }
+        const std::int32_t charge = group.charge_thirds[i] + group.charge_thirds[j];
+        for (size_t k = j + 1; k < n; ++k)
+        {
+          const double sum_energy = energy + group.energy[k];
+          const double sum_px = px + group.px[k];
+          const double sum_py = py + group.py[k];
+          const double sum_pz = pz + group.pz[k];
+          mass_squared[k] = sum_energy * sum_energy - (sum_px * sum_px + sum_py * sum_py + sum_pz * sum_pz);
+          charge_passes[k] = std::abs(charge + group.charge_thirds[k]) <= max_net_charge;
+        }
+        for (size_t k = j + 1; k < n; ++k)
+        {
+          const double value = mass_squared[k];
+          if (charge_passes[k] && value >= min_squared && value <= max_squared)
+          {
+            // Group order follows event order, so the indices are already increasing
+            candidates.push_back(TripleCandidate{group.indices[i], group.indices[j], group.indices[k], std::sqrt(std::max(0.0, value))});
+          }
+        }
+      }
+    }
+  }
+  std::sort(candidates.begin(), candidates.end(), [](const TripleCandidate &a, const TripleCandidate &b)
+            { return std::tie(a.first, a.second, a.third) < std::tie(b.first, b.second, b.third); });
+}
+
+std::vector<TripleCandidate> find_triples(const EventColumns &event, const CombinationCuts &cuts)
+{
+  std::vector<TripleCandidate> candidates;
+  find_triples(event, cuts, candidates);
+  return candidates;
+}
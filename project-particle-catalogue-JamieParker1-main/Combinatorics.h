@@ -0,0 +1,94 @@
+#ifndef COMBINATORICS_H
+#define COMBINATORICS_H
+
+#include "Particle.h"
+#include "ParticleCatalogue.h"
+
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <vector>
+
+// Cuts applied while enumerating combinations
+struct CombinationCuts
+{
+  bool opposite_sign = true; // Pairs need charges of opposite sign, triples a net charge of at most one unit
+  bool same_flavour = false; // Every member has the same flavour, i.e. type without "anti" and the same get_flavour()
+  double min_mass = 0;       // MeV, inclusive
+  double max_mass = std::numeric_limits<double>::infinity(); // MeV, inclusive
+};
+
+// Pair passing the cuts, indices refer to positions in the EventColumns with first < second
+struct PairCandidate
+{
+  std::uint32_t first;
+  std::uint32_t second;
+  double mass; // MeV
+};
+
+// Triple passing the cuts, with first < second < third
+struct TripleCandidate
+{
+  std::uint32_t first;
+  std::uint32_t second;
+  std::uint32_t third;
+  double mass; // MeV
+};
+
+// Kinematics, charge and flavour of the particles of one event as columns, in the order they were added
+class EventColumns
+{
+private:
+  std::vector<double> energy, px, py, pz;
+  std::vector<std::int32_t> charge_thirds; // Charge in units of e/3, so sums are exact
+  std::vector<std::uint32_t> flavour_ids;  // Index into flavours
+  std::vector<std::string> flavours;
+
+public:
+  // Appends a particle
+  void add_particle(const Particle &particle);
+  // Appends count particles of other from position first
+  void append(const EventColumns &other, size_t first, size_t count);
+  void reserve(size_t number_of_particles);
+  void clear();
+
+  // Getters
+  size_t get_number_of_particles() const { return energy.size(); }
+  const std::vector<double> &get_energy() const { return energy; }
+  const std::vector<double> &get_px() const { return px; }
+  const std::vector<double> &get_py() const { return py; }
+  const std::vector<double> &get_pz() const { return pz; }
+  const std::vector<std::int32_t> &get_charge_thirds() const { return charge_thirds; }
+  const std::vector<std::uint32_t> &get_flavour_ids() const { return flavour_ids; }
+  const std::string &get_flavour(size_t particle) const { return flavours[flavour_ids[particle]]; }
+};
+
+// Builds the columns of every particle in a catalogue or view, in its order
+template <typename T>
+EventColumns make_event_columns(const ParticleCatalogueView<T> &view)
+{
+  EventColumns columns;
+  columns.reserve(view.get_number_of_particles());
+  view.for_each([&columns](const T *particle)
+                { columns.add_particle(*particle); });
+  return columns;
+}
+
+template <typename T>
+EventColumns make_event_columns(const ParticleCatalogue<T> &catalogue)
+{
+  return make_event_columns(catalogue.get_view());
+}
+
+// Finds every pair passing the cuts, sorted by (first, second). Particles are grouped by flavour and
+// charge sign first so only compatible groups are paired, and the invariant masses are computed in
+// tiles by a branch-free loop before the mass window is applied on m^2.
+std::vector<PairCandidate> find_pairs(const EventColumns &event, const CombinationCuts &cuts = CombinationCuts());
+void find_pairs(const EventColumns &event, const CombinationCuts &cuts, std::vector<PairCandidate> &candidates);
+
+// Finds every triple passing the cuts, sorted by (first, second, third). A pair already above the
+// maximum mass cannot form a triple inside the window, so its whole inner loop is skipped.
+std::vector<TripleCandidate> find_triples(const EventColumns &event, const CombinationCuts &cuts = CombinationCuts());
+void find_triples(const EventColumns &event, const CombinationCuts &cuts, std::vector<TripleCandidate> &candidates);
+
+#endif // COMBINATORICS_H
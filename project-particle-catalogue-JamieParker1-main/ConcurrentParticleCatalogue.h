@@ -0,0 +1,220 @@
+#ifndef CONCURRENT_PARTICLE_CATALOGUE_H
+#define CONCURRENT_PARTICLE_CATALOGUE_H
+
+#include "Particle.h"
+#include "FourMomentum.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <string>
+#include <thread>
+#include <typeinfo>
+#include <vector>
+
+// Catalogue that several producer threads can fill at once. Each producer appends to its own shard,
+// publish() moves every shard's particles into the main store as one immutable chunk, and readers
+// work on a snapshot of the published chunks without taking any lock. Published particles are
+// owned by their chunk, so they are freed once neither the catalogue nor any snapshot holds it.
+template <typename T>
+class ConcurrentParticleCatalogue
+{
+public:
+  // Immutable view of the published particles at one point in time
+  struct Snapshot
+  {
+    std::vector<std::shared_ptr<const std::vector<T *>>> chunks;
+    size_t number_of_particles = 0;
+
+    // Applies a function to every particle in the snapshot
+    template <typename Function>
+    void for_each(Function function) const
+    {
+      for (const auto &chunk : chunks)
+      {
+        for (const T *particle : *chunk)
+        {
+          function(particle);
+        }
+      }
+    }
+  };
+
+private:
+  // Append buffer for the producer threads mapped onto it
+  struct Shard
+  {
+    std::mutex mutex;
+    std::vector<T *> pending;
+  };
+
+  std::vector<std::unique_ptr<Shard>> shards;
+  std::shared_ptr<const Snapshot> published; // Only accessed through std::atomic_load/atomic_store
+  std::mutex publish_mutex;                  // Serialises publishers, never taken by readers
+  std::set<T *> unique_particles;            // Guarded by publish_mutex
+  std::mutex thread_shards_mutex;
+  std::map<std::thread::id, size_t> thread_shards; // Guarded by thread_shards_mutex
+  std::uint64_t id;                                // Distinguishes catalogues in the thread-local cache
+
+  static std::uint64_t get_next_id()
+  {
+    static std::atomic<std::uint64_t> next_id{1};
+    return next_id++;
+  }
+
+  // Returns the shard of the calling thread. Threads are numbered per catalogue in the order they
+  // first add a particle to it, so up to shards.size() producers never share a shard. Each thread
+  // caches its shard for the last catalogue it added to, so the map is only read when it switches.
+  Shard &get_thread_shard()
+  {
+    thread_local std::uint64_t cached_id = 0;
+    thread_local size_t cached_shard = 0;
+    if (cached_id != id)
+    {
+      std::lock_guard<std::mutex> lock(thread_shards_mutex);
+      const size_t thread_number = thread_shards.emplace(std::this_thread::get_id(), thread_shards.size()).first->second;
+      cached_shard = thread_number % shards.size();
+      cached_id = id;
+    }
+    return *shards[cached_shard];
+  }
+
+public:
+  // Constructor, taking the number of shards. Defaults to one per hardware thread.
+  explicit ConcurrentParticleCatalogue(size_t number_of_shards = std::thread::hardware_concurrency())
+      : published(std::make_shared<const Snapshot>()), id(get_next_id())
+  {
+    shards.reserve(std::max<size_t>(1, number_of_shards));
+    for (size_t i = 0; i < std::max<size_t>(1, number_of_shards); ++i)
+    {
+      shards.push_back(std::make_unique<Shard>());
+    }
+  }
+
+  // The catalogue owns its particles, so it cannot be copied
+  ConcurrentParticleCatalogue(const ConcurrentParticleCatalogue &) = delete;
+  ConcurrentParticleCatalogue &operator=(const ConcurrentParticleCatalogue &) = delete;
+
+  // Destructor. Frees memory for pending particles, each once even if it was added twice. Published
+  // particles are freed with the last snapshot holding them. No producer may still be running.
+  ~ConcurrentParticleCatalogue()
+  {
+    std::set<T *> pending;
+    for (auto &shard : shards)
+    {
+      for (T *particle : shard->pending)
+      {
+        if (unique_particles.find(particle) == unique_particles.end())
+        {
+          pending.insert(particle);
+        }
+      }
+    }
+    for (T *particle : pending)
+    {
+      delete particle;
+    }
+  }
+
+  // Adds a particle to the calling thread's shard. It becomes visible to readers at the next publish().
+  void add_particle(T *particle)
+  {
+    Shard &shard = get_thread_shard();
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    shard.pending.push_back(particle);
+  }
+
+  // Moves every pending particle into the main store as one new chunk and publishes a new snapshot.
+  // Duplicate pointers are skipped with a warning, as in ParticleCatalogue.
+  void publish()
+  {
+    std::lock_guard<std::mutex> publish_lock(publish_mutex);
+    // The chunk owns its particles and frees them when the last snapshot sharing it goes
+    std::shared_ptr<std::vector<T *>> chunk(new std::vector<T *>(), [](std::vector<T *> *particles)
+                                            {
+      for (T *particle : *particles)
+      {
+        delete particle;
+      }
+      delete particles; });
+    for (auto &shard : shards)
+    {
+      std::vector<T *> pending;
+      {
+        std::lock_guard<std::mutex> shard_lock(shard->mutex);
+        pending.swap(shard->pending);
+      }
+      for (T *particle : pending)
+      {
+        if (unique_particles.insert(particle).second)
+        {
+          chunk->push_back(particle);
+        }
+        else
+        {
+          std::cout << "Warning: Attempt to add a duplicate particle pointer.\n";
+        }
+      }
+    }
+    if (chunk->empty())
+    {
+      return;
+    }
+
+    // Chunks already published are shared with the new snapshot, not copied
+    auto snapshot = std::make_shared<Snapshot>(*std::atomic_load(&published));
+    snapshot->number_of_particles += chunk->size();
+    snapshot->chunks.push_back(std::move(chunk));
+    std::atomic_store(&published, std::shared_ptr<const Snapshot>(std::move(snapshot)));
+  }
+
+  // Returns the most recently published snapshot. It stays valid and unchanged while held, even
+  // after the catalogue is destroyed.
+  std::shared_ptr<const Snapshot> get_snapshot() const
+  {
+    return std::atomic_load(&published);
+  }
+
+  // Returns the number of published particles
+  size_t get_number_of_particles() const
+  {
+    return get_snapshot()->number_of_particles;
+  }
+
+  // Returns a map where keys are particle type names and values are the counts of published particles of each type
+  std::map<std::string, int> get_particle_count_by_type() const
+  {
+    std::map<std::string, int> counts;
+    get_snapshot()->for_each([&counts](const T *particle)
+                             {
+      std::string type_name = typeid(*particle).name();
+      size_t pos = type_name.find_first_not_of("0123456789");
+      if (pos != std::string::npos)
+      {
+        type_name = type_name.substr(pos);
+      }
+      counts[type_name]++; });
+    return counts;
+  }
+
+  // Calculates the total four-momentum of all published particles from a single snapshot
+  FourMomentum sum_four_momenta() const
+  {
+    long double energy = 0, px = 0, py = 0, pz = 0;
+    get_snapshot()->for_each([&](const T *particle)
+                             {
+      const FourMomentum &four_momentum = particle->get_four_momentum();
+      energy += four_momentum.get_energy();
+      px += four_momentum.get_Px();
+      py += four_momentum.get_Py();
+      pz += four_momentum.get_Pz(); });
+    return FourMomentum(energy, px, py, pz);
+  }
+};
+
+#endif // CONCURRENT_PARTICLE_CATALOGUE_H
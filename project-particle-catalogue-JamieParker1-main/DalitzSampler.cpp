@@ -0,0 +1,236 @@
+#include "DalitzSampler.h"
+#include "FastMath.h"
+#include "Frame.h"
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+namespace
+{
+  // Decays per random stream in batch sampling
+  constexpr size_t decays_per_chunk = 1024;
+  // Grid points per axis, and relative margin, used to estimate a matrix element's maximum
+  constexpr size_t maximum_grid_points = 200;
+  constexpr double maximum_margin = 1.1;
+
+  // Magnitude of a momentum from its energy and mass, 0 where rounding leaves it below the mass
+  double momentum_from_energy(double energy, double mass)
+  {
+    return std::sqrt(std::max(0.0, energy * energy - mass * mass));
+  }
+}
+
+// Constructor
+DalitzSampler::DalitzSampler(double parent_rest_mass, const std::array<DecaySpecies, 3> &products, MatrixElement matrix_element, double maximum_matrix_element)
+    : parent_rest_mass(parent_rest_mass),
+      product_masses{products[0].rest_mass, products[1].rest_mass, products[2].rest_mass},
+      matrix_element(std::move(matrix_element))
+{
+  const double m1 = product_masses[0], m2 = product_masses[1], m3 = product_masses[2];
+  if (!(parent_rest_mass > m1 + m2 + m3))
+  {
+    throw std::invalid_argument("Error: Rest masses of decay particles exceeds decaying particle's.");
+  }
+  m12_squared_min = (m1 + m2) * (m1 + m2);
+  m12_squared_max = (parent_rest_mass - m3) * (parent_rest_mass - m3);
+  m23_squared_min = (m2 + m3) * (m2 + m3);
+  m23_squared_max = (parent_rest_mass - m1) * (parent_rest_mass - m1);
+
+  if (!this->matrix_element)
+  {
+    return;
+  }
+  if (maximum_matrix_element < 0)
+  {
+    throw std::invalid_argument("Error: Maximum of a matrix element must not be negative.");
+  }
+  this->maximum_matrix_element = maximum_matrix_element > 0 ? maximum_matrix_element : maximum_margin * estimate_maximum_matrix_element();
+  if (!(this->maximum_matrix_element > 0))
+  {
+    throw std::invalid_argument("Error: Matrix element is not positive anywhere on the Dalitz plot.");
+  }
+}
+
+double DalitzSampler::estimate_maximum_matrix_element() const
+{
+  double maximum = 0;
+  for (size_t i = 0; i < maximum_grid_points; ++i)
+  {
+    // Cell centres in m12^2, which stay clear of m12^2 = 0 for two massless products
+    const double m12_squared = m12_squared_min + (m12_squared_max - m12_squared_min) * (i + 0.5) / maximum_grid_points;
+    const std::pair<double, double> m23_squared_range = get_m23_squared_range(m12_squared);
+    // Both ends of the m23^2 range, so maxima on the boundary are found
+    for (size_t j = 0; j <= maximum_grid_points; ++j)
+    {
+      const double m23_squared = m23_squared_range.first + (m23_squared_range.second - m23_squared_range.first) * j / maximum_grid_points;
+      maximum = std::max(maximum, matrix_element(DalitzPoint{m12_squared, m23_squared}));
+    }
+  }
+  return maximum;
+}
+
+std::pair<double, double> DalitzSampler::get_m23_squared_range(double m12_squared) const
+{
+  const double m1 = product_masses[0], m2 = product_masses[1], m3 = product_masses[2];
+  // Energies of products 2 and 3 in the rest frame of products 1 and 2
+  const double m12 = std::sqrt(m12_squared);
+  const double energy2 = (m12_squared - m1 * m1 + m2 * m2) / (2 * m12);
+  const double energy3 = (parent_rest_mass * parent_rest_mass - m12_squared - m3 * m3) / (2 * m12);
+  const double momentum2 = momentum_from_energy(energy2, m2);
+  const double momentum3 = momentum_from_energy(energy3, m3);
+  const double energy_sum_squared = (energy2 + energy3) * (energy2 + energy3);
+  return {energy_sum_squared - (momentum2 + momentum3) * (momentum2 + momentum3),
+          energy_sum_squared - (momentum2 - momentum3) * (momentum2 - momentum3)};
+}
+
+bool DalitzSampler::contains(const DalitzPoint &point) const
+{
+  if (!(point.m12_squared > 0 && point.m12_squared >= m12_squared_min && point.m12_squared <= m12_squared_max))
+  {
+    return false;
+  }
+  const std::pair<double, double> m23_squared_range = get_m23_squared_range(point.m12_squared);
+  return point.m23_squared >= m23_squared_range.first && point.m23_squared <= m23_squared_range.second;
+}
+
+bool DalitzSampler::accept(const DalitzPoint &point, double uniform) const
+{
+  const double value = matrix_element(point);
+  if (value < 0)
+  {
+    throw std::invalid_argument("Error: Matrix element must not be negative.");
+  }
+  if (value > maximum_matrix_element)
+  {
+    throw std::invalid_argument("Error: Matrix element exceeds the maximum given to the Dalitz sampler. Give a sharply peaked matrix element its maximum explicitly.");
+  }
+  return uniform * maximum_matrix_element < value;
+}
+
+void DalitzSampler::get_momenta(const DalitzPoint &point, FourMomentum *momenta) const
+{
+  const double m1 = product_masses[0], m2 = product_masses[1], m3 = product_masses[2];
+  const double mass = parent_rest_mass;
+  // m23^2 = (P - p1)^2 = M^2 - 2 M E1 + m1^2, and likewise for product 3 with m12^2
+  const double energy1 = (mass * mass + m1 * m1 - point.m23_squared) / (2 * mass);
+  const double energy3 = (mass * mass + m3 * m3 - point.m12_squared) / (2 * mass);
+  const double energy2 = mass - energy1 - energy3;
+  const double momentum1 = momentum_from_energy(energy1, m1);
+  const double momentum2 = momentum_from_energy(energy2, m2);
+  const double momentum3 = momentum_from_energy(energy3, m3);
+
+  // p2 = -(p1 + p3) fixes the angle between products 1 and 3
+  double cos_angle = 1;
+  if (momentum1 > 0 && momentum3 > 0)
+  {
+    cos_angle = std::clamp((momentum2 * momentum2 - momentum1 * momentum1 - momentum3 * momentum3) / (2 * momentum1 * momentum3), -1.0, 1.0);
+  }
+  const double sin_angle = std::sqrt(1 - cos_angle * cos_angle);
+  const double p3x = momentum3 * cos_angle;
+  const double p3y = momentum3 * sin_angle;
+  momenta[0] = FourMomentum(energy1, momentum1, 0, 0);
+  momenta[1] = FourMomentum(energy2, -momentum1 - p3x, -p3y, 0);
+  momenta[2] = FourMomentum(energy3, p3x, p3y, 0);
+}
+
+void DalitzSampler::rotate(FourMomentum *momenta, double u1, double u2, double u3)
+{
+  // Euler angles z-y-z with a uniform cosine for the middle angle give a uniform rotation
+  const double psi = 2 * fast_math::pi * u1;
+  const double cos_theta = 2 * u2 - 1;
+  const double sin_theta = std::sqrt(std::max(0.0, 1 - cos_theta * cos_theta));
+  const double phi = 2 * fast_math::pi * u3;
+  const double cos_psi = std::cos(psi), sin_psi = std::sin(psi);
+  const double cos_phi = std::cos(phi), sin_phi = std::sin(phi);
+  for (size_t product = 0; product < 3; ++product)
+  {
+    const double px = momenta[product].get_Px();
+    const double py = momenta[product].get_Py();
+    const double pz = momenta[product].get_Pz();
+    const double x1 = cos_psi * px - sin_psi * py;
+    const double y1 = sin_psi * px + cos_psi * py;
+    const double x2 = cos_theta * x1 + sin_theta * pz;
+    const double z2 = -sin_theta * x1 + cos_theta * pz;
+    momenta[product].set_momentum(cos_phi * x2 - sin_phi * y1, sin_phi * x2 + cos_phi * y1, z2);
+  }
+}
+
+void DalitzSampler::boost_to_parent(const FourMomentum &parent, FourMomentum *momenta)
+{
+  // The lab as seen from the parent's rest frame moves at -p / E
+  const long double energy = parent.get_energy();
+  if (energy <= 0)
+  {
+    throw std::invalid_argument("Error: FourMomentum energy must be greater than 0 to have a rest frame.");
+  }
+  to_frame(momenta, 3, Frame(-parent.get_Px() / energy, -parent.get_Py() / energy, -parent.get_Pz() / energy));
+}
+
+void DalitzSampler::sample_points(size_t count, std::uint64_t seed, DalitzPoint *points, TaskScheduler &scheduler) const
+{
+  scheduler.parallel_for(count, decays_per_chunk, [this, seed, points](size_t first, size_t last)
+                         {
+                           std::mt19937_64 generator(get_stream_seed(seed, first / decays_per_chunk));
+                           for (size_t decay = first; decay < last; ++decay)
+                           {
+                             points[decay] = sample_point(generator);
+                           } });
+}
+
+void DalitzSampler::sample_batch(size_t count, std::uint64_t seed, FourMomentum *momenta, TaskScheduler &scheduler) const
+{
+  scheduler.parallel_for(count, decays_per_chunk, [this, seed, momenta](size_t first, size_t last)
+                         {
+                           std::mt19937_64 generator(get_stream_seed(seed, first / decays_per_chunk));
+                           for (size_t decay = first; decay < last; ++decay)
+                           {
+                             sample(generator, momenta + 3 * decay);
+                           } });
+}
+
+void DalitzSampler::sample_batch(const FourMomentum *parents, size_t count, std::uint64_t seed, FourMomentum *momenta, TaskScheduler &scheduler) const
+{
+  scheduler.parallel_for(count, decays_per_chunk, [this, parents, seed, momenta](size_t first, size_t last)
+                         {
+                           std::mt19937_64 generator(get_stream_seed(seed, first / decays_per_chunk));
+                           for (size_t decay = first; decay < last; ++decay)
+                           {
+                             sample(generator, parents[decay], momenta + 3 * decay);
+                           } });
+}
+
+MatrixElement get_leptonic_decay_matrix_element(double parent_rest_mass, const std::array<DecaySpecies, 3> &products)
+{
+  const double mass_squared = parent_rest_mass * parent_rest_mass;
+  const double m1_squared = products[0].rest_mass * products[0].rest_mass;
+  const double m2_squared = products[1].rest_mass * products[1].rest_mass;
+  const double m3_squared = products[2].rest_mass * products[2].rest_mass;
+  return [=](const DalitzPoint &point)
+  {
+    // m12^2 + m23^2 + m13^2 = M^2 + m1^2 + m2^2 + m3^2
+    const double m13_squared = mass_squared + m1_squared + m2_squared + m3_squared - point.m12_squared - point.m23_squared;
+    const double parent_dot_p2 = (mass_squared + m2_squared - m13_squared) / 2;
+    const double p1_dot_p3 = (m13_squared - m1_squared - m3_squared) / 2;
+    return std::max(0.0, parent_dot_p2 * p1_dot_p3);
+  };
+}
+
+void set_leptonic_decay_products(Particle &parent, std::vector<std::unique_ptr<Particle>> decay_products, DecayType decay_type, std::uint64_t seed)
+{
+  if (decay_products.size() != 3)
+  {
+    throw std::invalid_argument("Error: A leptonic decay needs exactly three products.");
+  }
+  const std::array<DecaySpecies, 3> products = {decay_products[0]->get_decay_species(), decay_products[1]->get_decay_species(), decay_products[2]->get_decay_species()};
+  const DalitzSampler sampler(parent.get_rest_mass(), products, get_leptonic_decay_matrix_element(parent.get_rest_mass(), products));
+  std::mt19937_64 generator(seed);
+  FourMomentum momenta[3];
+  sampler.sample(generator, parent.get_four_momentum(), momenta);
+  // The sampled momenta are on the products' mass shells, so the checks are skipped as for other trusted data
+  for (size_t product = 0; product < 3; ++product)
+  {
+    decay_products[product]->set_trusted_four_momentum(momenta[product]);
+  }
+  parent.set_decay_products(std::move(decay_products), decay_type);
+}
@@ -0,0 +1,133 @@
+#ifndef DALITZ_SAMPLER_H
+#define DALITZ_SAMPLER_H
+
+#include "FourMomentum.h"
+#include "Particle.h"
+#include "TaskScheduler.h"
+
+#include <array>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <random>
+#include <utility>
+#include <vector>
+
+// Point of a three-body decay's Dalitz plot: the invariant masses squared of products 1 and 2, and
+// of products 2 and 3
+struct DalitzPoint
+{
+  double m12_squared;
+  double m23_squared;
+};
+
+// Squared matrix element of a three-body decay at a Dalitz point, up to a constant factor
+using MatrixElement = std::function<double(const DalitzPoint &)>;
+
+// Samples three-body decays of a parent of fixed rest mass. Phase space is flat in (m12^2, m23^2),
+// so points are drawn uniformly over the Dalitz plot and, given a matrix element, kept with
+// probability |M|^2 / max |M|^2. The products' momenta follow from each point in closed form and
+// are given a uniformly random orientation.
+class DalitzSampler
+{
+private:
+  double parent_rest_mass;
+  std::array<double, 3> product_masses;
+  MatrixElement matrix_element;
+  double maximum_matrix_element = 0;
+  double m12_squared_min, m12_squared_max; // Bounding box of the Dalitz plot
+  double m23_squared_min, m23_squared_max;
+
+  // Estimates the maximum of the matrix element over a grid that includes the plot's boundary
+  double estimate_maximum_matrix_element() const;
+  // Keeps a point with probability |M|^2 / max |M|^2 given a uniform number in [0, 1). Throws if
+  // the matrix element exceeds its maximum, since the accepted points would no longer follow it.
+  bool accept(const DalitzPoint &point, double uniform) const;
+  // Rotates the products by a uniformly random rotation built from three uniform numbers
+  static void rotate(FourMomentum *momenta, double u1, double u2, double u3);
+  // Boosts rest-frame products into the lab frame of their parent
+  static void boost_to_parent(const FourMomentum &parent, FourMomentum *momenta);
+
+public:
+  // Constructor. Throws if the products' rest masses do not add up to less than the parent's.
+  // Without a matrix element decays are uniform over the Dalitz plot. A maximum_matrix_element of
+  // 0 is estimated from a grid over the plot with a 10% margin, which suits smooth matrix elements
+  // such as get_leptonic_decay_matrix_element. A sharply peaked one, e.g. a narrow resonance, can
+  // exceed that estimate between grid points and must be given its maximum explicitly, otherwise
+  // sampling throws when a point above the maximum is drawn.
+  DalitzSampler(double parent_rest_mass, const std::array<DecaySpecies, 3> &products, MatrixElement matrix_element = nullptr, double maximum_matrix_element = 0);
+
+  // Getters
+  double get_parent_rest_mass() const { return parent_rest_mass; }
+  const std::array<double, 3> &get_product_masses() const { return product_masses; }
+  double get_maximum_matrix_element() const { return maximum_matrix_element; }
+  std::pair<double, double> get_m12_squared_range() const { return {m12_squared_min, m12_squared_max}; }
+  // Range of m23^2 allowed at a value of m12^2 inside its range
+  std::pair<double, double> get_m23_squared_range(double m12_squared) const;
+  // Whether a point is inside the kinematic boundary of the plot
+  bool contains(const DalitzPoint &point) const;
+
+  // Writes the products' momenta in the parent's rest frame at a Dalitz point: product 1 along
+  // the x axis and all three in the xy plane
+  void get_momenta(const DalitzPoint &point, FourMomentum *momenta) const;
+
+  // Draws a Dalitz point, weighted by the matrix element if there is one
+  template <typename Generator>
+  DalitzPoint sample_point(Generator &generator) const
+  {
+    std::uniform_real_distribution<double> uniform(0.0, 1.0);
+    for (;;)
+    {
+      const DalitzPoint point{m12_squared_min + (m12_squared_max - m12_squared_min) * uniform(generator),
+                              m23_squared_min + (m23_squared_max - m23_squared_min) * uniform(generator)};
+      if (contains(point) && (!matrix_element || accept(point, uniform(generator))))
+      {
+        return point;
+      }
+    }
+  }
+
+  // Writes the momenta of one sampled decay in the parent's rest frame
+  template <typename Generator>
+  void sample(Generator &generator, FourMomentum *momenta) const
+  {
+    get_momenta(sample_point(generator), momenta);
+    std::uniform_real_distribution<double> uniform(0.0, 1.0);
+    const double u1 = uniform(generator);
+    const double u2 = uniform(generator);
+    const double u3 = uniform(generator);
+    rotate(momenta, u1, u2, u3);
+  }
+  // Writes the lab-frame momenta of one sampled decay of a parent, assumed to have the sampler's
+  // rest mass
+  template <typename Generator>
+  void sample(Generator &generator, const FourMomentum &parent, FourMomentum *momenta) const
+  {
+    sample(generator, momenta);
+    boost_to_parent(parent, momenta);
+  }
+
+  // Batch sampling on a task scheduler, writing 3 * count momenta (products of decay i at 3 * i) or
+  // count points. Every chunk of decays has its own random stream from the seed, so results are
+  // the same for any number of threads. An exception from the matrix element stops the batch and
+  // is rethrown.
+  void sample_points(size_t count, std::uint64_t seed, DalitzPoint *points, TaskScheduler &scheduler = TaskScheduler::get_default()) const;
+  // Decays at rest
+  void sample_batch(size_t count, std::uint64_t seed, FourMomentum *momenta, TaskScheduler &scheduler = TaskScheduler::get_default()) const;
+  // Decays of moving parents, one per parent
+  void sample_batch(const FourMomentum *parents, size_t count, std::uint64_t seed, FourMomentum *momenta, TaskScheduler &scheduler = TaskScheduler::get_default()) const;
+};
+
+// V-A matrix element of leptonic decays such as mu- -> e- anti-nu_e nu_mu, (P.p2)(p1.p3), with the
+// products ordered as charged lepton, its antineutrino, then the parent's neutrino (for
+// antiparticle parents, the antineutrino and neutrino swap places)
+MatrixElement get_leptonic_decay_matrix_element(double parent_rest_mass, const std::array<DecaySpecies, 3> &products);
+
+// Gives a particle such as a tau or muon a leptonic three-body decay, with the products' momenta
+// drawn from the V-A matrix element and boosted to the parent's motion, then validated as
+// set_decay_products does. The products are ordered as for get_leptonic_decay_matrix_element. Builds
+// a sampler on every call, so batches of decays should use DalitzSampler::sample_batch. Throws
+// unless there are three products lighter in total than the parent.
+void set_leptonic_decay_products(Particle &parent, std::vector<std::unique_ptr<Particle>> decay_products, DecayType decay_type, std::uint64_t seed);
+
+#endif // DALITZ_SAMPLER_H
@@ -0,0 +1,252 @@
+#include "DecayValidator.h"
+#include "helper_functions.h"
+
+#include <cmath>
+#include <stdexcept>
+
+// Packs a particle's conserved quantities into integer lanes
+QuantumNumbers get_quantum_numbers(const Particle &particle)
+{
+  QuantumNumbers numbers{};
+  const int lepton_number = particle.get_lepton_number();
+  const int baryon_thirds = static_cast<int>(std::lround(particle.get_baryon_number() * 3));
+
+  numbers[QuantumNumber::charge] = static_cast<std::int32_t>(std::lround(particle.get_charge() * 3));
+  numbers[QuantumNumber::lepton_number] = lepton_number;
+  numbers[QuantumNumber::baryon_number] = baryon_thirds;
+
+  // Flavour numbers, from the particle's flavour tag
+  switch (particle.get_flavour_tag())
+  {
+  case FlavourTag::Electron:
+    numbers[QuantumNumber::electron_number] = lepton_number;
+    break;
+  case FlavourTag::Muon:
+    numbers[QuantumNumber::muon_number] = lepton_number;
+    break;
+  case FlavourTag::Tau:
+    numbers[QuantumNumber::tau_number] = lepton_number;
+    break;
+  case FlavourTag::Up:
+    numbers[QuantumNumber::up_number] = baryon_thirds;
+    break;
+  case FlavourTag::Down:
+    numbers[QuantumNumber::down_number] = baryon_thirds;
+    break;
+  case FlavourTag::Charm:
+    numbers[QuantumNumber::charm_number] = baryon_thirds;
+    break;
+  case FlavourTag::Strange:
+    numbers[QuantumNumber::strange_number] = baryon_thirds;
+    break;
+  case FlavourTag::Top:
+    numbers[QuantumNumber::top_number] = baryon_thirds;
+    break;
+  case FlavourTag::Bottom:
+    numbers[QuantumNumber::bottom_number] = baryon_thirds;
+    break;
+  case FlavourTag::None:
+    break;
+  }
+
+  numbers[QuantumNumber::colour] = ColourAlgebra::pack(particle.get_colour_charge());
+  return numbers;
+}
+
+// Converts a failure bitmask into a readable list of violated quantities
+std::string to_string_conservation_failures(std::uint16_t failures)
+{
+  if (failures == ConservationFailure::none)
+  {
+    return "None";
+  }
+  std::string result;
+  auto append = [&result, failures](std::uint16_t flag, const std::string &name)
+  {
+    if (failures & flag)
+    {
+      result += (result.empty() ? "" : ", ") + name;
+    }
+  };
+  append(ConservationFailure::four_momentum, "Four momentum");
+  append(ConservationFailure::charge, "Charge");
+  append(ConservationFailure::lepton_number, "Lepton number");
+  append(ConservationFailure::baryon_number, "Baryon number");
+  append(ConservationFailure::lepton_flavour, "Lepton flavour");
+  append(ConservationFailure::quark_flavour, "Quark flavour");
+  append(ConservationFailure::colour, "Colour");
+  return result;
+}
+
+// Constructor
+DecayBatch::DecayBatch(double momentum_tolerance) : momentum_tolerance(momentum_tolerance) {}
+
+void DecayBatch::reserve(size_t number_of_decays, size_t number_of_products)
+{
+  parent_numbers.reserve(number_of_decays);
+  parent_energy.reserve(number_of_decays);
+  parent_px.reserve(number_of_decays);
+  parent_py.reserve(number_of_decays);
+  parent_pz.reserve(number_of_decays);
+  decay_types.reserve(number_of_decays);
+  product_offsets.reserve(number_of_decays + 1);
+
+  product_numbers.reserve(number_of_products);
+  product_energy.reserve(number_of_products);
+  product_px.reserve(number_of_products);
+  product_py.reserve(number_of_products);
+  product_pz.reserve(number_of_products);
+}
+
+void DecayBatch::add_decay(const Particle &parent, const std::vector<std::unique_ptr<Particle>> &products, DecayType decay_type)
+{
+  const FourMomentum &parent_four_momentum = parent.get_four_momentum();
+  // Colour is checked on the products alone, so the parent's colour lane is left at 0
+  QuantumNumbers numbers = get_quantum_numbers(parent);
+  numbers[QuantumNumber::colour] = 0;
+  parent_numbers.push_back(numbers);
+  parent_energy.push_back(parent_four_momentum.get_energy());
+  parent_px.push_back(parent_four_momentum.get_Px());
+  parent_py.push_back(parent_four_momentum.get_Py());
+  parent_pz.push_back(parent_four_momentum.get_Pz());
+  decay_types.push_back(decay_type);
+
+  for (const auto &product : products)
+  {
+    if (!product)
+    {
+      throw std::invalid_argument("Error: Decay product is null.");
+    }
+    const FourMomentum &product_four_momentum = product->get_four_momentum();
+    product_numbers.push_back(get_quantum_numbers(*product));
+    product_energy.push_back(product_four_momentum.get_energy());
+    product_px.push_back(product_four_momentum.get_Px());
+    product_py.push_back(product_four_momentum.get_Py());
+    product_pz.push_back(product_four_momentum.get_Pz());
+  }
+  product_offsets.push_back(product_numbers.size());
+}
+
+void DecayBatch::add_decay(const Particle &parent, DecayType decay_type)
+{
+  add_decay(parent, parent.get_decay_products(), decay_type);
+}
+
+size_t DecayBatch::get_number_of_decays() const
+{
+  return parent_numbers.size();
+}
+
+std::vector<std::uint16_t> DecayBatch::validate() const
+{
+  std::vector<std::uint16_t> failures(parent_numbers.size(), ConservationFailure::none);
+  validate_range(0, failures.size(), failures.data());
+  return failures;
+}
+
+std::vector<std::uint16_t> DecayBatch::validate(TaskScheduler &scheduler) const
+{
+  std::vector<std::uint16_t> failures(parent_numbers.size(), ConservationFailure::none);
+  scheduler.parallel_for(failures.size(), 0, [this, &failures](size_t first, size_t last)
+                         { validate_range(first, last, failures.data()); });
+  return failures;
+}
+
+void DecayBatch::validate_range(size_t first_decay, size_t last_decay, std::uint16_t *failures) const
+{
+  using namespace QuantumNumber;
+  for (size_t decay = first_decay; decay < last_decay; ++decay)
+  {
+    const size_t first = product_offsets[decay];
+    const size_t last = product_offsets[decay + 1];
+
+    // Difference between the products and the parent, lane by lane. The inner loops run over
+    // fixed-width integer records and contiguous doubles, so the compiler emits SIMD sums.
+    QuantumNumbers difference{};
+    for (size_t product = first; product < last; ++product)
+    {
+      const QuantumNumbers &numbers = product_numbers[product];
+      for (size_t lane = 0; lane < count; ++lane)
+      {
+        difference[lane] += numbers[lane];
+      }
+    }
+    const QuantumNumbers &parent = parent_numbers[decay];
+    for (size_t lane = 0; lane < count; ++lane)
+    {
+      difference[lane] -= parent[lane];
+    }
+
+    double energy = -parent_energy[decay];
+    double px = -parent_px[decay];
+    double py = -parent_py[decay];
+    double pz = -parent_pz[decay];
+    for (size_t product = first; product < last; ++product)
+    {
+      energy += product_energy[product];
+      px += product_px[product];
+      py += product_py[product];
+      pz += product_pz[product];
+    }
+
+    std::uint16_t mask = ConservationFailure::none;
+    if (std::abs(energy) >= momentum_tolerance || std::abs(px) >= momentum_tolerance || std::abs(py) >= momentum_tolerance || std::abs(pz) >= momentum_tolerance)
+    {
+      mask |= ConservationFailure::four_momentum;
+    }
+    if (difference[charge] != 0)
+    {
+      mask |= ConservationFailure::charge;
+    }
+    if (difference[lepton_number] != 0)
+    {
+      mask |= ConservationFailure::lepton_number;
+    }
+    if (difference[baryon_number] != 0)
+    {
+      mask |= ConservationFailure::baryon_number;
+    }
+    // Flavour is only checked in the parent's own lane, the one flavour lane where it is nonzero
+    bool lepton_flavour_changed = false;
+    for (size_t lane = electron_number; lane <= tau_number; ++lane)
+    {
+      lepton_flavour_changed |= (parent[lane] != 0) & (difference[lane] != 0);
+    }
+    if (lepton_flavour_changed)
+    {
+      mask |= ConservationFailure::lepton_flavour;
+    }
+    // Quark flavour can change through the weak interaction
+    bool quark_flavour_changed = false;
+    for (size_t lane = up_number; lane <= bottom_number; ++lane)
+    {
+      quark_flavour_changed |= (parent[lane] != 0) & (difference[lane] != 0);
+    }
+    if (decay_types[decay] != DecayType::Weak && quark_flavour_changed)
+    {
+      mask |= ConservationFailure::quark_flavour;
+    }
+    // Colour is conserved when the products are colour neutral, i.e. equal in all three colours
+    if (!ColourAlgebra::is_neutral(difference[colour]))
+    {
+      mask |= ConservationFailure::colour;
+    }
+    failures[decay] = mask;
+  }
+}
+
+void DecayBatch::clear()
+{
+  parent_numbers.clear();
+  parent_energy.clear();
+  parent_px.clear();
+  parent_py.clear();
+  parent_pz.clear();
+  decay_types.clear();
+  product_numbers.clear();
+  product_energy.clear();
+  product_px.clear();
+  product_py.clear();
+  product_pz.clear();
+  product_offsets.assign(1, 0);
+}
@@ -0,0 +1,101 @@
+#ifndef DECAY_VALIDATOR_H
+#define DECAY_VALIDATOR_H
+
+#include "Particle.h"
+#include "FourMomentum.h"
+#include "ColourAlgebra.h"
+#include "TaskScheduler.h"
+
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+// Namespace of lane indices into a particle's packed quantum numbers. Fractional quantities are
+// stored in thirds so every lane is an exact integer.
+namespace QuantumNumber
+{
+  constexpr size_t charge = 0;        // Charge in units of e/3
+  constexpr size_t lepton_number = 1; // Total lepton number
+  constexpr size_t baryon_number = 2; // Baryon number in units of 1/3
+  constexpr size_t electron_number = 3;
+  constexpr size_t muon_number = 4;
+  constexpr size_t tau_number = 5;
+  constexpr size_t up_number = 6; // Quark flavour numbers, +1 for quarks and -1 for antiquarks
+  constexpr size_t down_number = 7;
+  constexpr size_t charm_number = 8;
+  constexpr size_t strange_number = 9;
+  constexpr size_t top_number = 10;
+  constexpr size_t bottom_number = 11;
+  constexpr size_t colour = 12; // Net colour as a PackedColour, which sums lane-wise like the others
+  constexpr size_t count = 16; // Padded to 16 lanes so summing whole records vectorises
+}
+
+// Namespace of bit flags returned for each decay, one bit per violated conservation law
+namespace ConservationFailure
+{
+  constexpr std::uint16_t none = 0;
+  constexpr std::uint16_t four_momentum = 1 << 0;
+  constexpr std::uint16_t charge = 1 << 1;
+  constexpr std::uint16_t lepton_number = 1 << 2;
+  constexpr std::uint16_t baryon_number = 1 << 3;
+  constexpr std::uint16_t lepton_flavour = 1 << 4;
+  constexpr std::uint16_t quark_flavour = 1 << 5;
+  constexpr std::uint16_t colour = 1 << 6;
+}
+
+using QuantumNumbers = std::array<std::int32_t, QuantumNumber::count>;
+
+// Packs a particle's conserved quantities into integer lanes, reading its flavour from get_flavour_tag
+QuantumNumbers get_quantum_numbers(const Particle &particle);
+// Converts a failure bitmask into a readable list of violated quantities
+std::string to_string_conservation_failures(std::uint16_t failures);
+
+// Collects many (parent, products) decays into packed columns and checks every conservation law
+// for all of them in one pass. A decay passes exactly when Particle::validate_decay_products accepts
+// it: lepton and quark flavour are only checked in the parent's own flavour, quark flavour not for
+// weak decays, and colour requires the products alone to be colour neutral. Charge and baryon
+// number are compared as exact integers in thirds instead of as sums of doubles.
+class DecayBatch
+{
+private:
+  // Parent columns, one entry per decay
+  std::vector<QuantumNumbers> parent_numbers;
+  std::vector<double> parent_energy, parent_px, parent_py, parent_pz;
+  std::vector<DecayType> decay_types;
+
+  // Product columns, the products of decay i occupy [product_offsets[i], product_offsets[i + 1])
+  std::vector<QuantumNumbers> product_numbers;
+  std::vector<double> product_energy, product_px, product_py, product_pz;
+  std::vector<size_t> product_offsets{0};
+
+  double momentum_tolerance;
+
+  // Checks the decays in [first_decay, last_decay), writing their bitmasks to failures
+  void validate_range(size_t first_decay, size_t last_decay, std::uint16_t *failures) const;
+
+public:
+  // Constructor, taking the tolerance allowed on each four-momentum component
+  DecayBatch(double momentum_tolerance = 1e-5);
+
+  // Reserves space for a number of decays and their products
+  void reserve(size_t number_of_decays, size_t number_of_products);
+
+  // Adds a decay to the batch, either from explicit products or from the parent's decay products
+  void add_decay(const Particle &parent, const std::vector<std::unique_ptr<Particle>> &products, DecayType decay_type);
+  void add_decay(const Particle &parent, DecayType decay_type);
+
+  // Returns the number of decays in the batch
+  size_t get_number_of_decays() const;
+
+  // Checks every decay, returning a ConservationFailure bitmask per decay in the order they were added
+  std::vector<std::uint16_t> validate() const;
+  // Same as validate, with chunks of decays checked in parallel on a task scheduler
+  std::vector<std::uint16_t> validate(TaskScheduler &scheduler) const;
+
+  // Removes all decays from the batch, keeping the allocated storage
+  void clear();
+};
+
+#endif // DECAY_VALIDATOR_H
@@ -0,0 +1,39 @@
+#include "EventStore.h"
+
+FourMomentum Event::sum_four_momenta() const
+{
+  double energy = 0, px = 0, py = 0, pz = 0;
+  for (size_t particle = 0; particle < number_of_particles; ++particle)
+  {
+    energy += get_energy()[particle];
+    px += get_px()[particle];
+    py += get_py()[particle];
+    pz += get_pz()[particle];
+  }
+  return FourMomentum(energy, px, py, pz);
+}
+
+EventColumns Event::get_columns() const
+{
+  EventColumns columns;
+  columns.append(*particles, first, number_of_particles);
+  return columns;
+}
+
+void EventStore::add_event(const EventColumns &event)
+{
+  particles.append(event, 0, event.get_number_of_particles());
+  event_offsets.push_back(particles.get_number_of_particles());
+}
+
+void EventStore::reserve(size_t number_of_events, size_t number_of_particles)
+{
+  event_offsets.reserve(number_of_events + 1);
+  particles.reserve(number_of_particles);
+}
+
+void EventStore::clear()
+{
+  particles.clear();
+  event_offsets.assign(1, 0);
+}
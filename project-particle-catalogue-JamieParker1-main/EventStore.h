@@ -0,0 +1,133 @@
+#ifndef EVENT_STORE_H
+#define EVENT_STORE_H
+
+#include "Combinatorics.h"
+#include "FourMomentum.h"
+#include "Particle.h"
+#include "ParticleCatalogue.h"
+#include "TaskScheduler.h"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// One event of an EventStore, a contiguous range of its particle columns. Pointers are valid until
+// events are added to or cleared from the store.
+class Event
+{
+private:
+  const EventColumns *particles;
+  size_t index;
+  size_t first;
+  size_t number_of_particles;
+
+public:
+  // Constructor, used by EventStore
+  Event(const EventColumns &particles, size_t index, size_t first, size_t number_of_particles)
+      : particles(&particles), index(index), first(first), number_of_particles(number_of_particles) {}
+
+  // Getters. Column pointers point at the event's first particle.
+  size_t get_index() const { return index; }
+  size_t get_first_particle() const { return first; } // Position in the store's columns
+  size_t get_number_of_particles() const { return number_of_particles; }
+  const double *get_energy() const { return particles->get_energy().data() + first; }
+  const double *get_px() const { return particles->get_px().data() + first; }
+  const double *get_py() const { return particles->get_py().data() + first; }
+  const double *get_pz() const { return particles->get_pz().data() + first; }
+  const std::int32_t *get_charge_thirds() const { return particles->get_charge_thirds().data() + first; }
+  const std::uint32_t *get_flavour_ids() const { return particles->get_flavour_ids().data() + first; }
+  const std::string &get_flavour(size_t particle) const { return particles->get_flavour(first + particle); }
+
+  // Returns the total four-momentum of the event's particles
+  FourMomentum sum_four_momenta() const;
+  // Returns a copy of the event's particles as separate columns, e.g. for find_pairs
+  EventColumns get_columns() const;
+};
+
+// Particles grouped into events, e.g. one per collision. Every event's particles are appended to one
+// set of shared columns and an event is the range between two offsets, so events are read without
+// any per-event allocation and whole stores are processed event-parallel.
+class EventStore
+{
+private:
+  EventColumns particles;
+  std::vector<size_t> event_offsets{0}; // Event i is [event_offsets[i], event_offsets[i + 1])
+
+public:
+  // Forward iterator over the events
+  class Iterator
+  {
+  private:
+    const EventStore *store;
+    size_t index;
+
+  public:
+    Iterator(const EventStore &store, size_t index) : store(&store), index(index) {}
+    Event operator*() const { return store->get_event(index); }
+    Iterator &operator++()
+    {
+      ++index;
+      return *this;
+    }
+    bool operator==(const Iterator &other) const { return index == other.index; }
+    bool operator!=(const Iterator &other) const { return index != other.index; }
+  };
+
+  // Appends an event with the particles of a catalogue or view, in order
+  template <typename T>
+  void add_event(const ParticleCatalogueView<T> &view)
+  {
+    view.for_each([this](const T *particle)
+                  { particles.add_particle(*particle); });
+    event_offsets.push_back(particles.get_number_of_particles());
+  }
+  template <typename T>
+  void add_event(const ParticleCatalogue<T> &catalogue)
+  {
+    add_event(catalogue.get_view());
+  }
+  // Appends an event with every particle of a set of columns
+  void add_event(const EventColumns &event);
+
+  void reserve(size_t number_of_events, size_t number_of_particles);
+  void clear();
+
+  // Getters
+  size_t get_number_of_events() const { return event_offsets.size() - 1; }
+  size_t get_number_of_particles() const { return particles.get_number_of_particles(); }
+  const EventColumns &get_particles() const { return particles; }
+  Event get_event(size_t index) const
+  {
+    return Event(particles, index, event_offsets[index], event_offsets[index + 1] - event_offsets[index]);
+  }
+  Event operator[](size_t index) const { return get_event(index); }
+  Iterator begin() const { return Iterator(*this, 0); }
+  Iterator end() const { return Iterator(*this, get_number_of_events()); }
+
+  // Applies a function to every event in order
+  template <typename Function>
+  void for_each_event(Function function) const
+  {
+    for (size_t index = 0; index < get_number_of_events(); ++index)
+    {
+      function(get_event(index));
+    }
+  }
+
+  // Applies a function to every event in chunks of consecutive events on a task scheduler. Events
+  // are processed in no particular order, so the function should only write results of its own
+  // event, e.g. to a vector indexed by Event::get_index, which makes the output independent of
+  // scheduling.
+  template <typename Function>
+  void for_each_event_parallel(Function function, size_t events_per_chunk = 16, TaskScheduler &scheduler = TaskScheduler::get_default()) const
+  {
+    scheduler.parallel_for(get_number_of_events(), events_per_chunk, [this, &function](size_t first, size_t last)
+                           {
+                             for (size_t index = first; index < last; ++index)
+                             {
+                               function(get_event(index));
+                             } });
+  }
+};
+
+#endif // EVENT_STORE_H
@@ -0,0 +1,61 @@
+#ifndef FAST_MATH_H
+#define FAST_MATH_H
+
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+
+// Branch-free approximations of transcendental functions for batch loops. They use only
+// arithmetic, bit operations and selects, so loops calling them can be vectorised by the compiler
+// where std::log and std::atan2 calls cannot. Inputs are not checked for NaN or infinity.
+namespace fast_math
+{
+  constexpr double pi = 3.14159265358979323846;
+  constexpr double ln_2 = 0.69314718055994530942;
+
+  constexpr double log_max_error = 1e-12;  // Absolute, for finite x > 0 in the normal range
+  constexpr double atan2_max_error = 2e-8; // Absolute, in radians
+
+  // Natural logarithm for finite x > 0. x = 2^e * m with m in [sqrt(1/2), sqrt(2)), and
+  // log(m) = 2 atanh(s) with s = (m - 1) / (m + 1) in (-0.172, 0.172), summed to s^13.
+  inline double log(double x)
+  {
+    std::uint64_t bits;
+    std::memcpy(&bits, &x, sizeof bits);
+    // Move m into [sqrt(1/2), sqrt(2)) by rounding the exponent at the mantissa of sqrt(2)
+    const std::uint64_t shifted = bits + (0x3ff0000000000000ull - 0x3fe6a09e667f3bcdull);
+    const std::uint64_t mantissa_bits = (shifted & 0x000fffffffffffffull) + 0x3fe6a09e667f3bcdull;
+    // Exponent as a double without an integer conversion: 2^52 + e, built from bits, minus 2^52
+    const std::uint64_t exponent_bits = 0x4330000000000000ull | (shifted >> 52);
+    double m, exponent;
+    std::memcpy(&m, &mantissa_bits, sizeof m);
+    std::memcpy(&exponent, &exponent_bits, sizeof exponent);
+    exponent -= 4503599627370496.0 + 1023;
+
+    const double s = (m - 1) / (m + 1);
+    const double s2 = s * s;
+    const double series = 1 + s2 * (1.0 / 3 + s2 * (1.0 / 5 + s2 * (1.0 / 7 + s2 * (1.0 / 9 + s2 * (1.0 / 11 + s2 * (1.0 / 13))))));
+    return exponent * ln_2 + 2 * s * series;
+  }
+
+  // Angle of (x, y) in [-pi, pi], as std::atan2, with atan(a) for a in [0, 1] from the
+  // polynomial of Abramowitz and Stegun 4.4.49. atan2(0, 0) is 0.
+  inline double atan2(double y, double x)
+  {
+    const double abs_x = std::fabs(x), abs_y = std::fabs(y);
+    const double larger = abs_x > abs_y ? abs_x : abs_y;
+    const double smaller = abs_x > abs_y ? abs_y : abs_x;
+    const double a = smaller / (larger + (larger == 0 ? 1.0 : 0.0)); // 0 when both are 0
+    const double a2 = a * a;
+    const double angle = a * (1 + a2 * (-0.3333314528 + a2 * (0.1999355085 + a2 * (-0.1420889944 + a2 * (0.1065626393 + a2 * (-0.0752896400 + a2 * (0.0429096138 + a2 * (-0.0161657367 + a2 * 0.0028662257))))))));
+    // Octant and quadrant corrections are blended with 0/1 factors. GCC keeps a select between
+    // computed floating-point values as a branch, which stops vectorisation.
+    const double swapped = abs_y > abs_x ? 1.0 : 0.0;
+    const double first_quadrant = angle + swapped * (pi / 2 - 2 * angle);
+    const double left = x < 0 ? 1.0 : 0.0;
+    return std::copysign(first_quadrant + left * (pi - 2 * first_quadrant), y);
+  }
+}
+
+#endif // FAST_MATH_H
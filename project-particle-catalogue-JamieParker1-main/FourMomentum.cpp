@@ -1,4 +1,7 @@
 #include "FourMomentum.h"
+#include "FastMath.h"
+
+#include <limits>
 
 // Constructor
 FourMomentum::FourMomentum(long double energy_or_rest_mass, long double px, long double py, long double pz, bool energy_is_rest_mass)
@@ -118,6 +121,52 @@ std::vector<long double> FourMomentum::get_velocity_vector(bool positive) const
   }
 }
 
+double FourMomentum::get_pt() const
+{
+  return std::sqrt(static_cast<double>(px * px + py * py));
+}
+
+double FourMomentum::get_eta() const
+{
+  const double pt = get_pt();
+  if (pt == 0)
+  {
+    return pz == 0 ? 0 : std::copysign(std::numeric_limits<double>::infinity(), static_cast<double>(pz));
+  }
+  return std::asinh(static_cast<double>(pz) / pt);
+}
+
+double FourMomentum::get_rapidity() const
+{
+  // 0.5 ln((E + pz) / (E - pz)) written as ln((E + |pz|) / mT), which does not cancel for large |pz|
+  const double transverse_mass = get_transverse_mass();
+  if (transverse_mass == 0)
+  {
+    return pz == 0 ? 0 : std::copysign(std::numeric_limits<double>::infinity(), static_cast<double>(pz));
+  }
+  return std::copysign(std::log((energy + std::fabs(pz)) / transverse_mass), static_cast<double>(pz));
+}
+
+double FourMomentum::get_phi() const
+{
+  return std::atan2(static_cast<double>(py), static_cast<double>(px));
+}
+
+double FourMomentum::get_transverse_mass() const
+{
+  return std::sqrt(std::max(0.0, static_cast<double>(energy * energy - pz * pz)));
+}
+
+double FourMomentum::delta_phi(const FourMomentum &other) const
+{
+  return std::remainder(get_phi() - other.get_phi(), 2 * fast_math::pi);
+}
+
+double FourMomentum::delta_r(const FourMomentum &other) const
+{
+  return std::hypot(get_eta() - other.get_eta(), delta_phi(other));
+}
+
 // Function to calculate the invariant mass of the four momentum
 double FourMomentum::invariant_mass() const
 {
@@ -156,7 +205,7 @@ void FourMomentum::lorentz_boost(long double v_x, long double v_y, long double v
   py = new_py;
   pz = new_pz;
 }
-void FourMomentum::lorentz_boost(std::vector<long double> v_xyz)
+void FourMomentum::lorentz_boost(const std::vector<long double> &v_xyz)
 {// Velocity in units of c
   if (v_xyz.size() != 3)
   {
@@ -189,4 +238,80 @@ std::ostream &operator<<(std::ostream &os, const FourMomentum &fm)
 {
   os << "Energy: " << fm.get_energy() << ", Px: " << fm.get_Px() << ", Py: " << fm.get_Py() << ", Pz: " << fm.get_Pz();
   return os;
-}
\ No newline at end of file
+}
+void compute_pt(const double *px, const double *py, size_t count, double *pt)
+{
+  for (size_t i = 0; i < count; ++i)
+  {
+    pt[i] = std::sqrt(px[i] * px[i] + py[i] * py[i]);
+  }
+}
+
+void compute_phi(const double *px, const double *py, size_t count, double *phi)
+{
+  for (size_t i = 0; i < count; ++i)
+  {
+    phi[i] = fast_math::atan2(py[i], px[i]);
+  }
+}
+
+// ln((|p| + |pz|) / pt) and ln((E + |pz|) / mT) are evaluated as ln(numerator / denominator) with
+// the smallest double added to both sides, so zero momentum gives ln(1) = 0, and 2^-1000 of the
+// numerator added to the denominator, so the ratio is at most 2^1000 along the beam. Both offsets
+// avoid comparisons, which GCC will not vectorise there under its default -ftrapping-math.
+namespace
+{
+  constexpr double tiny = std::numeric_limits<double>::min();
+  constexpr double largest_ratio_inverse = 0x1p-1000;
+}
+
+void compute_eta(const double *px, const double *py, const double *pz, size_t count, double *eta)
+{
+  for (size_t i = 0; i < count; ++i)
+  {
+    const double pt_2 = px[i] * px[i] + py[i] * py[i];
+    const double numerator = std::sqrt(pt_2 + pz[i] * pz[i]) + std::fabs(pz[i]) + tiny;
+    const double denominator = std::sqrt(pt_2) + tiny + numerator * largest_ratio_inverse;
+    eta[i] = std::copysign(fast_math::log(numerator / denominator), pz[i]);
+  }
+}
+
+void compute_rapidity(const double *energy, const double *pz, size_t count, double *rapidity)
+{
+  for (size_t i = 0; i < count; ++i)
+  {
+    const double abs_pz = std::fabs(pz[i]);
+    // mT^2 as (E - |pz|)(E + |pz|), which keeps its precision when E is close to |pz|, with
+    // E - |pz| clamped at 0 by (d + |d|) / 2
+    const double difference = energy[i] - abs_pz;
+    const double transverse_mass_2 = 0.5 * (difference + std::fabs(difference)) * (energy[i] + abs_pz);
+    const double numerator = energy[i] + abs_pz + tiny;
+    const double denominator = std::sqrt(transverse_mass_2) + tiny + numerator * largest_ratio_inverse;
+    rapidity[i] = std::copysign(fast_math::log(numerator / denominator), pz[i]);
+  }
+}
+
+// Unlike the loops above this clamps mT^2 at 0 with a compare. It is a plain select of the larger
+// value, which GCC turns into a vector max, so the loop still vectorises.
+void compute_transverse_mass(const double *energy, const double *pz, size_t count, double *transverse_mass)
+{
+  for (size_t i = 0; i < count; ++i)
+  {
+    const double transverse_mass_2 = (energy[i] - pz[i]) * (energy[i] + pz[i]);
+    transverse_mass[i] = std::sqrt(transverse_mass_2 > 0 ? transverse_mass_2 : 0);
+  }
+}
+
+void compute_delta_r(const double *eta_a, const double *phi_a, const double *eta_b, const double *phi_b, size_t count, double *delta_r)
+{
+  const double two_pi = 2 * fast_math::pi;
+  const double round_to_integer = 6755399441055744.0; // 1.5 * 2^52, adding and subtracting it rounds to the nearest integer
+  for (size_t i = 0; i < count; ++i)
+  {
+    const double delta_eta = eta_a[i] - eta_b[i];
+    const double delta_phi = phi_a[i] - phi_b[i];
+    const double turns = (delta_phi / two_pi + round_to_integer) - round_to_integer;
+    const double wrapped = delta_phi - turns * two_pi;
+    delta_r[i] = std::sqrt(delta_eta * delta_eta + wrapped * wrapped);
+  }
+}
@@ -10,6 +10,8 @@ class FourMomentum
 private:
   long double energy;     // Energy component E
   long double px, py, pz; // Momentum components along the x, y, and z axes
+
+  friend class Frame; // Boosts components in place with its precomputed matrix
 public:
   // Constructor to initialize the four-momentum components
   // FourMomentum(double energy = 0.0, double px = 0.0, double py = 0.0, double pz = 0.0, bool energy_is_rest_mass = false);
@@ -38,12 +40,21 @@ public:
   long double get_velocity_z() const;
   std::vector<long double> get_velocity_vector(bool positive = true) const;
 
+  // Collider-frame kinematics, with the beam along z
+  double get_pt() const;              // Transverse momentum
+  double get_eta() const;             // Pseudorapidity, +-infinity along the beam and 0 for zero momentum
+  double get_rapidity() const;        // Rapidity, +-infinity for a massless particle along the beam
+  double get_phi() const;             // Azimuth in [-pi, pi]
+  double get_transverse_mass() const; // sqrt(E^2 - pz^2) = sqrt(m^2 + pt^2)
+  double delta_phi(const FourMomentum &other) const; // Azimuth difference wrapped into [-pi, pi]
+  double delta_r(const FourMomentum &other) const;   // sqrt(delta_eta^2 + delta_phi^2)
+
   // Function to calculate the invariant mass (magnitude) of the four-momentum
   double invariant_mass() const;
   // Function to perform Lorentz boost to four-momentum
   // void lorentz_boost(double v_x, double v_y, double v_z);
   void lorentz_boost(long double v_x, long double v_y, long double v_z);
-  void lorentz_boost(std::vector<long double> v_xyz);
+  void lorentz_boost(const std::vector<long double> &v_xyz);
 
   // Overloaded operators
   FourMomentum operator+(const FourMomentum& rhs) const; // Addition
@@ -54,4 +65,18 @@ public:
 // Overloaded << operator declaration
 std::ostream &operator<<(std::ostream &os, const FourMomentum &fm);
 
+// Batch collider-frame kinematics over packed columns of count entries. The loops have no branches
+// or calls other than sqrt, and compute_transverse_mass's one compare is a max, so the compiler
+// vectorises them at -O3 -fno-math-errno.
+// phi uses fast_math::atan2, within fast_math::atan2_max_error (2e-8 rad) of std::atan2. eta and
+// rapidity use fast_math::log, within fast_math::log_max_error (1e-12) of std::log, plus the
+// rounding of its argument. Along the beam, where the getters return +-infinity, they return
+// +-693.15 (ln 2^1000).
+void compute_pt(const double *px, const double *py, size_t count, double *pt);
+void compute_phi(const double *px, const double *py, size_t count, double *phi);
+void compute_eta(const double *px, const double *py, const double *pz, size_t count, double *eta);
+void compute_rapidity(const double *energy, const double *pz, size_t count, double *rapidity);
+void compute_transverse_mass(const double *energy, const double *pz, size_t count, double *transverse_mass);
+void compute_delta_r(const double *eta_a, const double *phi_a, const double *eta_b, const double *phi_b, size_t count, double *delta_r);
+
 #endif // FOURMOMENTUM_H
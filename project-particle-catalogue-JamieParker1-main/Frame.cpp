@@ -0,0 +1,154 @@
+#include "Frame.h"
+
+#include <cmath>
+#include <stdexcept>
+
+// Default constructor
+Frame::Frame() : Frame(0, 0, 0) {}
+
+// Constructor, building the boost matrix once
+Frame::Frame(long double v_x, long double v_y, long double v_z) : velocity{v_x, v_y, v_z}, matrix{}
+{
+  const long double v_magnitude_2 = v_x * v_x + v_y * v_y + v_z * v_z;
+  if (!(v_magnitude_2 < 1))
+  {
+    throw std::invalid_argument("Error: Frame velocity must be below the speed of light.");
+  }
+  const long double gamma = 1 / std::sqrt(1 - v_magnitude_2);
+  // (gamma - 1) / v^2, written as gamma^2 / (gamma + 1) so it stays finite as v goes to 0
+  const long double factor = gamma * gamma / (gamma + 1);
+
+  matrix[0][0] = gamma;
+  for (size_t i = 0; i < 3; ++i)
+  {
+    matrix[0][i + 1] = -gamma * velocity[i];
+    matrix[i + 1][0] = -gamma * velocity[i];
+    for (size_t j = 0; j < 3; ++j)
+    {
+      matrix[i + 1][j + 1] = (i == j ? 1 : 0) + factor * velocity[i] * velocity[j];
+    }
+  }
+}
+
+Frame::Frame(const std::array<long double, 3> &velocity) : Frame(velocity[0], velocity[1], velocity[2]) {}
+
+Frame Frame::lab()
+{
+  return Frame();
+}
+
+Frame Frame::rest_frame(const FourMomentum &four_momentum)
+{
+  const long double energy = four_momentum.get_energy();
+  if (energy <= 0)
+  {
+    throw std::invalid_argument("Error: FourMomentum energy must be greater than 0 to have a rest frame.");
+  }
+  return Frame(four_momentum.get_Px() / energy, four_momentum.get_Py() / energy, four_momentum.get_Pz() / energy);
+}
+
+Frame Frame::centre_of_mass(const FourMomentum *momenta, size_t count)
+{
+  long double energy = 0, px = 0, py = 0, pz = 0;
+  for (size_t i = 0; i < count; ++i)
+  {
+    energy += momenta[i].get_energy();
+    px += momenta[i].get_Px();
+    py += momenta[i].get_Py();
+    pz += momenta[i].get_Pz();
+  }
+  return rest_frame(FourMomentum(energy, px, py, pz));
+}
+
+Frame Frame::centre_of_mass(const std::vector<FourMomentum> &momenta)
+{
+  return centre_of_mass(momenta.data(), momenta.size());
+}
+
+Frame Frame::inverse() const
+{
+  return Frame(-velocity[0], -velocity[1], -velocity[2]);
+}
+
+FourMomentum Frame::transform(const FourMomentum &four_momentum) const
+{
+  FourMomentum result(four_momentum);
+  apply(result);
+  return result;
+}
+
+void Frame::apply(FourMomentum &four_momentum) const
+{
+  const long double in[4] = {four_momentum.energy, four_momentum.px, four_momentum.py, four_momentum.pz};
+  long double out[4];
+  for (size_t i = 0; i < 4; ++i)
+  {
+    out[i] = matrix[i][0] * in[0] + matrix[i][1] * in[1] + matrix[i][2] * in[2] + matrix[i][3] * in[3];
+  }
+  four_momentum.energy = out[0];
+  four_momentum.px = out[1];
+  four_momentum.py = out[2];
+  four_momentum.pz = out[3];
+}
+
+void to_frame(FourMomentum *momenta, size_t count, const Frame &frame)
+{
+  for (size_t i = 0; i < count; ++i)
+  {
+    frame.apply(momenta[i]);
+  }
+}
+
+void to_frame(std::vector<FourMomentum> &momenta, const Frame &frame)
+{
+  to_frame(momenta.data(), momenta.size(), frame);
+}
+
+// The boosted four-momentum is on the same mass shell, so it is set without revalidation
+void to_frame(Particle &particle, const Frame &frame, bool include_decay_products)
+{
+  particle.set_trusted_four_momentum(frame.transform(particle.get_four_momentum()));
+  if (include_decay_products)
+  {
+    for (const auto &product : particle.get_decay_products())
+    {
+      if (product)
+      {
+        to_frame(*product, frame, true);
+      }
+    }
+  }
+}
+
+Frame parent_rest_frame(const Particle &parent)
+{
+  return Frame::rest_frame(parent.get_four_momentum());
+}
+
+Frame centre_of_mass_frame(const std::vector<std::unique_ptr<Particle>> &particles)
+{
+  long double energy = 0, px = 0, py = 0, pz = 0;
+  for (const auto &particle : particles)
+  {
+    const FourMomentum &four_momentum = particle->get_four_momentum();
+    energy += four_momentum.get_energy();
+    px += four_momentum.get_Px();
+    py += four_momentum.get_Py();
+    pz += four_momentum.get_Pz();
+  }
+  return Frame::rest_frame(FourMomentum(energy, px, py, pz));
+}
+
+Frame centre_of_mass_frame(const std::vector<Particle *> &particles)
+{
+  long double energy = 0, px = 0, py = 0, pz = 0;
+  for (const Particle *particle : particles)
+  {
+    const FourMomentum &four_momentum = particle->get_four_momentum();
+    energy += four_momentum.get_energy();
+    px += four_momentum.get_Px();
+    py += four_momentum.get_Py();
+    pz += four_momentum.get_Pz();
+  }
+  return Frame::rest_frame(FourMomentum(energy, px, py, pz));
+}
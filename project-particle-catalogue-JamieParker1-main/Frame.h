@@ -0,0 +1,63 @@
+#ifndef FRAME_H
+#define FRAME_H
+
+#include "FourMomentum.h"
+#include "Particle.h"
+
+#include <array>
+#include <memory>
+#include <vector>
+
+// Inertial reference frame moving at a velocity (units of c) relative to the lab. The Lorentz
+// transformation into the frame is computed once as a 4x4 matrix, so boosting any number of
+// four-momenta costs one matrix-vector product each, with no square roots or temporary vectors.
+// Boosting into Frame(v) gives the same result as FourMomentum::lorentz_boost(v).
+class Frame
+{
+private:
+  std::array<long double, 3> velocity;                 // Velocity of the frame in the lab
+  std::array<std::array<long double, 4>, 4> matrix;    // Maps (E, px, py, pz) in the lab into the frame
+
+public:
+  // Default constructor, the lab frame
+  Frame();
+  // Constructor from the frame's velocity, throws if it is not below the speed of light
+  Frame(long double v_x, long double v_y, long double v_z);
+  explicit Frame(const std::array<long double, 3> &velocity);
+
+  // Helpers for common frames
+  static Frame lab();
+  // Frame in which a four-momentum is at rest, throws for massless momenta
+  static Frame rest_frame(const FourMomentum &four_momentum);
+  // Frame in which the total momentum of a set of four-momenta is zero
+  static Frame centre_of_mass(const FourMomentum *momenta, size_t count);
+  static Frame centre_of_mass(const std::vector<FourMomentum> &momenta);
+
+  // Getters
+  const std::array<long double, 3> &get_velocity() const { return velocity; }
+  const std::array<std::array<long double, 4>, 4> &get_matrix() const { return matrix; }
+  long double get_gamma() const { return matrix[0][0]; }
+
+  // Returns the frame that undoes this one, i.e. the lab as seen from this frame
+  Frame inverse() const;
+
+  // Returns the four-momentum as seen in this frame
+  FourMomentum transform(const FourMomentum &four_momentum) const;
+  // Boosts a four-momentum into this frame in place
+  void apply(FourMomentum &four_momentum) const;
+};
+
+// Boosts a contiguous range of four-momenta into a frame in place
+void to_frame(FourMomentum *momenta, size_t count, const Frame &frame);
+void to_frame(std::vector<FourMomentum> &momenta, const Frame &frame);
+// Boosts a particle, and by default its whole decay tree, into a frame in place. An electron's
+// calorimeter deposits are rescaled to its new energy, keeping each layer's share.
+void to_frame(Particle &particle, const Frame &frame, bool include_decay_products = true);
+
+// Rest frame of a particle, the frame its decay products are generated in
+Frame parent_rest_frame(const Particle &parent);
+// Centre-of-mass frame of a set of particles, e.g. a particle's decay products
+Frame centre_of_mass_frame(const std::vector<std::unique_ptr<Particle>> &particles);
+Frame centre_of_mass_frame(const std::vector<Particle *> &particles);
+
+#endif // FRAME_H
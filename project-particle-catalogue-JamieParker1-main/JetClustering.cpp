@@ -0,0 +1,359 @@
+#include "JetClustering.h"
+#include "FastMath.h"
+#include "bosons/Gluon.h"
+#include "quarks/Quark.h"
+
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <limits>
+#include <queue>
+#include <stdexcept>
+
+namespace
+{
+  constexpr double two_pi = 2 * fast_math::pi;
+  constexpr double tile_rapidity_limit = 10; // Tiles beyond are merged into the edge rows
+  constexpr std::uint32_t no_jet = std::numeric_limits<std::uint32_t>::max();
+
+  // Rapidity from the transverse mass, mT^2 = (E - |pz|)(E + |pz|)
+  double get_rapidity(double energy, double pz)
+  {
+    const double abs_pz = std::fabs(pz);
+    const double difference = energy - abs_pz;
+    const double transverse_mass_2 = difference > 0 ? difference * (energy + abs_pz) : 0;
+    if (!(transverse_mass_2 > 0))
+    {
+      return std::copysign(jet_max_rapidity, pz);
+    }
+    return std::copysign(std::min(std::log((energy + abs_pz) / std::sqrt(transverse_mass_2)), jet_max_rapidity), pz);
+  }
+
+  // Candidate for the smallest distance, valid while version matches the pseudo-jet's
+  struct HeapEntry
+  {
+    double distance;
+    std::uint32_t jet;
+    std::uint32_t version;
+
+    bool operator>(const HeapEntry &other) const
+    {
+      return distance > other.distance || (distance == other.distance && jet > other.jet);
+    }
+  };
+
+  // Pseudo-jets as columns. The first count are the inputs, each merge appends one.
+  class Clustering
+  {
+  private:
+    double radius_2;
+    double power;
+    std::vector<double> energy, px, py, pz, rapidity, phi;
+    std::vector<double> pt_power;                     // pt^2p, the beam distance
+    std::vector<std::uint32_t> nearest;               // Nearest neighbour within R, or no_jet
+    std::vector<double> nearest_distance;             // dR^2 to it, R^2 without one
+    std::vector<std::uint32_t> parent_a, parent_b;    // Merged pseudo-jets, no_jet for inputs
+    std::vector<std::uint32_t> tile, tile_position;   // Tile and position in its member list
+    std::vector<std::uint32_t> version;               // Bumped on every push and on removal
+    std::vector<std::vector<std::uint32_t>> tile_members;
+    std::vector<std::vector<std::uint32_t>> tile_neighbours; // Each tile and the up to 8 around it, without repeats
+    size_t rows = 1, columns = 1;
+    double rapidity_low = 0, row_height = 1, column_width = two_pi;
+    std::priority_queue<HeapEntry, std::vector<HeapEntry>, std::greater<HeapEntry>> heap;
+
+    std::uint32_t get_tile(double jet_rapidity, double jet_phi) const
+    {
+      const double row = std::floor((jet_rapidity - rapidity_low) / row_height);
+      const size_t clamped_row = static_cast<size_t>(std::min(std::max(row, 0.0), static_cast<double>(rows - 1)));
+      const long long column = static_cast<long long>(std::floor((jet_phi + fast_math::pi) / column_width)) % static_cast<long long>(columns);
+      return static_cast<std::uint32_t>(clamped_row * columns + static_cast<size_t>(column < 0 ? column + static_cast<long long>(columns) : column));
+    }
+
+    double get_distance(std::uint32_t a, std::uint32_t b) const
+    {
+      const double delta_rapidity = rapidity[a] - rapidity[b];
+      double delta_phi = std::fabs(phi[a] - phi[b]);
+      delta_phi = delta_phi > fast_math::pi ? two_pi - delta_phi : delta_phi;
+      return delta_rapidity * delta_rapidity + delta_phi * delta_phi;
+    }
+
+    double get_pt_power(double pt_2) const
+    {
+      if (power == 0)
+      {
+        return 1;
+      }
+      if (power > 0)
+      {
+        return pt_2;
+      }
+      return pt_2 > 0 ? 1 / pt_2 : std::numeric_limits<double>::max();
+    }
+
+    // Appends a pseudo-jet and puts it in its tile
+    std::uint32_t add_jet(double jet_energy, double jet_px, double jet_py, double jet_pz, std::uint32_t a, std::uint32_t b)
+    {
+      const std::uint32_t jet = static_cast<std::uint32_t>(energy.size());
+      energy.push_back(jet_energy);
+      px.push_back(jet_px);
+      py.push_back(jet_py);
+      pz.push_back(jet_pz);
+      rapidity.push_back(get_rapidity(jet_energy, jet_pz));
+      phi.push_back(std::atan2(jet_py, jet_px));
+      pt_power.push_back(get_pt_power(jet_px * jet_px + jet_py * jet_py));
+      nearest.push_back(no_jet);
+      nearest_distance.push_back(radius_2);
+      parent_a.push_back(a);
+      parent_b.push_back(b);
+      version.push_back(0);
+      tile.push_back(get_tile(rapidity.back(), phi.back()));
+      tile_position.push_back(static_cast<std::uint32_t>(tile_members[tile.back()].size()));
+      tile_members[tile.back()].push_back(jet);
+      return jet;
+    }
+
+    // Takes a pseudo-jet out of its tile and invalidates its heap entries
+    void remove_jet(std::uint32_t jet)
+    {
+      std::vector<std::uint32_t> &members = tile_members[tile[jet]];
+      const std::uint32_t moved = members.back();
+      members[tile_position[jet]] = moved;
+      tile_position[moved] = tile_position[jet];
+      members.pop_back();
+      ++version[jet];
+    }
+
+    // Scans the tiles around a pseudo-jet for its nearest neighbour within R
+    void find_nearest(std::uint32_t jet)
+    {
+      nearest[jet] = no_jet;
+      nearest_distance[jet] = radius_2;
+      for (std::uint32_t neighbour_tile : tile_neighbours[tile[jet]])
+      {
+        for (std::uint32_t other : tile_members[neighbour_tile])
+        {
+          const double distance = other == jet ? radius_2 : get_distance(jet, other);
+          if (distance < nearest_distance[jet])
+          {
+            nearest[jet] = other;
+            nearest_distance[jet] = distance;
+          }
+        }
+      }
+    }
+
+    // Pushes the current d_ij of a pseudo-jet with its nearest neighbour, or d_iB without one
+    void push(std::uint32_t jet)
+    {
+      const double pt_power_min = nearest[jet] == no_jet ? pt_power[jet] : std::min(pt_power[jet], pt_power[nearest[jet]]);
+      heap.push(HeapEntry{pt_power_min * (nearest_distance[jet] / radius_2), jet, ++version[jet]});
+    }
+
+    void build_tiles(double radius, const double *input_rapidity, size_t count)
+    {
+      double low = tile_rapidity_limit, high = -tile_rapidity_limit;
+      for (size_t i = 0; i < count; ++i)
+      {
+        low = std::min(low, input_rapidity[i]);
+        high = std::max(high, input_rapidity[i]);
+      }
+      low = std::max(low, -tile_rapidity_limit);
+      high = std::min(high, tile_rapidity_limit);
+      // Tiles at least R wide, so points within R are at most one row and one column apart
+      rapidity_low = low > high ? 0 : low;
+      rows = low > high ? 1 : static_cast<size_t>((high - low) / radius) + 1;
+      row_height = radius;
+      columns = std::max<size_t>(1, static_cast<size_t>(two_pi / radius));
+      column_width = two_pi / columns;
+
+      tile_members.assign(rows * columns, {});
+      tile_neighbours.assign(rows * columns, {});
+      for (size_t row = 0; row < rows; ++row)
+      {
+        for (size_t column = 0; column < columns; ++column)
+        {
+          std::vector<std::uint32_t> &neighbours = tile_neighbours[row * columns + column];
+          for (size_t neighbour_row = row == 0 ? 0 : row - 1; neighbour_row <= std::min(row + 1, rows - 1); ++neighbour_row)
+          {
+            for (size_t step = 0; step < 3; ++step)
+            {
+              const std::uint32_t neighbour = static_cast<std::uint32_t>(neighbour_row * columns + (column + columns + step - 1) % columns);
+              if (std::find(neighbours.begin(), neighbours.end(), neighbour) == neighbours.end())
+              {
+                neighbours.push_back(neighbour);
+              }
+            }
+          }
+        }
+      }
+    }
+
+    // Merges the tiles around three tiles into one list without repeats
+    void get_tiles_around(std::uint32_t a, std::uint32_t b, std::uint32_t c, std::vector<std::uint32_t> &tiles) const
+    {
+      tiles.clear();
+      for (std::uint32_t centre : {a, b, c})
+      {
+        for (std::uint32_t neighbour : tile_neighbours[centre])
+        {
+          if (std::find(tiles.begin(), tiles.end(), neighbour) == tiles.end())
+          {
+            tiles.push_back(neighbour);
+          }
+        }
+      }
+    }
+
+    // Positions of the inputs clustered into a pseudo-jet, in increasing order
+    std::vector<std::uint32_t> get_constituents(std::uint32_t jet, size_t count) const
+    {
+      std::vector<std::uint32_t> constituents;
+      std::vector<std::uint32_t> stack{jet};
+      while (!stack.empty())
+      {
+        const std::uint32_t current = stack.back();
+        stack.pop_back();
+        if (current < count)
+        {
+          constituents.push_back(current);
+        }
+        else
+        {
+          stack.push_back(parent_a[current]);
+          stack.push_back(parent_b[current]);
+        }
+      }
+      std::sort(constituents.begin(), constituents.end());
+      return constituents;
+    }
+
+  public:
+    Clustering(const JetDefinition &definition)
+        : radius_2(definition.radius * definition.radius),
+          power(definition.algorithm == JetAlgorithm::kt ? 1 : definition.algorithm == JetAlgorithm::anti_kt ? -1 : 0) {}
+
+    void run(const double *input_energy, const double *input_px, const double *input_py, const double *input_pz, size_t count,
+             const JetDefinition &definition, std::vector<Jet> &jets)
+    {
+      std::vector<double> input_rapidity(count);
+      for (size_t i = 0; i < count; ++i)
+      {
+        input_rapidity[i] = get_rapidity(input_energy[i], input_pz[i]);
+      }
+      build_tiles(definition.radius, input_rapidity.data(), count);
+
+      for (std::vector<double> *column : {&energy, &px, &py, &pz, &rapidity, &phi, &pt_power, &nearest_distance})
+      {
+        column->reserve(2 * count);
+      }
+      for (std::vector<std::uint32_t> *column : {&nearest, &parent_a, &parent_b, &tile, &tile_position, &version})
+      {
+        column->reserve(2 * count);
+      }
+      for (size_t i = 0; i < count; ++i)
+      {
+        add_jet(input_energy[i], input_px[i], input_py[i], input_pz[i], no_jet, no_jet);
+      }
+      for (std::uint32_t jet = 0; jet < count; ++jet)
+      {
+        find_nearest(jet);
+        push(jet);
+      }
+
+      // Each step either merges the pair with the smallest d_ij or makes a pseudo-jet a final jet
+      std::vector<std::uint32_t> final_jets;
+      std::vector<std::uint32_t> tiles;
+      while (!heap.empty())
+      {
+        const HeapEntry top = heap.top();
+        heap.pop();
+        if (top.version != version[top.jet])
+        {
+          continue;
+        }
+        const std::uint32_t a = top.jet;
+        const std::uint32_t b = nearest[a];
+        if (b == no_jet)
+        {
+          final_jets.push_back(a);
+          remove_jet(a);
+          continue;
+        }
+
+        remove_jet(a);
+        remove_jet(b);
+        const std::uint32_t merged = add_jet(energy[a] + energy[b], px[a] + px[b], py[a] + py[b], pz[a] + pz[b], a, b);
+
+        // Only pseudo-jets around a, b or the merged one can have lost or gained a nearest neighbour
+        get_tiles_around(tile[a], tile[b], tile[merged], tiles);
+        for (std::uint32_t neighbour_tile : tiles)
+        {
+          for (std::uint32_t other : tile_members[neighbour_tile])
+          {
+            if (other == merged)
+            {
+              continue;
+            }
+            const double distance = get_distance(other, merged);
+            if (distance < nearest_distance[merged])
+            {
+              nearest[merged] = other;
+              nearest_distance[merged] = distance;
+            }
+            if (nearest[other] == a || nearest[other] == b)
+            {
+              find_nearest(other);
+              push(other);
+            }
+            else if (distance < nearest_distance[other])
+            {
+              nearest[other] = merged;
+              nearest_distance[other] = distance;
+              push(other);
+            }
+          }
+        }
+        push(merged);
+      }
+
+      jets.clear();
+      const double min_pt_2 = definition.min_pt > 0 ? definition.min_pt * definition.min_pt : 0;
+      for (std::uint32_t jet : final_jets)
+      {
+        if (px[jet] * px[jet] + py[jet] * py[jet] >= min_pt_2)
+        {
+          jets.push_back(Jet{FourMomentum(energy[jet], px[jet], py[jet], pz[jet]), get_constituents(jet, count)});
+        }
+      }
+      std::stable_sort(jets.begin(), jets.end(), [](const Jet &x, const Jet &y)
+                       { return x.four_momentum.get_pt() > y.four_momentum.get_pt(); });
+    }
+  };
+}
+
+bool is_coloured(const Particle *particle)
+{
+  return dynamic_cast<const Quark *>(particle) != nullptr || dynamic_cast<const Gluon *>(particle) != nullptr;
+}
+
+void cluster_jets(const double *energy, const double *px, const double *py, const double *pz, size_t count,
+                  const JetDefinition &definition, std::vector<Jet> &jets)
+{
+  if (!(definition.radius > 0 && std::isfinite(definition.radius)))
+  {
+    throw std::invalid_argument("Error: Jet radius must be greater than 0 and finite.");
+  }
+  if (count >= no_jet / 2)
+  {
+    throw std::length_error("Error: Too many particles to cluster.");
+  }
+  Clustering(definition).run(energy, px, py, pz, count, definition, jets);
+}
+
+std::vector<Jet> cluster_jets(const EventColumns &event, const JetDefinition &definition)
+{
+  std::vector<Jet> jets;
+  cluster_jets(event.get_energy().data(), event.get_px().data(), event.get_py().data(), event.get_pz().data(),
+               event.get_number_of_particles(), definition, jets);
+  return jets;
+}
@@ -0,0 +1,79 @@
+#ifndef JET_CLUSTERING_H
+#define JET_CLUSTERING_H
+
+#include "Combinatorics.h"
+#include "FourMomentum.h"
+#include "Particle.h"
+#include "ParticleCatalogue.h"
+
+#include <cstdint>
+#include <vector>
+
+// Sequential-recombination algorithms, by the power p of pt in d_ij = min(pt_i^2p, pt_j^2p) dR^2 / R^2
+enum class JetAlgorithm
+{
+  kt,               // p = 1, softest first
+  cambridge_aachen, // p = 0, purely angular
+  anti_kt           // p = -1, hardest first, cone-like jets
+};
+
+// Algorithm, radius and the minimum pt of the jets returned
+struct JetDefinition
+{
+  JetAlgorithm algorithm = JetAlgorithm::anti_kt;
+  double radius = 0.4;
+  double min_pt = 0; // MeV, inclusive
+};
+
+// Jet with its four-momentum, the sum of its constituents' (E-scheme), and the positions of its
+// constituents in the input in increasing order
+struct Jet
+{
+  FourMomentum four_momentum;
+  std::vector<std::uint32_t> constituents;
+};
+
+// Rapidity assigned to inputs with no transverse mass, e.g. massless along the beam
+constexpr double jet_max_rapidity = 1e5;
+
+// Returns true for quarks and gluons, the usual inputs to jet clustering
+bool is_coloured(const Particle *particle);
+
+// Clusters the particles of an event into inclusive jets, sorted by decreasing pt. Distances use
+// rapidity and azimuth. Pseudo-jets are kept in tiles of (rapidity, phi) at least R wide, so each
+// one's nearest neighbour within R is in its own or an adjacent tile, and after a merge only the
+// pseudo-jets in the tiles around the merged ones are updated. The smallest distance is taken from a
+// heap. This is the tiled N^2 strategy, not the O(n log n) Voronoi one: the worst case, with every
+// particle in a few tiles, is O(n^2), but spread-out events cost far less, and either way it avoids
+// the O(n^3) of recomputing every distance at each step. Throws unless the radius is greater than 0
+// and finite.
+std::vector<Jet> cluster_jets(const EventColumns &event, const JetDefinition &definition = JetDefinition());
+void cluster_jets(const double *energy, const double *px, const double *py, const double *pz, size_t count,
+                  const JetDefinition &definition, std::vector<Jet> &jets);
+
+// Clusters every particle of a view, constituents refer to positions in the view
+template <typename T>
+std::vector<Jet> cluster_jets(const ParticleCatalogueView<T> &view, const JetDefinition &definition = JetDefinition())
+{
+  return cluster_jets(make_event_columns(view), definition);
+}
+
+// Clusters the quarks and gluons of a catalogue, constituents refer to positions in the catalogue
+template <typename T>
+std::vector<Jet> cluster_jets(const ParticleCatalogue<T> &catalogue, const JetDefinition &definition = JetDefinition())
+{
+  const ParticleCatalogueView<T> coloured = catalogue.get_view().filter([](const T *particle)
+                                                                        { return is_coloured(particle); });
+  std::vector<Jet> jets = cluster_jets(coloured, definition);
+  const std::vector<size_t> &indices = coloured.get_indices();
+  for (Jet &jet : jets)
+  {
+    for (std::uint32_t &constituent : jet.constituents)
+    {
+      constituent = static_cast<std::uint32_t>(indices[constituent]);
+    }
+  }
+  return jets;
+}
+
+#endif // JET_CLUSTERING_H
@@ -2,9 +2,14 @@
 #include "Particle.h"
 #include "FourMomentum.h"
 #include "helper_functions.h"
+#include "Frame.h"
+#include "TaskScheduler.h"
 #include <iostream>  // For std::cout
 #include <stdexcept> // For std::invalid_argument
 #include <iomanip>
+#include <cmath>
+#include <algorithm>
+#include <atomic>
 
 namespace Mass
 {
@@ -47,7 +52,7 @@ Particle::Particle() : type("particle"), label("General Particle"), charge(0), r
 
 // Protected constructor without label with four-momentum
 Particle::Particle(std::string type, double charge, double spin, double rest_mass, std::unique_ptr<FourMomentum> four_momentum, std::vector<DecayType> possible_decay_types)
-    : type(type), charge(charge), spin(spin), rest_mass(rest_mass), four_momentum(std::move(four_momentum)), possible_decay_types(possible_decay_types)
+    : type(type), charge(charge), spin(spin), rest_mass(rest_mass), possible_decay_types(possible_decay_types)
 {
   if (four_momentum->get_energy() <= 0)
   {
@@ -80,6 +85,10 @@ Particle::Particle(std::string type, const std::string &label, double charge, do
     throw std::invalid_argument("Rest mass does not match the invariant mass of the provided FourMomentum.");
   }
 }
+// Protected trusted constructor without label with four-momentum
+Particle::Particle(Trusted, std::string type, double charge, double spin, double rest_mass, std::unique_ptr<FourMomentum> four_momentum, std::vector<DecayType> possible_decay_types)
+    : type(std::move(type)), charge(charge), spin(spin), possible_decay_types(std::move(possible_decay_types)), four_momentum(std::move(four_momentum)), rest_mass(rest_mass) {}
+
 // Constructor without label without four-momentum
 Particle::Particle(std::string type, double charge, double spin, double rest_mass, std::vector<DecayType> possible_decay_types)
     : type(type), charge(charge), spin(spin), rest_mass(rest_mass), four_momentum((rest_mass > 0) ? std::make_unique<FourMomentum>(rest_mass, 0, 0, 0, true) : std::make_unique<FourMomentum>(1, 0, 0, 1)), possible_decay_types(possible_decay_types) {}
@@ -90,19 +99,22 @@ Particle::Particle(std::string type, const std::string &label, double charge, do
 
 // Copy constructor
 Particle::Particle(const Particle &other)
-    : label(other.label), charge(other.charge), spin(other.spin),
-      four_momentum(other.four_momentum ? std::make_unique<FourMomentum>(*other.four_momentum) : nullptr)
+    : type(other.type), label(other.label), charge(other.charge), spin(other.spin), is_virtual(other.is_virtual),
+      possible_decay_types(other.possible_decay_types), current_decay_type(other.current_decay_type),
+      four_momentum(other.four_momentum ? std::make_unique<FourMomentum>(*other.four_momentum) : nullptr), rest_mass(other.rest_mass)
 {
   decay_products.reserve(other.decay_products.size());
   for (const auto &particle : other.decay_products)
   {
-    decay_products.push_back(particle ? std::make_unique<Particle>(*particle) : nullptr);
+    decay_products.push_back(particle ? std::unique_ptr<Particle>(particle->clone()) : nullptr);
   }
 }
 
 // Move constructor
 Particle::Particle(Particle &&other) noexcept
-    : label(std::move(other.label)), charge(other.charge), spin(other.spin), four_momentum(std::move(other.four_momentum)), decay_products(std::move(other.decay_products)) {}
+    : type(std::move(other.type)), label(std::move(other.label)), charge(other.charge), spin(other.spin), is_virtual(other.is_virtual),
+      possible_decay_types(std::move(other.possible_decay_types)), current_decay_type(other.current_decay_type), decay_products(std::move(other.decay_products)),
+      four_momentum(std::move(other.four_momentum)), rest_mass(other.rest_mass) {}
 
 // Virtual destructor
 Particle::~Particle() {}
@@ -117,12 +129,16 @@ Particle &Particle::operator=(const Particle &other)
     spin = other.spin;
     rest_mass = other.rest_mass;
     type = other.type;
+    is_virtual = other.is_virtual;
+    possible_decay_types = other.possible_decay_types;
+    current_decay_type = other.current_decay_type;
     four_momentum = other.four_momentum ? std::make_unique<FourMomentum>(*other.four_momentum) : nullptr;
+    mark_kinematics_changed();
     decay_products.clear();
     decay_products.reserve(other.decay_products.size());
     for (const auto &particle : other.decay_products)
     {
-      decay_products.push_back(particle ? std::make_unique<Particle>(*particle) : nullptr);
+      decay_products.push_back(particle ? std::unique_ptr<Particle>(particle->clone()) : nullptr);
     }
   }
   return *this;
@@ -137,13 +153,102 @@ Particle &Particle::operator=(Particle &&other) noexcept
     charge = other.charge;
     spin = other.spin;
     rest_mass = other.rest_mass;
-    type = other.type;
+    type = std::move(other.type);
+    is_virtual = other.is_virtual;
+    possible_decay_types = std::move(other.possible_decay_types);
+    current_decay_type = other.current_decay_type;
     four_momentum = std::move(other.four_momentum);
     decay_products = std::move(other.decay_products);
+    mark_kinematics_changed();
   }
   return *this;
 }
 
+namespace
+{
+  std::atomic<std::uint64_t> kinematics_revision{0};
+
+  // Rest-frame four-momenta of a 2 or 3 body decay of a parent of mass parent_mass. Two products
+  // move back to back along x. With three, the first moves along +x and the other two share the
+  // rest of the momentum in the x-y plane.
+  void compute_rest_frame_decay_momenta(double parent_mass, const double *product_masses, size_t number_of_products, FourMomentum *momenta)
+  {
+    if (number_of_products == 2)
+    {
+      const double p = find_momentum_of_products(product_masses[0], product_masses[1], parent_mass);
+      momenta[0] = FourMomentum(std::sqrt(product_masses[0] * product_masses[0] + p * p), p, 0, 0);
+      momenta[1] = FourMomentum(std::sqrt(product_masses[1] * product_masses[1] + p * p), -p, 0, 0);
+    }
+    else
+    {
+      const std::array<double, 5> p = find_momentum_of_products_three_body(product_masses[0], product_masses[1], product_masses[2], parent_mass);
+      momenta[0] = FourMomentum(std::sqrt(product_masses[0] * product_masses[0] + p[0] * p[0]), p[0], 0, 0);
+      momenta[1] = FourMomentum(std::sqrt(product_masses[1] * product_masses[1] + p[1] * p[1] + p[2] * p[2]), p[1], p[2], 0);
+      momenta[2] = FourMomentum(std::sqrt(product_masses[2] * product_masses[2] + p[3] * p[3] + p[4] * p[4]), p[3], p[4], 0);
+    }
+  }
+
+  void check_number_of_products(size_t number_of_products)
+  {
+    if (number_of_products != 2 && number_of_products != 3)
+    {
+      throw std::invalid_argument("Error: Decay momenta can only be computed for 2 or 3 products.");
+    }
+  }
+
+  // Parents per chunk when a batch of decays is split between the scheduler's threads
+  constexpr size_t decays_per_chunk = 1024;
+
+  // Rest-frame momenta shared by every parent of a batch decay
+  void compute_batch_rest_frame_momenta(double parent_rest_mass, const DecaySpecies *products, size_t number_of_products, FourMomentum *rest_frame_momenta)
+  {
+    check_number_of_products(number_of_products);
+    double product_masses[3];
+    double total_product_mass = 0;
+    for (size_t product = 0; product < number_of_products; ++product)
+    {
+      product_masses[product] = products[product].rest_mass;
+      total_product_mass += products[product].rest_mass;
+    }
+    if (!(parent_rest_mass > total_product_mass))
+    {
+      throw std::invalid_argument("Error: Rest masses of decay particles exceeds decaying particle's.");
+    }
+    compute_rest_frame_decay_momenta(parent_rest_mass, product_masses, number_of_products, rest_frame_momenta);
+  }
+
+  // Boosts the rest-frame products by each of the parents in [first, last)
+  void boost_decay_momenta(const FourMomentum *parents, size_t first, size_t last, const FourMomentum *rest_frame_momenta,
+                           size_t number_of_products, FourMomentum *momenta)
+  {
+    for (size_t parent = first; parent < last; ++parent)
+    {
+      // The lab as seen from the parent's rest frame moves at -p / E
+      const long double energy = parents[parent].get_energy();
+      if (energy <= 0)
+      {
+        throw std::invalid_argument("Error: FourMomentum energy must be greater than 0 to have a rest frame.");
+      }
+      const Frame lab_frame(-parents[parent].get_Px() / energy, -parents[parent].get_Py() / energy, -parents[parent].get_Pz() / energy);
+      FourMomentum *parent_products = momenta + parent * number_of_products;
+      for (size_t product = 0; product < number_of_products; ++product)
+      {
+        parent_products[product] = lab_frame.transform(rest_frame_momenta[product]);
+      }
+    }
+  }
+}
+
+void Particle::mark_kinematics_changed()
+{
+  kinematics_revision.fetch_add(1, std::memory_order_relaxed);
+}
+
+std::uint64_t Particle::get_kinematics_revision()
+{
+  return kinematics_revision.load(std::memory_order_relaxed);
+}
+
 // Setters
 void Particle::set_label(const std::string &label)
 {
@@ -159,6 +264,7 @@ void Particle::set_four_momentum(std::unique_ptr<FourMomentum> four_momentum)
   else if (is_invariant_mass_valid(four_momentum->invariant_mass()))
   {
     this->four_momentum = std::move(four_momentum);
+    mark_kinematics_changed();
     if (!decay_products.empty())
     {
       auto_set_decay_products(std::move(decay_products), current_decay_type);
@@ -170,6 +276,19 @@ void Particle::set_four_momentum(std::unique_ptr<FourMomentum> four_momentum)
   }
 }
 
+void Particle::set_trusted_four_momentum(const FourMomentum &four_momentum)
+{
+  if (this->four_momentum)
+  {
+    *this->four_momentum = four_momentum;
+  }
+  else
+  {
+    this->four_momentum = std::make_unique<FourMomentum>(four_momentum);
+  }
+  mark_kinematics_changed();
+}
+
 void Particle::set_decay_products(std::vector<std::unique_ptr<Particle>> decay_products, DecayType decay_type)
 {
   if (!contains_decay_type(possible_decay_types, decay_type))
@@ -219,35 +338,11 @@ void Particle::auto_set_decay_products(std::vector<std::unique_ptr<Particle>> de
     // Arbitrarily choose, in rest frame, decaying particles move along x axis
     // E1^2 = P1^2 + M1^2, E2^2 = P2^2 + M2^2 (P1^2 = P2^2 = P^2, E1+E2=M_particle)
     // sqrt(P^2 + M1^2) + sqrt(P^2 + M2^2) = M_particle
-    double product1_rest_mass = decay_products[0]->get_rest_mass();
-    double product2_rest_mass = decay_products[1]->get_rest_mass();
-
-    // Calculate magnitude of momentum for decay products
-    double product_px_magnitude;
-    if (is_virtual)
-    {
-      product_px_magnitude = find_momentum_of_products(product1_rest_mass, product2_rest_mass, four_momentum->invariant_mass());
-    }
-    else
-    {
-      product_px_magnitude = find_momentum_of_products(product1_rest_mass, product2_rest_mass, rest_mass);
-    }
-    // double product_px_magnitude = find_momentum_of_products(product1_rest_mass, product2_rest_mass, four_momentum->get_energy());
-    double product1_energy = std::sqrt(product1_rest_mass * product1_rest_mass + product_px_magnitude * product_px_magnitude);
-    double product2_energy = std::sqrt(product2_rest_mass * product2_rest_mass + product_px_magnitude * product_px_magnitude);
-
-    // Have first particle move +ve along x axis
-    std::unique_ptr<FourMomentum> product1_fm = std::make_unique<FourMomentum>(product1_energy, product_px_magnitude, 0, 0);
-    // Have second particle move -ve along x axis
-    std::unique_ptr<FourMomentum> product2_fm = std::make_unique<FourMomentum>(product2_energy, -product_px_magnitude, 0, 0);
-
-    // Find velocity of decaying particle to perform lorentz boost
-    std::vector<long double> negative_decaying_particle_velocity = four_momentum->get_velocity_vector(false);
-
-    // Perform lorentz boost on rest-frame four momentums by performing lorentz boost by substracting
-    // the decaying particles velocity, back to lab frame
-    product1_fm->lorentz_boost(negative_decaying_particle_velocity);
-    product2_fm->lorentz_boost(negative_decaying_particle_velocity);
+    const DecaySpecies products[2] = {decay_products[0]->get_decay_species(), decay_products[1]->get_decay_species()};
+    FourMomentum momenta[2];
+    compute_decay_momenta(products, 2, momenta);
+    std::unique_ptr<FourMomentum> product1_fm = std::make_unique<FourMomentum>(momenta[0]);
+    std::unique_ptr<FourMomentum> product2_fm = std::make_unique<FourMomentum>(momenta[1]);
     // Give decay particles their four momenta
     decay_products[0]->set_four_momentum(std::move(product1_fm));
     decay_products[1]->set_four_momentum(std::move(product2_fm));
@@ -290,41 +385,12 @@ void Particle::auto_set_decay_products(std::vector<std::unique_ptr<Particle>> de
     // P2X + P3X = -P1X
     // P2Y = - P3Y
     // sqrt(P1X^2 + M1^2) + sqrt(P2X^2 + P2Y^2 + M2^2) + sqrt(P3X^2 + P3Y^2 + M3^2) = M_particle
-
-    double product1_rest_mass = decay_products[0]->get_rest_mass();
-    double product2_rest_mass = decay_products[1]->get_rest_mass();
-    double product3_rest_mass = decay_products[2]->get_rest_mass();
-
-    // Calculate magnitude of momentum for decay products
-    std::vector<double> momenta;
-    if (is_virtual)
-    {
-      momenta = find_momentum_of_products_three_body(product1_rest_mass, product2_rest_mass, product3_rest_mass, four_momentum->invariant_mass());
-    }
-    else
-    {
-      momenta = find_momentum_of_products_three_body(product1_rest_mass, product2_rest_mass, product3_rest_mass, rest_mass);
-    }
-    // Find momenta of decay particles in x-y plane: p1x, p2x, p2y, p3x, p3y
-    // Access the momentum components
-    double p1x = momenta[0];
-    double p2x = momenta[1];
-    double p2y = momenta[2];
-    double p3x = momenta[3];
-    double p3y = momenta[4];
-
-    double product1_energy = std::sqrt(product1_rest_mass * product1_rest_mass + p1x * p1x);
-    double product2_energy = std::sqrt(product2_rest_mass * product2_rest_mass + p2x * p2x + p2y * p2y);
-    double product3_energy = std::sqrt(product3_rest_mass * product3_rest_mass + p3x * p3x + p3y * p3y);
-
-    std::unique_ptr<FourMomentum> product1_fm = std::make_unique<FourMomentum>(product1_energy, p1x, 0, 0);
-    std::unique_ptr<FourMomentum> product2_fm = std::make_unique<FourMomentum>(product2_energy, p2x, p2y, 0);
-    std::unique_ptr<FourMomentum> product3_fm = std::make_unique<FourMomentum>(product3_energy, p3x, p3y, 0);
-
-    std::vector<long double> negative_decaying_particle_velocity = four_momentum->get_velocity_vector(false);
-    product1_fm->lorentz_boost(negative_decaying_particle_velocity);
-    product2_fm->lorentz_boost(negative_decaying_particle_velocity);
-    product3_fm->lorentz_boost(negative_decaying_particle_velocity);
+    const DecaySpecies products[3] = {decay_products[0]->get_decay_species(), decay_products[1]->get_decay_species(), decay_products[2]->get_decay_species()};
+    FourMomentum momenta[3];
+    compute_decay_momenta(products, 3, momenta);
+    std::unique_ptr<FourMomentum> product1_fm = std::make_unique<FourMomentum>(momenta[0]);
+    std::unique_ptr<FourMomentum> product2_fm = std::make_unique<FourMomentum>(momenta[1]);
+    std::unique_ptr<FourMomentum> product3_fm = std::make_unique<FourMomentum>(momenta[2]);
 
     decay_products[0]->set_four_momentum(std::move(product1_fm));
     decay_products[1]->set_four_momentum(std::move(product2_fm));
@@ -395,8 +461,8 @@ void Particle::auto_set_decay_products_virtual(std::vector<std::unique_ptr<Parti
     double decaying_particle_py = four_momentum->get_Py();
     double decaying_particle_pz = four_momentum->get_Pz();
 
-    // Split the energy and momentum equally between the two decay products
-    double product1_energy = decaying_particle_energy / 2;
+    // Split the energy and momentum equally between the three decay products
+    double product1_energy = decaying_particle_energy / 3;
     double product1_px = decaying_particle_px / 3;
     double product1_py = decaying_particle_py / 3;
     double product1_pz = decaying_particle_pz / 3;
@@ -435,6 +501,60 @@ void Particle::auto_set_decay_products_virtual(std::vector<std::unique_ptr<Parti
   }
 }
 
+void Particle::compute_decay_momenta(const DecaySpecies *products, size_t number_of_products, FourMomentum *momenta) const
+{
+  check_number_of_products(number_of_products);
+  double product_masses[3];
+  double total_product_mass = 0;
+  bool all_virtual = true;
+  for (size_t product = 0; product < number_of_products; ++product)
+  {
+    product_masses[product] = products[product].rest_mass;
+    total_product_mass += products[product].rest_mass;
+    all_virtual = all_virtual && products[product].is_virtual;
+  }
+
+  // Work in decaying particle's rest frame
+  // Only energy in system is decaying particle's rest mass
+  if (!(rest_mass > total_product_mass))
+  {
+    if (!all_virtual)
+    {
+      throw std::invalid_argument("Error: Rest masses of decay particles exceeds decaying particle's. Decay products must be virtual.");
+    }
+    // Virtual products share the four momentum equally
+    const long double share = 1.0L / number_of_products;
+    for (size_t product = 0; product < number_of_products; ++product)
+    {
+      momenta[product] = FourMomentum(four_momentum->get_energy() * share, four_momentum->get_Px() * share,
+                                      four_momentum->get_Py() * share, four_momentum->get_Pz() * share);
+    }
+    return;
+  }
+
+  compute_rest_frame_decay_momenta(is_virtual ? four_momentum->invariant_mass() : rest_mass, product_masses, number_of_products, momenta);
+  // Rest-frame four momenta are boosted back to the lab frame with the inverse of the decaying
+  // particle's rest frame, built once for all products
+  to_frame(momenta, number_of_products, parent_rest_frame(*this).inverse());
+}
+
+void compute_decay_momenta(const FourMomentum *parents, size_t count, double parent_rest_mass,
+                           const DecaySpecies *products, size_t number_of_products, FourMomentum *momenta)
+{
+  FourMomentum rest_frame_momenta[3];
+  compute_batch_rest_frame_momenta(parent_rest_mass, products, number_of_products, rest_frame_momenta);
+  boost_decay_momenta(parents, 0, count, rest_frame_momenta, number_of_products, momenta);
+}
+
+void compute_decay_momenta(const FourMomentum *parents, size_t count, double parent_rest_mass,
+                           const DecaySpecies *products, size_t number_of_products, FourMomentum *momenta, TaskScheduler &scheduler)
+{
+  FourMomentum rest_frame_momenta[3];
+  compute_batch_rest_frame_momenta(parent_rest_mass, products, number_of_products, rest_frame_momenta);
+  scheduler.parallel_for(count, decays_per_chunk, [parents, &rest_frame_momenta, number_of_products, momenta](size_t first, size_t last)
+                         { boost_decay_momenta(parents, first, last, rest_frame_momenta, number_of_products, momenta); });
+}
+
 void Particle::set_is_virtual(bool is_virtual)
 {
   this->is_virtual = is_virtual;
@@ -466,18 +586,6 @@ std::string Particle::get_type() const
   return type;
 }
 
-const FourMomentum &Particle::get_four_momentum() const
-{
-  if (four_momentum->get_energy() == 0 && four_momentum->get_Px() == 0 && four_momentum->get_Py() == 0 && four_momentum->get_Pz() == 0)
-  {
-    throw std::runtime_error("FourMomentum has not been intitialised.");
-  }
-  else
-  {
-    return *four_momentum;
-  }
-}
-
 const std::vector<std::unique_ptr<Particle>> &Particle::get_decay_products() const
 {
   return decay_products;
@@ -513,11 +621,13 @@ double dot_product_four_momentum(const Particle &a, const Particle &b)
 void Particle::lorentz_boost(long double v_x, long double v_y, long double v_z)
 {
   four_momentum->lorentz_boost(v_x, v_y, v_z);
+  mark_kinematics_changed();
 }
 
-void Particle::lorentz_boost(std::vector<long double> v_xyz)
+void Particle::lorentz_boost(const std::vector<long double> &v_xyz)
 {
   four_momentum->lorentz_boost(v_xyz);
+  mark_kinematics_changed();
 }
 
 // Virtual print function
@@ -547,6 +657,12 @@ void Particle::print() const
             << "[" << *four_momentum << "]" << std::endl;
 }
 
+// Virtual copy function
+Particle *Particle::clone() const
+{
+  return new Particle(*this);
+}
+
 // Implement the validity check method
 bool Particle::is_invariant_mass_valid(double invariant_mass) const
 {
@@ -582,7 +698,7 @@ bool Particle::validate_decay_products(const std::vector<std::unique_ptr<Particl
   int top_count = 0;
   int bottom_count = 0;
 
-  std::vector<Colour> colour_charges;
+  PackedColour product_colour = 0;
 
   for (const auto &product : decay_products)
   {
@@ -590,10 +706,7 @@ bool Particle::validate_decay_products(const std::vector<std::unique_ptr<Particl
     product_total_charge = product_total_charge + product->get_charge();
     product_total_lepton_number = product_total_lepton_number + product->get_lepton_number();
     product_total_baryon_number = product_total_baryon_number + product->get_baryon_number();
-    if (product->get_colour_charge() != Colour::None)
-    {
-      colour_charges.push_back(product->get_colour_charge());
-    }
+    product_colour = ColourAlgebra::combine(product_colour, ColourAlgebra::pack(product->get_colour_charge()));
     // Check lepton flavors
     if (dynamic_cast<const Electron *>(product.get()) || (dynamic_cast<const Neutrino *>(product.get()) && dynamic_cast<const Neutrino *>(product.get())->get_flavour() == "electron"))
     {
@@ -705,7 +818,7 @@ bool Particle::validate_decay_products(const std::vector<std::unique_ptr<Particl
   bool charge_conserved = (std::abs(charge - product_total_charge) < 0.01);
   bool lepton_number_conserved = (this->get_lepton_number() == product_total_lepton_number);
   bool baryon_number_conserved = (this->get_baryon_number() == product_total_baryon_number);
-  bool colour_charge_conserved = is_colour_neutral(colour_charges);
+  bool colour_charge_conserved = ColourAlgebra::is_neutral(product_colour);
 
   // Check lepton flavor conservation
   bool lepton_flavor_conserved = true;
@@ -757,3 +870,33 @@ bool Particle::validate_decay_products(const std::vector<std::unique_ptr<Particl
     return (four_momentum_conserved && charge_conserved && lepton_number_conserved && baryon_number_conserved && lepton_flavor_conserved && quark_flavor_conserved && colour_charge_conserved);
   }
 }
+
+// Batch mass-shell check. Every entry goes through the same arithmetic with no early exit, so the
+// loop has no branches and the compiler can vectorise it.
+size_t validate_mass_shell(const double *energy, const double *px, const double *py, const double *pz,
+                           const double *rest_mass, size_t count, std::uint8_t *valid, double tolerance)
+{
+  size_t number_invalid = 0;
+  for (size_t i = 0; i < count; ++i)
+  {
+    const double mass_squared = energy[i] * energy[i] - (px[i] * px[i] + py[i] * py[i] + pz[i] * pz[i]);
+    const double invariant_mass = std::sqrt(std::max(0.0, mass_squared));
+    const bool is_valid = (energy[i] > 0) & (std::abs(invariant_mass - rest_mass[i]) <= tolerance);
+    valid[i] = is_valid;
+    number_invalid += !is_valid;
+  }
+  return number_invalid;
+}
+
+size_t validate_mass_shell(const std::vector<double> &energy, const std::vector<double> &px, const std::vector<double> &py,
+                           const std::vector<double> &pz, const std::vector<double> &rest_mass, std::vector<std::uint8_t> &valid,
+                           double tolerance)
+{
+  const size_t count = energy.size();
+  if (px.size() != count || py.size() != count || pz.size() != count || rest_mass.size() != count)
+  {
+    throw std::invalid_argument("Error: Four-momentum and rest mass columns must have the same length.");
+  }
+  valid.resize(count);
+  return validate_mass_shell(energy.data(), px.data(), py.data(), pz.data(), rest_mass.data(), count, valid.data(), tolerance);
+}
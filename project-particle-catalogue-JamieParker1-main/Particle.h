@@ -1,6 +1,7 @@
 #ifndef PARTICLE_H
 #define PARTICLE_H
 
+#include <cstdint>
 #include <memory>
 #include <vector>
 #include <string>
@@ -56,6 +57,40 @@ enum class Colour
   None
 };
 
+// Enum class for the lepton or quark flavour a particle carries, read through get_flavour_tag so
+// quantum numbers can be packed without dynamic_cast or flavour string compares
+enum class FlavourTag
+{
+  None,
+  Electron,
+  Muon,
+  Tau,
+  Up,
+  Down,
+  Charm,
+  Strange,
+  Top,
+  Bottom
+};
+
+// Tag selecting the trusted constructors. They take a four-momentum that was already validated
+// upstream, e.g. by validate_mass_shell over a whole batch, and skip every per-particle check.
+struct Trusted
+{
+  explicit Trusted() = default;
+};
+constexpr Trusted trusted{};
+
+// Species of a decay product, all the decay kinematics need of it. Lets products be described
+// without constructing particles, e.g. decay_species<Muon>().
+struct DecaySpecies
+{
+  double rest_mass;
+  bool is_virtual = false;
+};
+
+class TaskScheduler;
+
 // Base Particle class
 class Particle
 {
@@ -67,10 +102,8 @@ private:
   bool is_virtual = false; // If particle is virtual - don't have to make checks on invariant mass and rest mass
 
   std::vector<DecayType> possible_decay_types; // Vector of decay types
-  DecayType current_decay_type; // Current decay type of particle if one has been set
+  DecayType current_decay_type = DecayType::None; // Current decay type of particle if one has been set
   std::vector<std::unique_ptr<Particle>> decay_products; // Vector of decay products
-  // Validates decay products conserve relevant quantities
-  bool validate_decay_products(const std::vector<std::unique_ptr<Particle>> &decay_products, DecayType decay_type) const; 
   // Sets decay products calculating four momentum for virtual particles
   void auto_set_decay_products_virtual(std::vector<std::unique_ptr<Particle>> decay_products, DecayType decay_type);
 
@@ -83,9 +116,13 @@ protected:
   Particle(std::string type, double charge, double spin, double rest_mass, std::unique_ptr<FourMomentum> four_momentum, std::vector<DecayType> possible_decay_types = {DecayType::None});
   // Constructor with label
   Particle(std::string type, const std::string &label, double charge, double spin, double rest_mass, std::unique_ptr<FourMomentum> fourMomentum, std::vector<DecayType> possible_decay_types = {DecayType::None});
+  // Trusted constructor without label, taking the four-momentum without checks
+  Particle(Trusted, std::string type, double charge, double spin, double rest_mass, std::unique_ptr<FourMomentum> four_momentum, std::vector<DecayType> possible_decay_types = {DecayType::None});
   
   // Function to check if invariant mass of four momentum matches rest mass
   bool is_invariant_mass_valid(double invariant_mass) const;
+  // Advances the kinematics revision, called whenever an existing particle's four momentum changes
+  static void mark_kinematics_changed();
 
 public:
   // Default constructor
@@ -117,6 +154,21 @@ public:
   void auto_set_decay_products(std::vector<std::unique_ptr<Particle>> decay_products, DecayType decay_type);
   void set_is_virtual(bool is_virtual);
   virtual void set_four_momentum(std::unique_ptr<FourMomentum> fourMomentum);
+  // Trusted setter for data validated upstream, e.g. with validate_mass_shell. Skips every check and
+  // reuses the particle's existing four-momentum allocation. Decay products are left unchanged.
+  virtual void set_trusted_four_momentum(const FourMomentum &four_momentum);
+
+  // Computes the lab-frame four-momenta of a 2 or 3 body decay into products of the given species and
+  // writes them to momenta, with the same kinematics as auto_set_decay_products. No product particles
+  // are created, so nothing is allocated. Throws for other numbers of products, or if the products
+  // are heavier than this particle and not all virtual, in which case the four-momentum is shared equally.
+  void compute_decay_momenta(const DecaySpecies *products, size_t number_of_products, FourMomentum *momenta) const;
+  // Validates decay products conserve relevant quantities, used by set_decay_products and matched by DecayBatch
+  bool validate_decay_products(const std::vector<std::unique_ptr<Particle>> &decay_products, DecayType decay_type) const;
+
+  // Counter shared by all particles, advanced whenever an existing particle's four momentum changes
+  // through a setter, a Lorentz boost or assignment. Caches of kinematics compare it to detect changes.
+  static std::uint64_t get_kinematics_revision();
 
   // Getters
   std::string get_label() const;
@@ -124,15 +176,17 @@ public:
   double get_spin() const;
   double get_rest_mass() const;
   std::string get_type() const;
-  const FourMomentum &get_four_momentum() const;
+  const FourMomentum &get_four_momentum() const { return *four_momentum; }
   const std::vector<std::unique_ptr<Particle>> &get_decay_products() const;
   bool get_is_virtual();
+  DecaySpecies get_decay_species() const { return DecaySpecies{rest_mass, is_virtual}; }
 
   // Virtual methods
   virtual int get_lepton_number() const { return 0; }
   virtual double get_baryon_number() const { return 0; }
   virtual Colour get_colour_charge() const { return Colour::None; }
   virtual std::string get_flavour() const { return "none"; }
+  virtual FlavourTag get_flavour_tag() const { return FlavourTag::None; }
 
   // Friend functions
   friend FourMomentum sum_four_momentum(const Particle &a, const Particle &b);
@@ -140,10 +194,43 @@ public:
 
   // Lorentz boost functions
   void lorentz_boost(long double v_x, long double v_y, long double v_z);
-  void lorentz_boost(std::vector<long double> v_xyz);
+  void lorentz_boost(const std::vector<long double> &v_xyz);
 
   // Virtual print function
   virtual void print() const;
+
+  // Virtual copy function, returning a new heap copy with the same most derived type
+  virtual Particle *clone() const;
 };
 
+// Species of a particle class, from a default-constructed instance made on the first call
+template <typename T>
+const DecaySpecies &decay_species()
+{
+  static const DecaySpecies species = T().get_decay_species();
+  return species;
+}
+
+// Decays count parents of one rest mass into the same 2 or 3 products. The rest-frame momenta are
+// solved once and boosted by each parent, and the products of parent i are written to
+// momenta[i * number_of_products] onwards. Throws if the products are heavier than the parent or a
+// parent's energy is not above 0.
+void compute_decay_momenta(const FourMomentum *parents, size_t count, double parent_rest_mass,
+                           const DecaySpecies *products, size_t number_of_products, FourMomentum *momenta);
+// The same on a task scheduler, with the parents split into chunks between its threads. No random
+// numbers are drawn, so the momenta are identical to the serial version for any number of threads.
+void compute_decay_momenta(const FourMomentum *parents, size_t count, double parent_rest_mass,
+                           const DecaySpecies *products, size_t number_of_products, FourMomentum *momenta, TaskScheduler &scheduler);
+
+// Checks a batch of four-momentum columns against their rest masses in one branch-free pass, with
+// the same rules as the validating constructors: energy above 0 and invariant mass within tolerance
+// of the rest mass. Sets valid[i] to 1 or 0 and returns the number of invalid entries. The pass runs
+// in double precision, so for energies many orders above the rest mass it can disagree with the
+// long double check of a single particle by rounding.
+size_t validate_mass_shell(const double *energy, const double *px, const double *py, const double *pz,
+                           const double *rest_mass, size_t count, std::uint8_t *valid, double tolerance = 1e-5);
+size_t validate_mass_shell(const std::vector<double> &energy, const std::vector<double> &px, const std::vector<double> &py,
+                           const std::vector<double> &pz, const std::vector<double> &rest_mass, std::vector<std::uint8_t> &valid,
+                           double tolerance = 1e-5);
+
 #endif // PARTICLE_H
\ No newline at end of file
@@ -3,6 +3,9 @@
 #define PARTICLE_CATALOGUE_H
 
 #include "Particle.h"
+#include "Frame.h"
+#include "TaskScheduler.h"
+#include <cstdint>
 #include <vector>
 #include <iostream>
 #include <map>
@@ -11,6 +14,12 @@
 #include <set>
 #include <algorithm>
 #include <numeric>
+#include <memory>
+#include <stdexcept>
+#include <string>
+
+template <typename T>
+class ParticleCatalogueView;
 
 template <typename T>
 class ParticleCatalogue
@@ -18,11 +27,59 @@ class ParticleCatalogue
 private:
   std::vector<T *> particles;
   std::set<T *> unique_particles;
+  std::uint64_t revision = 0; // Advanced whenever the particles or their order change
+
+  friend class ParticleCatalogueView<T>;
 
 public:
   // Default constructor. Initializes a new instance of the ParticleCatalogue class with no particles.
   ParticleCatalogue() = default;
 
+  // Copy constructor. The catalogue owns its particles, so every particle is deep copied with its derived type.
+  ParticleCatalogue(const ParticleCatalogue &other)
+  {
+    for (const auto &particle : other.particles)
+    {
+      add_particle(static_cast<T *>(particle->clone()));
+    }
+  }
+
+  // Move constructor. Takes ownership of the other catalogue's particles.
+  ParticleCatalogue(ParticleCatalogue &&other) noexcept
+      : particles(std::move(other.particles)), unique_particles(std::move(other.unique_particles))
+  {
+    other.particles.clear();
+    other.unique_particles.clear();
+    ++other.revision;
+  }
+
+  // Copy assignment operator
+  ParticleCatalogue &operator=(const ParticleCatalogue &other)
+  {
+    if (this != &other)
+    {
+      ParticleCatalogue copy(other);
+      *this = std::move(copy);
+    }
+    return *this;
+  }
+
+  // Move assignment operator
+  ParticleCatalogue &operator=(ParticleCatalogue &&other) noexcept
+  {
+    if (this != &other)
+    {
+      clear_all_particles();
+      particles = std::move(other.particles);
+      unique_particles = std::move(other.unique_particles);
+      other.particles.clear();
+      other.unique_particles.clear();
+      ++revision;
+      ++other.revision;
+    }
+    return *this;
+  }
+
   // Destructor. Frees memory for all particle pointers managed by the catalogue and clears the container of particles and unique particles.
   ~ParticleCatalogue()
   {
@@ -42,6 +99,7 @@ public:
     {
       particles.push_back(particle);
       unique_particles.insert(particle); // Add to the set of unique pointers
+      ++revision;
     }
     else
     {
@@ -62,6 +120,13 @@ public:
     return particles.size();
   }
 
+  // Returns a counter advanced whenever particles are added, removed or reordered. Together with
+  // Particle::get_kinematics_revision it tells caches built from the catalogue when to rebuild.
+  std::uint64_t get_revision() const
+  {
+    return revision;
+  }
+
   // Returns a map where keys are particle type names and values are the counts of particles of each type.
   std::map<std::string, int> get_particle_count_by_type() const
   {
@@ -90,6 +155,21 @@ public:
                            { return sum + particle->get_four_momentum(); });
   }
 
+  // Returns the frame in which the total momentum of the catalogue is zero
+  Frame get_centre_of_mass_frame() const
+  {
+    return Frame::rest_frame(sum_four_momenta());
+  }
+
+  // Boosts every particle in the catalogue, and by default their decay trees, into a frame with one precomputed matrix
+  void to_frame(const Frame &frame, bool include_decay_products = true)
+  {
+    for (T *particle : particles)
+    {
+      ::to_frame(*particle, frame, include_decay_products);
+    }
+  }
+
   // Returns a vector containing pointers to all particles in the catalogue that can be dynamically cast to a specified subtype.
   template <typename SubType>
   std::vector<SubType *> get_vector_of_subtype() const
@@ -106,34 +186,52 @@ public:
     return sub_container;
   }
 
-  // Returns a new ParticleCatalogue that contains all particles of a specified subtype.
-  template <typename SubType>
-  ParticleCatalogue<SubType> get_sub_container() const
+  // Returns a non-owning view of every particle in the catalogue
+  ParticleCatalogueView<T> get_view() const
   {
-    ParticleCatalogue<SubType> sub_container;
-    for (const auto &particle : particles)
+    auto indices = std::make_shared<std::vector<size_t>>(particles.size());
+    std::iota(indices->begin(), indices->end(), 0);
+    return ParticleCatalogueView<T>(*this, std::move(indices));
+  }
+
+  // Returns a non-owning view of the particles that satisfy a predicate
+  template <typename Predicate>
+  ParticleCatalogueView<T> filter(Predicate predicate) const
+  {
+    auto indices = std::make_shared<std::vector<size_t>>();
+    for (size_t index = 0; index < particles.size(); ++index)
     {
-      if (const SubType *casted = dynamic_cast<const SubType *>(particle))
+      if (predicate(static_cast<const T *>(particles[index])))
       {
-        sub_container.add_particle(const_cast<SubType *>(casted));
+        indices->push_back(index);
       }
     }
+    return ParticleCatalogueView<T>(*this, std::move(indices));
+  }
+
+  // Returns a non-owning view of the particles that can be dynamically cast to a specified subtype
+  template <typename SubType>
+  ParticleCatalogueView<T> get_view_of_type() const
+  {
+    return filter([](const T *particle)
+                  { return dynamic_cast<const SubType *>(particle) != nullptr; });
+  }
+
+  // Returns a new ParticleCatalogue owning copies of all particles of a specified subtype.
+  template <typename SubType>
+  ParticleCatalogue<SubType> get_sub_container() const
+  {
+    ParticleCatalogue<SubType> sub_container;
+    get_view_of_type<SubType>().for_each([&sub_container](const T *particle)
+                                         { sub_container.add_particle(dynamic_cast<SubType *>(particle->clone())); });
     return sub_container;
   }
 
-  // Similar to get_sub_container<SubType>(), but returns a new ParticleCatalogue containing particles of the same type as the specified subtype.
+  // Similar to get_sub_container<SubType>(), but returns a new ParticleCatalogue of the same type owning copies of the particles of the specified subtype.
   template <typename SubType>
   ParticleCatalogue<T> get_sub_container_of_same_type() const
   {
-    ParticleCatalogue<T> sub_container;
-    for (const auto &particle : particles)
-    {
-      if (const SubType *casted = dynamic_cast<const SubType *>(particle))
-      {
-        sub_container.add_particle(const_cast<SubType *>(casted));
-      }
-    }
-    return sub_container;
+    return get_view_of_type<SubType>().materialise();
   }
 
   // Prints information for all particles in the catalogue that are of a specified type or a derived type, using dynamic casting.
@@ -192,11 +290,13 @@ public:
         }
         return false; }),
                     particles.end());
+    ++revision;
   }
   void remove_particle(const T *particle)
   {
     particles.erase(std::remove(particles.begin(), particles.end(), particle), particles.end());
     unique_particles.erase(const_cast<T *>(particle));
+    ++revision;
   }
   void remove_particle(size_t index)
   {
@@ -204,6 +304,7 @@ public:
     {
       unique_particles.erase(particles[index]);
       particles.erase(particles.begin() + index);
+      ++revision;
     }
   }
   template <typename SubType>
@@ -217,6 +318,7 @@ public:
       delete *ptr;
     }
     particles.erase(it, particles.end());
+    ++revision;
   }
   // Clears the catalogue of all particles, properly freeing memory and clearing the internal containers
   void clear_all_particles()
@@ -227,6 +329,7 @@ public:
     }
     particles.clear();
     unique_particles.clear();
+    ++revision;
   }
   
   // Sorts the particles in the catalogue according to a specified comparator function. If reverse is true, the sort is in descending order.
@@ -241,6 +344,7 @@ public:
     {
       std::sort(particles.begin(), particles.end(), compare);
     }
+    ++revision;
   }
 
   // Applies a function to all particles or to particles with specified labels.
@@ -281,4 +385,133 @@ public:
   }
 };
 
+// Non-owning, filtered view of a ParticleCatalogue, stored as a list of indices into the parent's
+// particles. Views are cheap to create and copy (copies share the index list), can be filtered
+// further, and only copy particles when materialised. A view is invalidated by any change to the
+// parent catalogue's particles, including moving them to another catalogue: using it afterwards
+// throws. A view must not outlive its parent catalogue.
+template <typename T>
+class ParticleCatalogueView
+{
+private:
+  const ParticleCatalogue<T> *parent;                 // Not owned
+  std::uint64_t revision;                             // Parent's revision when the view was made
+  std::shared_ptr<const std::vector<size_t>> indices; // Positions in the parent, in parent order
+
+  // Returns the parent's particles, throwing if they changed since the view was made
+  const std::vector<T *> &get_particles() const
+  {
+    if (parent->revision != revision)
+    {
+      throw std::logic_error("Error: Catalogue view used after its parent catalogue changed.");
+    }
+    return parent->particles;
+  }
+
+public:
+  // Constructor, used by ParticleCatalogue to create views over its particles
+  ParticleCatalogueView(const ParticleCatalogue<T> &parent, std::shared_ptr<const std::vector<size_t>> indices)
+      : parent(&parent), revision(parent.revision), indices(std::move(indices)) {}
+
+  // Returns the number of particles in the view
+  size_t get_number_of_particles() const
+  {
+    return indices->size();
+  }
+
+  // Returns the particle at a position in the view
+  T *operator[](size_t position) const
+  {
+    return get_particles()[(*indices)[position]];
+  }
+
+  // Returns the positions in the parent catalogue of the particles in the view
+  const std::vector<size_t> &get_indices() const
+  {
+    return *indices;
+  }
+
+  // Returns a new view of the particles in this view that satisfy a predicate
+  template <typename Predicate>
+  ParticleCatalogueView filter(Predicate predicate) const
+  {
+    const std::vector<T *> &particles = get_particles();
+    auto filtered = std::make_shared<std::vector<size_t>>();
+    for (size_t index : *indices)
+    {
+      if (predicate(static_cast<const T *>(particles[index])))
+      {
+        filtered->push_back(index);
+      }
+    }
+    return ParticleCatalogueView(*parent, std::move(filtered));
+  }
+
+  // Returns a new view of the particles in this view that can be dynamically cast to a specified subtype
+  template <typename SubType>
+  ParticleCatalogueView filter_by_type() const
+  {
+    return filter([](const T *particle)
+                  { return dynamic_cast<const SubType *>(particle) != nullptr; });
+  }
+
+  // Returns a new view of the particles in this view that are of the exact specified type
+  template <typename SubType>
+  ParticleCatalogueView filter_by_exact_type() const
+  {
+    return filter([](const T *particle)
+                  { return typeid(*particle) == typeid(SubType); });
+  }
+
+  // Applies a function to every particle in the view
+  template <typename Function>
+  void for_each(Function function) const
+  {
+    const std::vector<T *> &particles = get_particles();
+    for (size_t index : *indices)
+    {
+      function(particles[index]);
+    }
+  }
+
+  // Applies a function to every particle in the view, in chunks of grain particles on a task
+  // scheduler (0 for its default grain). Particles are visited in no particular order.
+  template <typename Function>
+  void for_each_parallel(Function function, size_t grain = 0, TaskScheduler &scheduler = TaskScheduler::get_default()) const
+  {
+    const std::vector<T *> &particles = get_particles();
+    scheduler.parallel_for(indices->size(), grain, [this, &particles, &function](size_t first, size_t last)
+                           {
+                             for (size_t position = first; position < last; ++position)
+                             {
+                               function(particles[(*indices)[position]]);
+                             } });
+  }
+
+  // Prints information for every particle in the view
+  void print_all() const
+  {
+    for_each([](const T *particle)
+             { particle->print(); });
+  }
+
+  // Calculates the total four-momentum of all particles in the view
+  FourMomentum sum_four_momenta() const
+  {
+    FourMomentum sum;
+    for_each([&sum](const T *particle)
+             { sum = sum + particle->get_four_momentum(); });
+    return sum;
+  }
+
+  // Returns a new ParticleCatalogue owning copies of the particles in the view
+  ParticleCatalogue<T> materialise() const
+  {
+    ParticleCatalogue<T> catalogue;
+    for_each([&catalogue](const T *particle)
+             { catalogue.add_particle(static_cast<T *>(particle->clone())); });
+    return catalogue;
+  }
+};
+
 #endif
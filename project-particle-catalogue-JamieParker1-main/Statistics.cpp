@@ -0,0 +1,405 @@
+#include "Statistics.h"
+
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+
+// Constructor
+Histogram::Histogram(size_t number_of_bins, double low, double high, Binning binning)
+    : binning(binning), low(low), high(high), counts(number_of_bins, 0)
+{
+  if (number_of_bins == 0)
+  {
+    throw std::invalid_argument("Error: Histogram must have at least one bin.");
+  }
+  if (!(low < high))
+  {
+    throw std::invalid_argument("Error: Histogram low edge must be below its high edge.");
+  }
+  if (binning == Binning::logarithmic && !(low > 0))
+  {
+    throw std::invalid_argument("Error: Logarithmic histogram low edge must be greater than 0.");
+  }
+  scaled_low = binning == Binning::logarithmic ? std::log(low) : low;
+  const double scaled_high = binning == Binning::logarithmic ? std::log(high) : high;
+  bins_per_unit = number_of_bins / (scaled_high - scaled_low);
+}
+
+void Histogram::fill(double value)
+{
+  if (!(value >= low))
+  {
+    ++underflow;
+    return;
+  }
+  if (value >= high)
+  {
+    ++overflow;
+    return;
+  }
+  const double scaled = binning == Binning::logarithmic ? std::log(value) : value;
+  // Rounding can put a value just below high one past the last bin
+  const size_t bin = std::min(static_cast<size_t>((scaled - scaled_low) * bins_per_unit), counts.size() - 1);
+  ++counts[bin];
+}
+
+bool Histogram::has_same_binning(const Histogram &other) const
+{
+  return binning == other.binning && low == other.low && high == other.high && counts.size() == other.counts.size();
+}
+
+void Histogram::merge(const Histogram &other)
+{
+  if (!has_same_binning(other))
+  {
+    throw std::invalid_argument("Error: Only histograms with the same binning can be merged.");
+  }
+  for (size_t bin = 0; bin < counts.size(); ++bin)
+  {
+    counts[bin] += other.counts[bin];
+  }
+  underflow += other.underflow;
+  overflow += other.overflow;
+}
+
+double Histogram::get_bin_low_edge(size_t bin) const
+{
+  if (bin >= counts.size())
+  {
+    return high;
+  }
+  const double scaled = scaled_low + bin / bins_per_unit;
+  return binning == Binning::logarithmic ? std::exp(scaled) : scaled;
+}
+
+std::uint64_t Histogram::get_total() const
+{
+  std::uint64_t total = underflow + overflow;
+  for (std::uint64_t count : counts)
+  {
+    total += count;
+  }
+  return total;
+}
+
+void RunningStatistics::add(double value)
+{
+  ++count;
+  if (count == 1)
+  {
+    minimum = value;
+    maximum = value;
+  }
+  else
+  {
+    minimum = std::min(minimum, value);
+    maximum = std::max(maximum, value);
+  }
+  const double delta = value - mean;
+  mean += delta / count;
+  sum_of_squared_deviations += delta * (value - mean);
+}
+
+void RunningStatistics::merge(const RunningStatistics &other)
+{
+  if (other.count == 0)
+  {
+    return;
+  }
+  if (count == 0)
+  {
+    *this = other;
+    return;
+  }
+  const double total = static_cast<double>(count + other.count);
+  const double delta = other.mean - mean;
+  mean += delta * (other.count / total);
+  sum_of_squared_deviations += other.sum_of_squared_deviations + delta * delta * (count / total) * other.count;
+  count += other.count;
+  minimum = std::min(minimum, other.minimum);
+  maximum = std::max(maximum, other.maximum);
+}
+
+double RunningStatistics::get_variance() const
+{
+  return count < 2 ? 0 : sum_of_squared_deviations / (count - 1);
+}
+
+double RunningStatistics::get_standard_deviation() const
+{
+  return std::sqrt(get_variance());
+}
+
+void QuantileSketch::Store::add(int index, std::uint64_t count)
+{
+  if (counts.empty())
+  {
+    offset = index;
+    counts.push_back(count);
+    return;
+  }
+  if (index < offset)
+  {
+    counts.insert(counts.begin(), offset - index, 0);
+    offset = index;
+  }
+  else if (index - offset >= static_cast<int>(counts.size()))
+  {
+    counts.resize(index - offset + 1, 0);
+  }
+  counts[index - offset] += count;
+}
+
+void QuantileSketch::Store::merge(const Store &other)
+{
+  if (other.counts.empty())
+  {
+    return;
+  }
+  // Grow once to cover both ranges before adding
+  add(other.offset, 0);
+  add(other.offset + static_cast<int>(other.counts.size()) - 1, 0);
+  for (size_t i = 0; i < other.counts.size(); ++i)
+  {
+    counts[other.offset - offset + i] += other.counts[i];
+  }
+}
+
+// Constructor
+QuantileSketch::QuantileSketch(double relative_accuracy) : relative_accuracy(relative_accuracy)
+{
+  if (!(relative_accuracy > 0 && relative_accuracy < 1))
+  {
+    throw std::invalid_argument("Error: Quantile sketch relative accuracy must be between 0 and 1.");
+  }
+  gamma = (1 + relative_accuracy) / (1 - relative_accuracy);
+  inverse_log_gamma = 1 / std::log(gamma);
+}
+
+// Bucket i holds magnitudes in (gamma^(i-1), gamma^i]
+int QuantileSketch::get_index(double magnitude) const
+{
+  return static_cast<int>(std::ceil(std::log(std::min(magnitude, std::numeric_limits<double>::max())) * inverse_log_gamma));
+}
+
+// Value within relative_accuracy of everything in bucket i
+double QuantileSketch::get_value(int index) const
+{
+  return 2 * std::pow(gamma, index) / (gamma + 1);
+}
+
+void QuantileSketch::add(double value)
+{
+  if (std::isnan(value))
+  {
+    return;
+  }
+  minimum = count == 0 ? value : std::min(minimum, value);
+  maximum = count == 0 ? value : std::max(maximum, value);
+  ++count;
+  if (std::abs(value) < std::numeric_limits<double>::min())
+  {
+    ++zero_count;
+  }
+  else if (value > 0)
+  {
+    positive.add(get_index(value), 1);
+  }
+  else
+  {
+    negative.add(get_index(-value), 1);
+  }
+}
+
+void QuantileSketch::merge(const QuantileSketch &other)
+{
+  if (relative_accuracy != other.relative_accuracy)
+  {
+    throw std::invalid_argument("Error: Only quantile sketches with the same accuracy can be merged.");
+  }
+  if (other.count == 0)
+  {
+    return;
+  }
+  minimum = count == 0 ? other.minimum : std::min(minimum, other.minimum);
+  maximum = count == 0 ? other.maximum : std::max(maximum, other.maximum);
+  positive.merge(other.positive);
+  negative.merge(other.negative);
+  zero_count += other.zero_count;
+  count += other.count;
+}
+
+double QuantileSketch::get_quantile(double q) const
+{
+  if (!(q >= 0 && q <= 1))
+  {
+    throw std::invalid_argument("Error: Quantile must be between 0 and 1.");
+  }
+  if (count == 0)
+  {
+    return 0;
+  }
+  const std::uint64_t rank = static_cast<std::uint64_t>(q * (count - 1));
+
+  // Walk the values in increasing order: negative buckets from the largest magnitude, zero, then positive
+  std::uint64_t seen = 0;
+  for (size_t i = negative.counts.size(); i-- > 0;)
+  {
+    seen += negative.counts[i];
+    if (seen > rank)
+    {
+      return std::max(minimum, -get_value(negative.offset + static_cast<int>(i)));
+    }
+  }
+  seen += zero_count;
+  if (seen > rank)
+  {
+    return 0;
+  }
+  for (size_t i = 0; i < positive.counts.size(); ++i)
+  {
+    seen += positive.counts[i];
+    if (seen > rank)
+    {
+      return std::min(maximum, get_value(positive.offset + static_cast<int>(i)));
+    }
+  }
+  return maximum;
+}
+
+std::string get_property_name(Property property)
+{
+  switch (property)
+  {
+  case Property::energy:
+    return "Energy (MeV)";
+  case Property::momentum:
+    return "Momentum |p| (MeV)";
+  case Property::velocity:
+    return "Velocity (c)";
+  case Property::rest_mass:
+    return "Rest mass (MeV)";
+  case Property::charge:
+    return "Charge (e)";
+  }
+  return "Unknown";
+}
+
+// Default constructor
+PropertyStatistics::PropertyStatistics()
+    : histograms{Histogram(160, 0.1, 1e7, Binning::logarithmic),
+                 Histogram(160, 0.1, 1e7, Binning::logarithmic),
+                 Histogram(101, 0, 1.01),
+                 Histogram(160, 0.1, 1e7, Binning::logarithmic),
+                 Histogram(15, -2.5, 2.5)}
+{
+}
+
+void PropertyStatistics::add(const std::array<double, number_of_properties> &values)
+{
+  for (size_t property = 0; property < number_of_properties; ++property)
+  {
+    statistics[property].add(values[property]);
+    quantiles[property].add(values[property]);
+    histograms[property].fill(values[property]);
+  }
+}
+
+void PropertyStatistics::merge(const PropertyStatistics &other)
+{
+  for (size_t property = 0; property < number_of_properties; ++property)
+  {
+    statistics[property].merge(other.statistics[property]);
+    quantiles[property].merge(other.quantiles[property]);
+    histograms[property].merge(other.histograms[property]);
+  }
+}
+
+std::array<double, number_of_properties> get_property_values(const Particle &particle)
+{
+  const FourMomentum &four_momentum = particle.get_four_momentum();
+  const double energy = four_momentum.get_energy();
+  const double px = four_momentum.get_Px(), py = four_momentum.get_Py(), pz = four_momentum.get_Pz();
+  const double momentum = std::sqrt(px * px + py * py + pz * pz);
+  return {energy, momentum, energy > 0 ? momentum / energy : 0, particle.get_rest_mass(), particle.get_charge()};
+}
+
+void CatalogueStatistics::add_particle(const Particle &particle)
+{
+  const std::array<double, number_of_properties> values = get_property_values(particle);
+  all.add(values);
+  by_type[particle.get_type()].add(values);
+}
+
+void CatalogueStatistics::merge(const CatalogueStatistics &other)
+{
+  all.merge(other.all);
+  for (const auto &type : other.by_type)
+  {
+    by_type[type.first].merge(type.second);
+  }
+}
+
+namespace
+{
+  // Prints one line per property
+  void print_property_statistics(const PropertyStatistics &statistics, std::ostream &os)
+  {
+    for (size_t i = 0; i < number_of_properties; ++i)
+    {
+      const Property property = static_cast<Property>(i);
+      const RunningStatistics &running = statistics.get_statistics(property);
+      const QuantileSketch &quantiles = statistics.get_quantiles(property);
+      os << "  " << get_property_name(property) << ": mean " << running.get_mean()
+         << ", standard deviation " << running.get_standard_deviation()
+         << ", range [" << running.get_minimum() << ", " << running.get_maximum() << "]"
+         << ", quartiles " << quantiles.get_quantile(0.25) << " / " << quantiles.get_quantile(0.5) << " / " << quantiles.get_quantile(0.75) << "\n";
+    }
+  }
+}
+
+void CatalogueStatistics::print(std::ostream &os) const
+{
+  os << "All particles (" << all.get_count() << "):\n";
+  print_property_statistics(all, os);
+  for (const auto &type : by_type)
+  {
+    os << type.first << " (" << type.second.get_count() << "):\n";
+    print_property_statistics(type.second, os);
+  }
+}
+
+void print_histogram(const Histogram &histogram, std::ostream &os)
+{
+  const size_t bar_width = 50;
+  std::uint64_t largest = std::max(histogram.get_underflow(), histogram.get_overflow());
+  for (size_t bin = 0; bin < histogram.get_number_of_bins(); ++bin)
+  {
+    largest = std::max(largest, histogram.get_bin_count(bin));
+  }
+  if (largest == 0)
+  {
+    os << "Histogram is empty\n";
+    return;
+  }
+  auto print_row = [&os, largest, bar_width](const std::string &range, std::uint64_t count)
+  {
+    os << range << " " << count << " " << std::string(count * bar_width / largest, '#') << "\n";
+  };
+
+  if (histogram.get_underflow() > 0)
+  {
+    print_row("below " + std::to_string(histogram.get_low()), histogram.get_underflow());
+  }
+  for (size_t bin = 0; bin < histogram.get_number_of_bins(); ++bin)
+  {
+    if (histogram.get_bin_count(bin) > 0)
+    {
+      print_row("[" + std::to_string(histogram.get_bin_low_edge(bin)) + ", " + std::to_string(histogram.get_bin_high_edge(bin)) + ")", histogram.get_bin_count(bin));
+    }
+  }
+  if (histogram.get_overflow() > 0)
+  {
+    print_row("from " + std::to_string(histogram.get_high()), histogram.get_overflow());
+  }
+}
@@ -0,0 +1,220 @@
+#ifndef STATISTICS_H
+#define STATISTICS_H
+
+#include "Particle.h"
+#include "ParticleCatalogue.h"
+#include "TaskScheduler.h"
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <iostream>
+#include <map>
+#include <string>
+#include <vector>
+
+// Spacing of histogram bins
+enum class Binning
+{
+  linear,
+  logarithmic
+};
+
+// Histogram of counts over [low, high), with underflow and overflow counts. Histograms with the
+// same binning can be merged, so partial histograms filled on separate threads add up exactly.
+class Histogram
+{
+private:
+  Binning binning;
+  double low, high;
+  double scaled_low, bins_per_unit; // Bin edges in the scaled (linear or log) variable
+  std::vector<std::uint64_t> counts;
+  std::uint64_t underflow = 0; // Also counts NaN
+  std::uint64_t overflow = 0;
+
+public:
+  // Constructor. Throws if there are no bins, the range is empty, or a logarithmic range does not start above 0.
+  Histogram(size_t number_of_bins, double low, double high, Binning binning = Binning::linear);
+
+  void fill(double value);
+  // Adds the counts of a histogram with the same binning. Throws otherwise.
+  void merge(const Histogram &other);
+  bool has_same_binning(const Histogram &other) const;
+
+  // Getters
+  Binning get_binning() const { return binning; }
+  size_t get_number_of_bins() const { return counts.size(); }
+  double get_low() const { return low; }
+  double get_high() const { return high; }
+  double get_bin_low_edge(size_t bin) const;
+  double get_bin_high_edge(size_t bin) const { return get_bin_low_edge(bin + 1); }
+  std::uint64_t get_bin_count(size_t bin) const { return counts[bin]; }
+  std::uint64_t get_underflow() const { return underflow; }
+  std::uint64_t get_overflow() const { return overflow; }
+  std::uint64_t get_total() const;
+};
+
+// Count, mean, variance, minimum and maximum updated one value at a time with Welford's method,
+// which avoids the cancellation of summing squares. Merging uses the pairwise update of Chan et al.
+class RunningStatistics
+{
+private:
+  std::uint64_t count = 0;
+  double mean = 0;
+  double sum_of_squared_deviations = 0;
+  double minimum = 0;
+  double maximum = 0;
+
+public:
+  void add(double value);
+  void merge(const RunningStatistics &other);
+
+  // Getters. Mean, minimum and maximum are 0 when empty.
+  std::uint64_t get_count() const { return count; }
+  double get_mean() const { return mean; }
+  double get_variance() const; // Sample variance, 0 for fewer than two values
+  double get_standard_deviation() const;
+  double get_minimum() const { return minimum; }
+  double get_maximum() const { return maximum; }
+};
+
+// Quantile sketch with a bounded relative error (DDSketch). Values are counted in logarithmic
+// buckets whose width sets the accuracy, so any quantile is returned within relative_accuracy of
+// the true value, memory grows only with the logarithm of the range, and sketches merge exactly.
+class QuantileSketch
+{
+private:
+  // Bucket counts indexed from offset, grown on demand
+  struct Store
+  {
+    int offset = 0;
+    std::vector<std::uint64_t> counts;
+
+    void add(int index, std::uint64_t count);
+    void merge(const Store &other);
+  };
+
+  double relative_accuracy;
+  double gamma, inverse_log_gamma;
+  Store positive, negative; // negative holds the buckets of -value
+  std::uint64_t zero_count = 0;
+  std::uint64_t count = 0;
+  double minimum = 0, maximum = 0; // Estimates are clamped to the range seen
+
+  int get_index(double magnitude) const;
+  double get_value(int index) const;
+
+public:
+  // Constructor. Throws unless 0 < relative_accuracy < 1.
+  explicit QuantileSketch(double relative_accuracy = 0.01);
+
+  // Adds a value. NaN is ignored.
+  void add(double value);
+  // Adds the counts of a sketch with the same accuracy. Throws otherwise.
+  void merge(const QuantileSketch &other);
+
+  // Returns the value at quantile q in [0, 1]. Throws if q is out of range, 0 when empty.
+  double get_quantile(double q) const;
+  double get_relative_accuracy() const { return relative_accuracy; }
+  std::uint64_t get_count() const { return count; }
+};
+
+// Particle properties that are summarised
+enum class Property
+{
+  energy,
+  momentum, // |p|
+  velocity, // In units of c
+  rest_mass,
+  charge
+};
+constexpr size_t number_of_properties = 5;
+
+// Returns the name of a property with its unit
+std::string get_property_name(Property property);
+
+// Statistics, quantiles and a histogram for every property of one set of particles
+class PropertyStatistics
+{
+private:
+  std::array<RunningStatistics, number_of_properties> statistics;
+  std::array<QuantileSketch, number_of_properties> quantiles;
+  std::array<Histogram, number_of_properties> histograms;
+
+public:
+  // Default constructor. Energy, momentum and rest mass use logarithmic bins from 0.1 MeV to 10 TeV,
+  // velocity bins of 0.01c up to and including c, and charge one bin per third of e.
+  PropertyStatistics();
+
+  // Adds one value per property, in Property order
+  void add(const std::array<double, number_of_properties> &values);
+  void merge(const PropertyStatistics &other);
+
+  // Getters
+  const RunningStatistics &get_statistics(Property property) const { return statistics[static_cast<size_t>(property)]; }
+  const QuantileSketch &get_quantiles(Property property) const { return quantiles[static_cast<size_t>(property)]; }
+  const Histogram &get_histogram(Property property) const { return histograms[static_cast<size_t>(property)]; }
+  std::uint64_t get_count() const { return statistics[0].get_count(); }
+};
+
+// Summary of a catalogue, over every particle and broken down by type. It is filled one particle at
+// a time, so it can be updated while particles are created or imported, and partial summaries of
+// separate parts of a catalogue can be merged.
+class CatalogueStatistics
+{
+private:
+  PropertyStatistics all;
+  std::map<std::string, PropertyStatistics> by_type;
+
+public:
+  void add_particle(const Particle &particle);
+  void merge(const CatalogueStatistics &other);
+
+  // Getters
+  const PropertyStatistics &get_all() const { return all; }
+  const std::map<std::string, PropertyStatistics> &get_by_type() const { return by_type; }
+  std::uint64_t get_number_of_particles() const { return all.get_count(); }
+
+  // Prints the mean, standard deviation, range and quartiles of every property, overall and by type
+  void print(std::ostream &os = std::cout) const;
+};
+
+// Returns the property values of a particle, in Property order
+std::array<double, number_of_properties> get_property_values(const Particle &particle);
+
+// Prints the non-empty bins of a histogram as rows of '#'
+void print_histogram(const Histogram &histogram, std::ostream &os = std::cout);
+
+// Summarises the particles of a view in a single pass, in chunks of statistics_grain particles on a
+// task scheduler. Chunk summaries are merged in chunk order, so the result does not depend on the
+// number of threads or on scheduling.
+constexpr size_t statistics_grain = 4096;
+
+template <typename T>
+CatalogueStatistics compute_statistics(const ParticleCatalogueView<T> &view, TaskScheduler &scheduler = TaskScheduler::get_default())
+{
+  return scheduler.parallel_reduce(
+      view.get_number_of_particles(), statistics_grain, CatalogueStatistics(),
+      [&view](size_t first, size_t last)
+      {
+        CatalogueStatistics statistics;
+        for (size_t position = first; position < last; ++position)
+        {
+          statistics.add_particle(*view[position]);
+        }
+        return statistics;
+      },
+      [](CatalogueStatistics accumulated, const CatalogueStatistics &next)
+      {
+        accumulated.merge(next);
+        return accumulated;
+      });
+}
+
+template <typename T>
+CatalogueStatistics compute_statistics(const ParticleCatalogue<T> &catalogue, TaskScheduler &scheduler = TaskScheduler::get_default())
+{
+  return compute_statistics(catalogue.get_view(), scheduler);
+}
+
+#endif // STATISTICS_H
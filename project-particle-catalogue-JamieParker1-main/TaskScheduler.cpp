@@ -0,0 +1,299 @@
+#include "TaskScheduler.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+#if defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace
+{
+  // Scheduler and queue of the current thread, if it is one of a pool's workers
+  thread_local const void *current_scheduler = nullptr;
+  thread_local size_t current_queue = 0;
+
+  std::mutex default_mutex;
+  std::unique_ptr<TaskScheduler> default_scheduler;
+
+  void pin_to_cpu(size_t cpu)
+  {
+#if defined(__linux__)
+    const size_t number_of_cpus = std::max(1u, std::thread::hardware_concurrency());
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu % number_of_cpus, &set);
+    pthread_setaffinity_np(pthread_self(), sizeof set, &set);
+#else
+    (void)cpu;
+#endif
+  }
+}
+
+size_t TaskGraph::add_task(std::function<void()> function, const std::vector<size_t> &dependencies)
+{
+  const size_t id = nodes.size();
+  for (size_t dependency : dependencies)
+  {
+    if (dependency >= id)
+    {
+      throw std::invalid_argument("Error: A task can only depend on tasks added before it.");
+    }
+  }
+  nodes.push_back(Node{std::move(function), {}, dependencies.size()});
+  for (size_t dependency : dependencies)
+  {
+    nodes[dependency].successors.push_back(id);
+  }
+  return id;
+}
+
+// Constructor
+TaskScheduler::TaskScheduler(size_t number_of_threads, bool pin_threads)
+    : number_of_threads(number_of_threads == 0 ? std::max(1u, std::thread::hardware_concurrency()) : number_of_threads),
+      pin_threads(pin_threads)
+{
+  for (size_t queue = 0; queue < this->number_of_threads; ++queue)
+  {
+    queues.push_back(std::make_unique<Queue>());
+  }
+  for (size_t queue = 1; queue < this->number_of_threads; ++queue)
+  {
+    workers.emplace_back(&TaskScheduler::run_worker, this, queue);
+  }
+}
+
+// Destructor
+TaskScheduler::~TaskScheduler()
+{
+  {
+    std::lock_guard<std::mutex> lock(sleep_mutex);
+    stopping = true;
+  }
+  wake.notify_all();
+  for (auto &worker : workers)
+  {
+    worker.join();
+  }
+}
+
+TaskScheduler &TaskScheduler::get_default()
+{
+  std::lock_guard<std::mutex> lock(default_mutex);
+  if (!default_scheduler)
+  {
+    default_scheduler = std::make_unique<TaskScheduler>();
+  }
+  return *default_scheduler;
+}
+
+void TaskScheduler::configure_default(size_t number_of_threads, bool pin_threads)
+{
+  std::lock_guard<std::mutex> lock(default_mutex);
+  default_scheduler.reset();
+  default_scheduler = std::make_unique<TaskScheduler>(number_of_threads, pin_threads);
+}
+
+size_t TaskScheduler::get_own_queue() const
+{
+  return current_scheduler == this ? current_queue : 0;
+}
+
+void TaskScheduler::submit(std::function<void()> function, Group &group)
+{
+  Queue &queue = *queues[get_own_queue()];
+  {
+    std::lock_guard<std::mutex> lock(queue.mutex);
+    queue.tasks.push_back(Task{std::move(function), &group});
+  }
+  number_of_queued_tasks.fetch_add(1, std::memory_order_release);
+  // Taking the lock orders this with a worker checking for tasks before it sleeps
+  {
+    std::lock_guard<std::mutex> lock(sleep_mutex);
+  }
+  wake.notify_one();
+}
+
+void TaskScheduler::record_failure(Group &group)
+{
+  std::lock_guard<std::mutex> lock(group.mutex);
+  if (!group.error)
+  {
+    group.error = std::current_exception();
+  }
+  group.failed.store(true, std::memory_order_relaxed);
+}
+
+// Tasks are always run, so each one decides what to skip after a failure. A chunk of a
+// parallel_for skips its body, while a graph task still has to release its successors.
+void TaskScheduler::run_task(Task &task)
+{
+  Group &group = *task.group;
+  try
+  {
+    task.function();
+  }
+  catch (...)
+  {
+    record_failure(group);
+  }
+  group.pending.fetch_sub(1, std::memory_order_acq_rel);
+}
+
+bool TaskScheduler::try_run_task(size_t own_queue)
+{
+  Task task;
+  bool found = false;
+  {
+    Queue &queue = *queues[own_queue];
+    std::lock_guard<std::mutex> lock(queue.mutex);
+    if (!queue.tasks.empty())
+    {
+      task = std::move(queue.tasks.back());
+      queue.tasks.pop_back();
+      found = true;
+    }
+  }
+  for (size_t step = 1; !found && step < queues.size(); ++step)
+  {
+    Queue &queue = *queues[(own_queue + step) % queues.size()];
+    std::lock_guard<std::mutex> lock(queue.mutex);
+    if (!queue.tasks.empty())
+    {
+      task = std::move(queue.tasks.front());
+      queue.tasks.pop_front();
+      found = true;
+    }
+  }
+  if (!found)
+  {
+    return false;
+  }
+  number_of_queued_tasks.fetch_sub(1, std::memory_order_relaxed);
+  run_task(task);
+  return true;
+}
+
+void TaskScheduler::wait(Group &group)
+{
+  const size_t own_queue = get_own_queue();
+  while (group.pending.load(std::memory_order_acquire) > 0)
+  {
+    if (!try_run_task(own_queue))
+    {
+      std::this_thread::yield();
+    }
+  }
+  if (group.error)
+  {
+    std::rethrow_exception(group.error);
+  }
+}
+
+void TaskScheduler::run_worker(size_t queue)
+{
+  current_scheduler = this;
+  current_queue = queue;
+  if (pin_threads)
+  {
+    pin_to_cpu(queue);
+  }
+  for (;;)
+  {
+    if (try_run_task(queue))
+    {
+      continue;
+    }
+    std::unique_lock<std::mutex> lock(sleep_mutex);
+    wake.wait(lock, [this]
+              { return stopping || number_of_queued_tasks.load(std::memory_order_acquire) > 0; });
+    if (stopping && number_of_queued_tasks.load(std::memory_order_acquire) == 0)
+    {
+      return;
+    }
+  }
+}
+
+void TaskScheduler::parallel_for(size_t count, size_t grain, const std::function<void(size_t, size_t)> &body)
+{
+  grain = grain == 0 ? get_default_grain(count) : grain;
+  const size_t number_of_chunks = (count + grain - 1) / grain;
+  // Without other threads, or with one chunk, run in order on this thread
+  if (number_of_threads == 1 || number_of_chunks <= 1)
+  {
+    for (size_t first = 0; first < count; first += grain)
+    {
+      body(first, std::min(count, first + grain));
+    }
+    return;
+  }
+
+  Group group;
+  group.pending.store(number_of_chunks, std::memory_order_relaxed);
+  // Pushed last chunk first, so this thread starts at chunk 0 and thieves take from the end
+  for (size_t chunk = number_of_chunks; chunk-- > 0;)
+  {
+    const size_t first = chunk * grain;
+    const size_t last = std::min(count, first + grain);
+    submit([&body, &group, first, last]
+           {
+             if (!group.failed.load(std::memory_order_relaxed))
+             {
+               body(first, last);
+             } },
+           group);
+  }
+  wait(group);
+}
+
+void TaskScheduler::run(const TaskGraph &graph)
+{
+  const size_t number_of_tasks = graph.nodes.size();
+  if (number_of_tasks == 0)
+  {
+    return;
+  }
+  std::vector<std::atomic<size_t>> remaining(number_of_tasks);
+  for (size_t task = 0; task < number_of_tasks; ++task)
+  {
+    remaining[task].store(graph.nodes[task].number_of_dependencies, std::memory_order_relaxed);
+  }
+
+  Group group;
+  group.pending.store(number_of_tasks, std::memory_order_relaxed);
+  // Each task releases its successors when it finishes, even if it was skipped after a failure,
+  // so every task is accounted for
+  std::function<void(size_t)> start = [this, &graph, &remaining, &group, &start](size_t task)
+  {
+    submit([this, &graph, &remaining, &group, &start, task]
+           {
+             if (!group.failed.load(std::memory_order_relaxed))
+             {
+               try
+               {
+                 graph.nodes[task].function();
+               }
+               catch (...)
+               {
+                 record_failure(group);
+               }
+             }
+             for (size_t successor : graph.nodes[task].successors)
+             {
+               if (remaining[successor].fetch_sub(1, std::memory_order_acq_rel) == 1)
+               {
+                 start(successor);
+               }
+             } },
+           group);
+  };
+  for (size_t task = 0; task < number_of_tasks; ++task)
+  {
+    if (graph.nodes[task].number_of_dependencies == 0)
+    {
+      start(task);
+    }
+  }
+  wait(group);
+}
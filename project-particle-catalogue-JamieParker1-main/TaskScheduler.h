@@ -0,0 +1,147 @@
+#ifndef TASK_SCHEDULER_H
+#define TASK_SCHEDULER_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+// Seed of an independent random stream, e.g. one per chunk of a parallel_for, by a SplitMix64 step.
+// Seeding per chunk instead of per thread keeps seeded results identical for any number of threads.
+inline std::uint64_t get_stream_seed(std::uint64_t seed, std::uint64_t stream)
+{
+  std::uint64_t z = seed + (stream + 1) * 0x9e3779b97f4a7c15ull;
+  z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+  z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+  return z ^ (z >> 31);
+}
+
+// Tasks with dependencies, run by TaskScheduler::run. A task can only depend on tasks added before
+// it, so every graph is acyclic.
+class TaskGraph
+{
+private:
+  friend class TaskScheduler;
+
+  struct Node
+  {
+    std::function<void()> function;
+    std::vector<size_t> successors;
+    size_t number_of_dependencies = 0;
+  };
+  std::vector<Node> nodes;
+
+public:
+  // Adds a task that runs after all of its dependencies, returning its id. Throws if a dependency
+  // is not the id of an earlier task.
+  size_t add_task(std::function<void()> function, const std::vector<size_t> &dependencies = {});
+  size_t get_number_of_tasks() const { return nodes.size(); }
+};
+
+// Pool of worker threads shared by every parallel part of the project. Each worker has its own
+// deque of tasks: it runs the newest of its own, and when it has none it steals the oldest task of
+// another queue. A thread waiting for its tasks runs queued tasks meanwhile, so parallel calls can
+// be nested, e.g. a parallel_for inside a task graph.
+//
+// Chunk boundaries depend only on the count and grain, never on the number of threads, and
+// parallel_reduce combines chunk results in chunk order. Given per-chunk random streams from
+// get_stream_seed, results are the same for every thread count and run.
+class TaskScheduler
+{
+private:
+  // Tasks started together, waited on together
+  struct Group
+  {
+    std::atomic<size_t> pending{0};
+    std::atomic<bool> failed{false};
+    std::mutex mutex;
+    std::exception_ptr error; // First exception thrown, guarded by mutex
+  };
+  struct Task
+  {
+    std::function<void()> function;
+    Group *group;
+  };
+  struct Queue
+  {
+    std::mutex mutex;
+    std::deque<Task> tasks;
+  };
+
+  size_t number_of_threads;
+  bool pin_threads;
+  std::vector<std::unique_ptr<Queue>> queues; // queues[0] is shared by threads outside the pool, then one per worker
+  std::vector<std::thread> workers;
+  std::atomic<size_t> number_of_queued_tasks{0};
+  std::mutex sleep_mutex;
+  std::condition_variable wake;
+  bool stopping = false; // Guarded by sleep_mutex
+
+  size_t get_own_queue() const;
+  void submit(std::function<void()> function, Group &group);
+  bool try_run_task(size_t own_queue);
+  void wait(Group &group);
+  void run_worker(size_t queue);
+  static void record_failure(Group &group); // Called from a catch block
+  static void run_task(Task &task);
+
+public:
+  // Constructor. number_of_threads counts the calling thread, which works while it waits, so a pool
+  // of n threads starts n - 1 workers. 0 means one per hardware thread. Pinning binds worker i to
+  // CPU i modulo the number of CPUs, and is ignored on platforms other than Linux.
+  explicit TaskScheduler(size_t number_of_threads = 0, bool pin_threads = false);
+  ~TaskScheduler();
+  TaskScheduler(const TaskScheduler &) = delete;
+  TaskScheduler &operator=(const TaskScheduler &) = delete;
+
+  size_t get_number_of_threads() const { return number_of_threads; }
+  bool get_pin_threads() const { return pin_threads; }
+
+  // Scheduler used by default across the project, created on first use
+  static TaskScheduler &get_default();
+  // Replaces the default scheduler. It must not be in use by another thread.
+  static void configure_default(size_t number_of_threads, bool pin_threads = false);
+
+  // Number of items per chunk when the grain passed is 0, about 64 chunks whatever the thread count
+  static size_t get_default_grain(size_t count) { return count < 64 ? 1 : (count + 63) / 64; }
+
+  // Calls body(first, last) for consecutive chunks of grain items covering [0, count) and returns
+  // once all have finished. The first exception thrown stops chunks that have not started and is
+  // rethrown.
+  void parallel_for(size_t count, size_t grain, const std::function<void(size_t, size_t)> &body);
+
+  // Maps every chunk to a result with map(first, last) and folds the results in chunk order with
+  // combine(accumulated, next), starting from identity
+  template <typename Result, typename Map, typename Combine>
+  Result parallel_reduce(size_t count, size_t grain, Result identity, Map map, Combine combine)
+  {
+    grain = grain == 0 ? get_default_grain(count) : grain;
+    // Wrapped so Result = bool does not share words between chunks as std::vector<bool> would
+    struct Slot
+    {
+      Result value;
+    };
+    std::vector<Slot> partial((count + grain - 1) / grain, Slot{identity});
+    parallel_for(count, grain, [&partial, &map, grain](size_t first, size_t last)
+                 { partial[first / grain].value = map(first, last); });
+    Result result = std::move(identity);
+    for (Slot &slot : partial)
+    {
+      result = combine(std::move(result), std::move(slot.value));
+    }
+    return result;
+  }
+
+  // Runs every task of a graph once all of its dependencies have finished. If a task throws, the
+  // tasks not yet started are skipped and the first exception is rethrown.
+  void run(const TaskGraph &graph);
+};
+
+#endif // TASK_SCHEDULER_H
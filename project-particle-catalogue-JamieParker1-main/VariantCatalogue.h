@@ -0,0 +1,280 @@
+#ifndef VARIANT_CATALOGUE_H
+#define VARIANT_CATALOGUE_H
+
+#include "Particle.h"
+#include "FourMomentum.h"
+
+#include "leptons/Electron.h"
+#include "leptons/Muon.h"
+#include "leptons/Tau.h"
+#include "leptons/Neutrino.h"
+
+#include "bosons/Photon.h"
+#include "bosons/Gluon.h"
+#include "bosons/Z.h"
+#include "bosons/W.h"
+#include "bosons/Higgs.h"
+
+#include "quarks/IndividualQuarks.h"
+
+#include <vector>
+#include <map>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <tuple>
+#include <typeinfo>
+#include <type_traits>
+#include <utility>
+#include <variant>
+
+// Catalogue over a closed set of concrete particle types. Particles are stored by value in one
+// contiguous bucket per type, so every loop runs over a single concrete (final) type and member
+// calls are resolved at compile time instead of through the vtable.
+template <typename... Types>
+class VariantCatalogue
+{
+public:
+  // Variant able to hold any one particle of the catalogue's closed set of types
+  using value_type = std::variant<Types...>;
+
+private:
+  std::tuple<std::vector<Types>...> buckets;
+
+  // Calls a function once for every bucket, in the order the types were listed
+  template <typename Function>
+  void for_each_bucket(Function &&function)
+  {
+    std::apply([&function](auto &...bucket)
+               { (function(bucket), ...); },
+               buckets);
+  }
+  template <typename Function>
+  void for_each_bucket(Function &&function) const
+  {
+    std::apply([&function](const auto &...bucket)
+               { (function(bucket), ...); },
+               buckets);
+  }
+
+  // Converts a mangled type name into the readable name used by ParticleCatalogue
+  static std::string type_name(const std::type_info &info)
+  {
+    std::string name = info.name();
+    size_t pos = name.find_first_not_of("0123456789");
+    if (pos != std::string::npos)
+    {
+      name = name.substr(pos);
+    }
+    return name;
+  }
+
+public:
+  // Default constructor. Initializes a catalogue with an empty bucket for every type.
+  VariantCatalogue() = default;
+
+  // Adds a particle to the catalogue, moving it into the bucket of the type held by the variant
+  void add_particle(value_type particle)
+  {
+    std::visit([this](auto &&held)
+               {
+      using HeldType = std::decay_t<decltype(held)>;
+      std::get<std::vector<HeldType>>(buckets).push_back(std::move(held)); },
+               std::move(particle));
+  }
+
+  // Constructs a particle of the specified type in place at the end of its bucket
+  template <typename SubType, typename... Args>
+  SubType &emplace_particle(Args &&...args)
+  {
+    return std::get<std::vector<SubType>>(buckets).emplace_back(std::forward<Args>(args)...);
+  }
+
+  // Reserves space in the bucket of the specified type
+  template <typename SubType>
+  void reserve(size_t capacity)
+  {
+    std::get<std::vector<SubType>>(buckets).reserve(capacity);
+  }
+
+  // Returns the contiguous bucket holding all particles of the specified type
+  template <typename SubType>
+  std::vector<SubType> &get_bucket()
+  {
+    return std::get<std::vector<SubType>>(buckets);
+  }
+  template <typename SubType>
+  const std::vector<SubType> &get_bucket() const
+  {
+    return std::get<std::vector<SubType>>(buckets);
+  }
+
+  // Returns the total number of particles in the catalogue
+  size_t get_number_of_particles() const
+  {
+    size_t total = 0;
+    for_each_bucket([&total](const auto &bucket)
+                    { total += bucket.size(); });
+    return total;
+  }
+
+  // Returns the number of particles of the specified type, without looking at any particle
+  template <typename SubType>
+  size_t get_number_of_particles() const
+  {
+    return get_bucket<SubType>().size();
+  }
+
+  // Applies a function to every particle. The function is instantiated once per type, so it
+  // receives each particle as its concrete type and needs no casting.
+  template <typename Function>
+  void for_each(Function function)
+  {
+    for_each_bucket([&function](auto &bucket)
+                    {
+      for (auto &particle : bucket)
+      {
+        function(particle);
+      } });
+  }
+  template <typename Function>
+  void for_each(Function function) const
+  {
+    for_each_bucket([&function](const auto &bucket)
+                    {
+      for (const auto &particle : bucket)
+      {
+        function(particle);
+      } });
+  }
+
+  // Applies a function to every particle of the specified type only
+  template <typename SubType, typename Function>
+  void for_each_of_type(Function function)
+  {
+    for (auto &particle : get_bucket<SubType>())
+    {
+      function(particle);
+    }
+  }
+  template <typename SubType, typename Function>
+  void for_each_of_type(Function function) const
+  {
+    for (const auto &particle : get_bucket<SubType>())
+    {
+      function(particle);
+    }
+  }
+
+  // Visits the particle at a given position in the catalogue, counting through the buckets in
+  // order, with std::visit on a variant holding a copy of it
+  template <typename Function>
+  auto visit(size_t index, Function function) const
+  {
+    return std::visit(function, get_particle(index));
+  }
+
+  // Returns a variant holding a copy of the particle at a given position in the catalogue
+  value_type get_particle(size_t index) const
+  {
+    std::optional<value_type> found;
+    for_each_bucket([&index, &found](const auto &bucket)
+                    {
+      using BucketType = typename std::decay_t<decltype(bucket)>::value_type;
+      if (found)
+      {
+        return;
+      }
+      if (index < bucket.size())
+      {
+        found.emplace(std::in_place_type<BucketType>, bucket[index]);
+      }
+      else
+      {
+        index -= bucket.size();
+      } });
+    if (!found)
+    {
+      throw std::out_of_range("Error: Particle index out of range");
+    }
+    return std::move(*found);
+  }
+
+  // Prints information for every particle in the catalogue
+  void print_all() const
+  {
+    for_each([](const auto &particle)
+             { particle.print(); });
+  }
+
+  // Returns a map where keys are particle type names and values are the counts of particles of each type
+  std::map<std::string, int> get_particle_count_by_type() const
+  {
+    std::map<std::string, int> counts;
+    for_each_bucket([&counts](const auto &bucket)
+                    {
+      using BucketType = typename std::decay_t<decltype(bucket)>::value_type;
+      if (!bucket.empty())
+      {
+        counts[type_name(typeid(BucketType))] += static_cast<int>(bucket.size());
+      } });
+    return counts;
+  }
+
+  // Calculates the total four-momentum of all particles in the catalogue
+  FourMomentum sum_four_momenta() const
+  {
+    long double energy = 0, px = 0, py = 0, pz = 0;
+    for_each([&](const auto &particle)
+             {
+      const FourMomentum &four_momentum = particle.get_four_momentum();
+      energy += four_momentum.get_energy();
+      px += four_momentum.get_Px();
+      py += four_momentum.get_Py();
+      pz += four_momentum.get_Pz(); });
+    return FourMomentum(energy, px, py, pz);
+  }
+
+  // Totals of conserved quantities across the whole catalogue
+  double get_total_charge() const
+  {
+    double total = 0;
+    for_each([&total](const auto &particle)
+             { total += particle.get_charge(); });
+    return total;
+  }
+  int get_total_lepton_number() const
+  {
+    int total = 0;
+    for_each([&total](const auto &particle)
+             { total += particle.get_lepton_number(); });
+    return total;
+  }
+  double get_total_baryon_number() const
+  {
+    double total = 0;
+    for_each([&total](const auto &particle)
+             { total += particle.get_baryon_number(); });
+    return total;
+  }
+
+  // Removes every particle of the specified type
+  template <typename SubType>
+  void remove_particles_by_type()
+  {
+    get_bucket<SubType>().clear();
+  }
+
+  // Clears the catalogue of all particles
+  void clear_all_particles()
+  {
+    for_each_bucket([](auto &bucket)
+                    { bucket.clear(); });
+  }
+};
+
+// Catalogue over every concrete Standard Model particle in the project
+using ParticleVariantCatalogue = VariantCatalogue<Electron, Muon, Tau, Neutrino, Photon, Gluon, W, Z, Higgs, Up, Down, Charm, Strange, Top, Bottom>;
+using ParticleVariant = ParticleVariantCatalogue::value_type;
+
+#endif // VARIANT_CATALOGUE_H
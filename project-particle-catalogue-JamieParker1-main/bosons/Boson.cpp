@@ -12,6 +12,10 @@ Boson::Boson(std::string type, int charge, double rest_mass, int spin, std::uniq
 Boson::Boson(std::string type, const std::string &label, int charge,  double rest_mass, int spin, std::unique_ptr<FourMomentum> four_momentum, std::vector<DecayType> possible_decay_types)
     : Particle(type, label, charge, spin, rest_mass, std::move(four_momentum), possible_decay_types) {}
 
+// Protected trusted constructor without label with four momentum
+Boson::Boson(Trusted, std::string type, int charge, double rest_mass, int spin, std::unique_ptr<FourMomentum> four_momentum, std::vector<DecayType> possible_decay_types)
+    : Particle(trusted, std::move(type), charge, spin, rest_mass, std::move(four_momentum), std::move(possible_decay_types)) {}
+
 // Constructor without label without four momentum
 Boson::Boson(std::string type, int charge, double rest_mass, int spin,  std::vector<DecayType> possible_decay_types)
     : Particle(type, charge, spin, rest_mass, possible_decay_types) {}
@@ -51,3 +55,9 @@ Boson &Boson::operator=(Boson &&other) noexcept
   return *this;
 }
 
+
+// Virtual copy function
+Particle *Boson::clone() const
+{
+  return new Boson(*this);
+}
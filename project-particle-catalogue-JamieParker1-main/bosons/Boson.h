@@ -18,6 +18,8 @@ protected:
   Boson(std::string type, int charge, double rest_mass, int spin, std::unique_ptr<FourMomentum> fourMomentum, std::vector<DecayType> possible_decay_types = std::vector<DecayType>{DecayType::None});
   // Constructor with label
   Boson(std::string type, const std::string &label, int charge, double rest_mass, int spin, std::unique_ptr<FourMomentum> fourMomentum, std::vector<DecayType> possible_decay_types = std::vector<DecayType>{DecayType::None});
+  // Trusted constructor without label
+  Boson(Trusted, std::string type, int charge, double rest_mass, int spin, std::unique_ptr<FourMomentum> four_momentum, std::vector<DecayType> possible_decay_types = std::vector<DecayType>{DecayType::None});
 
 public:
   // Default constructor
@@ -43,7 +45,8 @@ public:
   // Move assignment operator
   Boson &operator=(Boson &&other) noexcept;
 
-  // Lepton number getter
+  // Virtual function overrides
+  virtual Particle *clone() const override;
 };
 
 #endif // BOSON_H
\ No newline at end of file
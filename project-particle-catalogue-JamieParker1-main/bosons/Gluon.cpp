@@ -14,6 +14,13 @@ Gluon::Gluon(const std::string &label, std::unique_ptr<FourMomentum> four_moment
   set_colour_charges(colour_charges);
 }
 
+// Trusted constructor
+Gluon::Gluon(Trusted, std::unique_ptr<FourMomentum> four_momentum, std::vector<Colour> colour_charges)
+    : Boson(trusted, "gluon", 0, Mass::gluon, 1, std::move(four_momentum))
+{
+  set_colour_charges(colour_charges);
+}
+
 // Default constructor
 Gluon::Gluon() : Boson("gluon", 0, Mass::gluon, 1), colour_charges(std::vector<Colour>{Colour::Red, Colour::AntiRed}) {}
 
@@ -75,39 +82,18 @@ std::vector<Colour> Gluon::get_colour_charges() const
 }
 
 // Validate gluon is colourless
-bool Gluon::is_valid_colour_charges(std::vector<Colour> &colour_charges) const
+bool Gluon::is_valid_colour_charges(const std::vector<Colour> &colour_charges) const
 {
-  int net_red = 0;
-  int net_green = 0;
-  int net_blue = 0;
-
-  for (const Colour &colour : colour_charges)
+  PackedColour net_colour = 0;
+  for (Colour colour : colour_charges)
   {
-    switch (colour)
-    {
-    case Colour::Red:
-      net_red++;
-      break;
-    case Colour::AntiRed:
-      net_red--;
-      break;
-    case Colour::Green:
-      net_green++;
-      break;
-    case Colour::AntiGreen:
-      net_green--;
-      break;
-    case Colour::Blue:
-      net_blue++;
-      break;
-    case Colour::AntiBlue:
-      net_blue--;
-      break;
-    case Colour::None:
-      break;
-    }
+    net_colour = ColourAlgebra::combine(net_colour, ColourAlgebra::pack(colour));
   }
-
-  return net_red == 0 && net_green == 0 && net_blue == 0;
+  return ColourAlgebra::is_colourless(net_colour);
 }
 
+// Virtual copy function
+Particle *Gluon::clone() const
+{
+  return new Gluon(*this);
+}
@@ -13,15 +13,17 @@
 #include <stdexcept> 
  
 // Gluon class 
-class Gluon : public Boson
+class Gluon final : public Boson
 {
 private:
   std::vector<Colour> colour_charges;
-  bool is_valid_colour_charges(std::vector<Colour>& colour_charges) const;
+  bool is_valid_colour_charges(const std::vector<Colour> &colour_charges) const;
 public:
   // Constructors
   Gluon(std::unique_ptr<FourMomentum> four_momentum, std::vector<Colour> colour_charges);
   Gluon(const std::string &label, std::unique_ptr<FourMomentum> four_momentum, std::vector<Colour> colour_charges);
+  // Trusted constructor, skipping the four-momentum checks
+  Gluon(Trusted, std::unique_ptr<FourMomentum> four_momentum, std::vector<Colour> colour_charges);
   // Default constructor
   Gluon();
 
@@ -38,6 +40,7 @@ public:
 
   // Virtual function overrides
   virtual void print() const override;
+  virtual Particle *clone() const override;
 };
 
 #endif // GLUON_H
@@ -8,6 +8,10 @@ Higgs::Higgs(std::unique_ptr<FourMomentum> four_momentum)
 Higgs::Higgs(const std::string &label, std::unique_ptr<FourMomentum> four_momentum)
     : Boson("higgs", label, 0, Mass::higgs, 0, std::move(four_momentum), std::vector<DecayType>{DecayType::Weak, DecayType::Strong, DecayType::Electromagnetic}) {}
 
+// Trusted constructor
+Higgs::Higgs(Trusted, std::unique_ptr<FourMomentum> four_momentum)
+    : Boson(trusted, "higgs", 0, Mass::higgs, 0, std::move(four_momentum), std::vector<DecayType>{DecayType::Weak, DecayType::Strong, DecayType::Electromagnetic}) {}
+
 // Default constructor
 Higgs::Higgs() : Boson("higgs", 0, Mass::higgs, 0, std::vector<DecayType>{DecayType::Weak, DecayType::Strong, DecayType::Electromagnetic}) {}
 
@@ -74,3 +78,9 @@ void Higgs::print() const
   }
 }
 
+
+// Virtual copy function
+Particle *Higgs::clone() const
+{
+  return new Higgs(*this);
+}
@@ -9,12 +9,14 @@
 #include <iomanip>
 
 // Higgs class 
-class Higgs : public Boson
+class Higgs final : public Boson
 {
 public:
   // Constructors
   Higgs(std::unique_ptr<FourMomentum> four_momentum);
   Higgs(const std::string &label, std::unique_ptr<FourMomentum> four_momentum);
+  // Trusted constructor, skipping the four-momentum checks
+  Higgs(Trusted, std::unique_ptr<FourMomentum> four_momentum);
   
   // Default constructor
   Higgs();
@@ -28,6 +30,7 @@ public:
 
   // Virtual function overrides
   virtual void print() const override;
+  virtual Particle *clone() const override;
 };
 
 #endif // Z_H
@@ -8,6 +8,10 @@ Photon::Photon(std::unique_ptr<FourMomentum> four_momentum)
 Photon::Photon(const std::string &label, std::unique_ptr<FourMomentum> four_momentum)
     : Boson("photon", label, 0, Mass::photon, 0, std::move(four_momentum)) {}
 
+// Trusted constructor
+Photon::Photon(Trusted, std::unique_ptr<FourMomentum> four_momentum)
+    : Boson(trusted, "photon", 0, Mass::photon, 0, std::move(four_momentum)) {}
+
 //Default constructor
 Photon::Photon() : Boson("photon", 0, Mass::photon, 0) {}
 
@@ -49,3 +53,9 @@ Photon &Photon::operator=(Photon &&other) noexcept
 
 
 
+
+// Virtual copy function
+Particle *Photon::clone() const
+{
+  return new Photon(*this);
+}
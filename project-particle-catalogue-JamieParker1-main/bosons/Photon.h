@@ -7,12 +7,14 @@
 #include <utility>   
  
 // Photon class 
-class Photon : public Boson
+class Photon final : public Boson
 {
 public:
   // Constructors
   Photon(std::unique_ptr<FourMomentum> four_momentum);
   Photon(const std::string &label, std::unique_ptr<FourMomentum> four_momentum);
+  // Trusted constructor, skipping the four-momentum checks
+  Photon(Trusted, std::unique_ptr<FourMomentum> four_momentum);
   // Default constructor
   Photon();
 
@@ -22,6 +24,9 @@ public:
   ~Photon();                                    // Destructor
   Photon &operator=(const Photon &other);     // Copy assignment operator
   Photon &operator=(Photon &&other) noexcept; // Move assignment operator
+
+  // Virtual function overrides
+  virtual Particle *clone() const override;
 };
 
 #endif // PHOTON_H
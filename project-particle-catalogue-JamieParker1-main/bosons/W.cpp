@@ -9,6 +9,10 @@ W::W(int charge, std::unique_ptr<FourMomentum> four_momentum)
 W::W(const std::string &label, int charge, std::unique_ptr<FourMomentum> four_momentum)
     : Boson("w", label, validate_charge(charge), Mass::w, 1, std::move(four_momentum), std::vector<DecayType>{DecayType::Weak}) {}
 
+// Trusted constructor
+W::W(Trusted, int charge, std::unique_ptr<FourMomentum> four_momentum)
+    : Boson(trusted, "w", validate_charge(charge), Mass::w, 1, std::move(four_momentum), std::vector<DecayType>{DecayType::Weak}) {}
+
 // Default constructor
 W::W(int charge) : Boson("w", validate_charge(charge), Mass::w, 1, std::vector<DecayType>{DecayType::Weak}) {}
 
@@ -83,3 +87,9 @@ void W::print() const
     std::cout << "\033[1mDecay Products: \033[0mNo Specific Decay Products To Display" << std::endl;
   }
 }
+
+// Virtual copy function
+Particle *W::clone() const
+{
+  return new W(*this);
+}
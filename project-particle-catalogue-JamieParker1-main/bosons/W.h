@@ -9,7 +9,7 @@
 
  
 // W class 
-class W : public Boson
+class W final : public Boson
 {
 private:
   int validate_charge(int charge);
@@ -17,6 +17,8 @@ public:
   // Constructors
   W(int charge, std::unique_ptr<FourMomentum> four_momentum);
   W(const std::string &label, int charge, std::unique_ptr<FourMomentum> four_momentum);
+  // Trusted constructor, skipping the four-momentum checks
+  W(Trusted, int charge, std::unique_ptr<FourMomentum> four_momentum);
   // Default constructor
   W(int charge = 1);
 
@@ -29,6 +31,7 @@ public:
 
   // Virtual function overrides
   virtual void print() const override;
+  virtual Particle *clone() const override;
 };
 
 #endif // W_H
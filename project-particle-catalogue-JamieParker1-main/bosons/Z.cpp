@@ -8,6 +8,10 @@ Z::Z(std::unique_ptr<FourMomentum> four_momentum)
 Z::Z(const std::string &label, std::unique_ptr<FourMomentum> four_momentum)
     : Boson("z", label, 0, Mass::z, 1, std::move(four_momentum), std::vector<DecayType>{DecayType::Weak}) {}
 
+// Trusted constructor
+Z::Z(Trusted, std::unique_ptr<FourMomentum> four_momentum)
+    : Boson(trusted, "z", 0, Mass::z, 1, std::move(four_momentum), std::vector<DecayType>{DecayType::Weak}) {}
+
 // Default constructor
 Z::Z() : Boson("z", 0, Mass::z, 1, std::vector<DecayType>{DecayType::Weak}) {}
 
@@ -74,3 +78,9 @@ void Z::print() const
   }
 }
 
+
+// Virtual copy function
+Particle *Z::clone() const
+{
+  return new Z(*this);
+}
@@ -10,12 +10,14 @@
 
  
 // Z class 
-class Z : public Boson
+class Z final : public Boson
 {
 public:
   // Constructors
   Z(std::unique_ptr<FourMomentum> four_momentum);
   Z(const std::string &label, std::unique_ptr<FourMomentum> four_momentum);
+  // Trusted constructor, skipping the four-momentum checks
+  Z(Trusted, std::unique_ptr<FourMomentum> four_momentum);
   // Default constructor
   Z();
 
@@ -28,6 +30,7 @@ public:
 
   // Virtual function overrides
   virtual void print() const override;
+  virtual Particle *clone() const override;
 };
 
 #endif // Z_H
@@ -1,5 +1,8 @@
 #include "helper_functions.h"
 
+#include <cmath>
+#include <random>
+
 // Functions to convert to string
 std::string to_string(Colour colour)
 {
@@ -40,156 +43,31 @@ std::string to_string(DecayType decay_type)
   }
 }
 
-// Functions to assist enum classes
+// Functions to assist enum classes, using the packed colour algebra
 bool is_anti_colour(Colour colour)
 {
-  switch (colour)
+  if (colour == Colour::None)
   {
-  case Colour::Red:
-    return false;
-  case Colour::Green:
-    return false;
-  case Colour::Blue:
-    return false;
-  case Colour::AntiRed:
-    return true;
-  case Colour::AntiGreen:
-    return true;
-  case Colour::AntiBlue:
-    return true;
-  case Colour::None:
     throw std::invalid_argument("Error: Cannot have AntiNone Colour");
-  default:
-    throw std::invalid_argument("Error: Unrecognised Colour");
   }
+  return ColourAlgebra::is_anti(colour);
 }
 Colour get_anti_colour(Colour colour)
 {
-  switch (colour)
-  {
-  case Colour::Red:
-    return Colour::AntiRed;
-  case Colour::Green:
-    return Colour::AntiGreen;
-  case Colour::Blue:
-    return Colour::AntiBlue;
-  case Colour::AntiRed:
-    return Colour::Red;
-  case Colour::AntiGreen:
-    return Colour::Green;
-  case Colour::AntiBlue:
-    return Colour::Blue;
-  case Colour::None:
-    return Colour::None;
-  default:
-    throw std::invalid_argument("Error: Unrecognised Colour");
-  }
+  return ColourAlgebra::anti(colour);
 }
 bool is_colour_neutral(Colour colour1, Colour colour2, Colour colour3)
 {
-  int red_count = 0;
-  int blue_count = 0;
-  int green_count = 0;
-
-  if (!(colour3 == Colour::None))
-  {
-    for (Colour &colour : std::vector<Colour>{colour1, colour2, colour3})
-    {
-      switch (colour)
-      {
-      case Colour::Red:
-        red_count++;
-        break;
-      case Colour::Green:
-        green_count++;
-        break;
-      case Colour::Blue:
-        blue_count++;
-        break;
-      case Colour::AntiRed:
-        red_count--;
-        break;
-      case Colour::AntiGreen:
-        green_count--;
-        break;
-      case Colour::AntiBlue:
-        blue_count--;
-        break;
-      case Colour::None:
-        break;
-      default:
-        throw std::invalid_argument("Error: Unrecognised Colour");
-      }
-    }
-    if ((red_count == blue_count && blue_count == green_count))
-    {
-      return true;
-    }
-    else
-      return false;
-  }
-  else
-  {
-    if (colour1 == get_anti_colour(colour2))
-    {
-      return true;
-    }
-    else
-      return false;
-  }
+  return ColourAlgebra::three_body_neutral[ColourAlgebra::index(colour1)][ColourAlgebra::index(colour2)][ColourAlgebra::index(colour3)];
 }
-bool is_colour_neutral(std::vector<Colour> colour_charges)
+bool is_colour_neutral(const std::vector<Colour> &colour_charges)
 {
-  int red_count = 0;
-  int blue_count = 0;
-  int green_count = 0;
-
-  if (!(colour_charges.size() == 2))
+  PackedColour net_colour = 0;
+  for (Colour colour : colour_charges)
   {
-    for (Colour &colour : colour_charges)
-    {
-      switch (colour)
-      {
-      case Colour::Red:
-        red_count++;
-        break;
-      case Colour::Green:
-        green_count++;
-        break;
-      case Colour::Blue:
-        blue_count++;
-        break;
-      case Colour::AntiRed:
-        red_count--;
-        break;
-      case Colour::AntiGreen:
-        green_count--;
-        break;
-      case Colour::AntiBlue:
-        blue_count--;
-        break;
-      case Colour::None:
-        break;
-      default:
-        throw std::invalid_argument("Error: Unrecognised Colour");
-      }
-    }
-    if ((red_count == blue_count && blue_count == green_count))
-    {
-      return true;
-    }
-    else
-      return false;
-  }
-  else
-  {
-    if (colour_charges[0] == get_anti_colour(colour_charges[1]))
-    {
-      return true;
-    }
-    else
-      return false;
+    net_colour = ColourAlgebra::combine(net_colour, ColourAlgebra::pack(colour));
   }
+  return ColourAlgebra::is_neutral(net_colour);
 }
 
 bool contains_decay_type(const std::vector<DecayType> &decay_types, DecayType type_to_find)
@@ -242,7 +120,7 @@ double energy_sum_three_body(double p1x, double p2x, double p2y, double m1, doub
   return E1 + E2 + E3;
 }
 // Function to calculate the momentum of products in a three body decay, utilising the bisection method for two body decay
-std::vector<double> find_momentum_of_products_three_body(double product1_rest_mass, double product2_rest_mass, double product3_rest_mass, double decay_particle_rest_mass, double tolerance)
+std::array<double, 5> find_momentum_of_products_three_body(double product1_rest_mass, double product2_rest_mass, double product3_rest_mass, double decay_particle_rest_mass, double tolerance)
 {
   double p1x = 0.0;
   double p2x = 0.0;
@@ -277,7 +155,7 @@ std::vector<double> find_momentum_of_products_three_body(double product1_rest_ma
     throw std::runtime_error("Error: Cannot determine 3 body decay problem momenta.");
   }
   // Return the momentum components
-  return std::vector<double>{p1x, p2x, p2y, p3x, p3y};
+  return {p1x, p2x, p2y, p3x, p3y};
 }
 
 // Clears console screen based on operating system
@@ -475,6 +353,64 @@ void fill_catalogue(ParticleCatalogue<Particle> &catalogue)
   fill_anti_leptons(catalogue);
   fill_anti_quarks(catalogue);
 }
+// Fill catalogue with random particles, each component of their momentum drawn from a normal distribution
+void fill_random_particles(ParticleCatalogue<Particle> &catalogue, size_t number_of_particles, std::uint64_t seed, double momentum_spread)
+{
+  std::mt19937_64 generator(seed);
+  std::uniform_int_distribution<int> kind(0, 11);
+  std::normal_distribution<double> momentum(0.0, momentum_spread);
+  for (size_t i = 0; i < number_of_particles; ++i)
+  {
+    Particle *particle;
+    switch (kind(generator))
+    {
+    case 0:
+      particle = new Electron();
+      break;
+    case 1:
+      particle = new Electron(-1);
+      break;
+    case 2:
+      particle = new Muon();
+      break;
+    case 3:
+      particle = new Muon(-1);
+      break;
+    case 4:
+      particle = new Up();
+      break;
+    case 5:
+      particle = new Up(true);
+      break;
+    case 6:
+      particle = new Down();
+      break;
+    case 7:
+      particle = new Down(true);
+      break;
+    case 8:
+      particle = new Strange();
+      break;
+    case 9:
+      particle = new Bottom(true);
+      break;
+    case 10:
+      particle = new Photon();
+      break;
+    default:
+      particle = new Gluon();
+      break;
+    }
+    // On shell by construction, so the trusted setter is used. The checked one would reject massless
+    // particles this energetic, as rounding alone moves their invariant mass by more than its tolerance.
+    const double px = momentum(generator), py = momentum(generator), pz = momentum(generator);
+    const double mass = particle->get_rest_mass();
+    particle->set_trusted_four_momentum(FourMomentum(std::sqrt(mass * mass + px * px + py * py + pz * pz), px, py, pz));
+    const std::string flavour = (particle->get_flavour() == "none") ? "" : " (" + particle->get_flavour() + ")";
+    particle->set_label("random " + particle->get_type() + flavour + " " + std::to_string(i));
+    catalogue.add_particle(particle);
+  }
+}
 
 // Sort catalogue by values
 void sort_by_rest_mass(ParticleCatalogue<Particle> &catalogue)
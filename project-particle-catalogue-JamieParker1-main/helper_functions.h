@@ -4,6 +4,7 @@
 #include "FourMomentum.h"
 #include "Particle.h"
 #include "ParticleCatalogue.h"
+#include "ColourAlgebra.h"
 
 #include "showcase.h"
 #include "user_interface.h"
@@ -25,6 +26,7 @@
 #include "quarks/QuarkTemplate.h"
 #include "quarks/IndividualQuarks.h"
 
+#include <array>
 #include <vector>
 #include <thread> 
 #include <chrono> 
@@ -42,7 +44,7 @@ bool is_anti_colour(Colour colour);
 Colour get_anti_colour(Colour colour);
 // Check if group of colours is colour neutral
 bool is_colour_neutral(Colour colour1, Colour colour2, Colour colour3 = Colour::None);
-bool is_colour_neutral(std::vector<Colour> colour_charges);
+bool is_colour_neutral(const std::vector<Colour> &colour_charges);
 // Checks if a decay type is in a vector
 bool contains_decay_type(const std::vector<DecayType> &decay_types, DecayType type_to_find);
 // Calculates the total energy of two particles from their momentum
@@ -51,8 +53,8 @@ double energy_sum(double momentum, double product1_rest_mass, double product2_re
 double find_momentum_of_products(double product1_rest_mass, double product2_rest_mass, double decay_particle_rest_mass, double tolerance = 1e-6);
 // Calculates the total energy of three particles from their momentum
 double energy_sum_three_body(double p1x, double p2x, double p2y, double m1, double m2, double m3);
-// Finds the momentum of decay products for three bodies
-std::vector<double> find_momentum_of_products_three_body(double product1_rest_mass, double product2_rest_mass, double product3_rest_mass, double decay_particle_rest_mass, double tolerance = 1e-5);
+// Finds the momentum of decay products for three bodies: p1x, p2x, p2y, p3x, p3y
+std::array<double, 5> find_momentum_of_products_three_body(double product1_rest_mass, double product2_rest_mass, double product3_rest_mass, double decay_particle_rest_mass, double tolerance = 1e-5);
 
 // Clears the output screen
 void clear_screen();
@@ -72,6 +74,8 @@ void fill_anti_quarks(ParticleCatalogue<Particle> &catalogue);
 void fill_particles(ParticleCatalogue<Particle> &catalogue);
 void fill_anti_particles(ParticleCatalogue<Particle> &catalogue);
 void fill_catalogue(ParticleCatalogue<Particle> &catalogue);
+// Fill catalogue with leptons, quarks, photons and gluons of random type and momentum, the same for a given seed
+void fill_random_particles(ParticleCatalogue<Particle> &catalogue, size_t number_of_particles, std::uint64_t seed, double momentum_spread = 20000);
 
 // Sort catalogue classes by a property, only for a catalogue of Particle type
 void sort_by_rest_mass(ParticleCatalogue<Particle> &catalogue);
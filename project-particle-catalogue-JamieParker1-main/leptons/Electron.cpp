@@ -1,21 +1,25 @@
 #include "Electron.h"
 
 // Constructor without label with validity check
-Electron::Electron(std::unique_ptr<FourMomentum> four_momentum, const std::vector<double> &energy_deposited_in_layers, int lepton_number)
+Electron::Electron(std::unique_ptr<FourMomentum> four_momentum, const LayerEnergies &energy_deposited_in_layers, int lepton_number)
     : Lepton("electron", (lepton_number == 1) ? -1 : 1, Mass::electron, std::move(four_momentum), lepton_number)
 {
   set_energy_deposited_in_layers(energy_deposited_in_layers);
 }
 
 // Constructor with label with validity check
-Electron::Electron(const std::string &label, std::unique_ptr<FourMomentum> four_momentum, const std::vector<double> &energy_deposited_in_layers, int lepton_number)
+Electron::Electron(const std::string &label, std::unique_ptr<FourMomentum> four_momentum, const LayerEnergies &energy_deposited_in_layers, int lepton_number)
     : Lepton("electron", label, (lepton_number == 1) ? -1 : 1, Mass::electron, std::move(four_momentum), lepton_number)
 {
   set_energy_deposited_in_layers(energy_deposited_in_layers);
 }
 
+// Trusted constructor, the deposits are taken without checking their sum
+Electron::Electron(Trusted, std::unique_ptr<FourMomentum> four_momentum, const LayerEnergies &energy_deposited_in_layers, int lepton_number)
+    : Lepton(trusted, "electron", (lepton_number == 1) ? -1 : 1, Mass::electron, std::move(four_momentum), lepton_number), energy_deposited_in_layers(energy_deposited_in_layers) {}
+
 // Default constructor
-Electron::Electron(int lepton_number) : Lepton("electron", (lepton_number == 1) ? -1 : 1, Mass::electron, lepton_number), energy_deposited_in_layers(std::vector<double>{0.12775, 0.12775, 0.12775, 0.12775}) {}
+Electron::Electron(int lepton_number) : Lepton("electron", (lepton_number == 1) ? -1 : 1, Mass::electron, lepton_number), energy_deposited_in_layers{0.12775, 0.12775, 0.12775, 0.12775} {}
 
 // Copy constructor
 Electron::Electron(const Electron &other)
@@ -23,7 +27,7 @@ Electron::Electron(const Electron &other)
 
 // Move constructor
 Electron::Electron(Electron &&other) noexcept
-    : Lepton(std::move(other)), energy_deposited_in_layers(std::move(other.energy_deposited_in_layers)) {}
+    : Lepton(std::move(other)), energy_deposited_in_layers(other.energy_deposited_in_layers) {}
 
 // Destructor
 Electron::~Electron() {}
@@ -45,13 +49,13 @@ Electron &Electron::operator=(Electron &&other) noexcept
   if (this != &other)
   {
     Lepton::operator=(std::move(other));
-    energy_deposited_in_layers = std::move(other.energy_deposited_in_layers);
+    energy_deposited_in_layers = other.energy_deposited_in_layers;
   }
   return *this;
 }
 
 // Getter and Setter implementations
-void Electron::set_energy_deposited_in_layers(const std::vector<double> &energies)
+void Electron::set_energy_deposited_in_layers(const LayerEnergies &energies)
 {
   if (is_valid_energy_deposit(energies))
   {
@@ -63,7 +67,7 @@ void Electron::set_energy_deposited_in_layers(const std::vector<double> &energie
   }
 }
 
-const std::vector<double> &Electron::get_energy_deposited_in_layers() const
+const LayerEnergies &Electron::get_energy_deposited_in_layers() const
 {
   return energy_deposited_in_layers;
 }
@@ -77,8 +81,9 @@ void Electron::set_four_momentum(std::unique_ptr<FourMomentum> four_momentum)
   else if (Particle::is_invariant_mass_valid(four_momentum->invariant_mass()))
   {
     this->four_momentum = std::move(four_momentum);
+    mark_kinematics_changed();
     double equal_energy_split = this->four_momentum->get_energy() / 4;
-    set_energy_deposited_in_layers(std::vector<double>{equal_energy_split, equal_energy_split, equal_energy_split, equal_energy_split});
+    energy_deposited_in_layers = {equal_energy_split, equal_energy_split, equal_energy_split, equal_energy_split}; // Sums to the energy by construction
   }
   else
   {
@@ -86,6 +91,29 @@ void Electron::set_four_momentum(std::unique_ptr<FourMomentum> four_momentum)
   }
 }
 
+// Rescales the layer deposits to the new energy without revalidating, so each layer keeps its share
+// of the energy, e.g. when the electron is boosted into another frame. Splits the energy equally as
+// set_four_momentum does if there are no deposits to rescale.
+void Electron::set_trusted_four_momentum(const FourMomentum &four_momentum)
+{
+  const double old_energy = std::accumulate(energy_deposited_in_layers.begin(), energy_deposited_in_layers.end(), 0.0);
+  Particle::set_trusted_four_momentum(four_momentum);
+  const double new_energy = this->four_momentum->get_energy();
+  if (old_energy > 0)
+  {
+    const double scale = new_energy / old_energy;
+    for (double &energy : energy_deposited_in_layers)
+    {
+      energy *= scale;
+    }
+  }
+  else
+  {
+    double equal_energy_split = new_energy / 4;
+    energy_deposited_in_layers = {equal_energy_split, equal_energy_split, equal_energy_split, equal_energy_split};
+  }
+}
+
 // Override the print function
 void Electron::print() const
 {
@@ -102,7 +130,7 @@ void Electron::print() const
 }
 
 // Utility function to check energy validity
-bool Electron::is_valid_energy_deposit(const std::vector<double> &energy_deposited_in_layers) const
+bool Electron::is_valid_energy_deposit(const LayerEnergies &energy_deposited_in_layers) const
 {
   if (four_momentum)
   {
@@ -119,3 +147,9 @@ bool Electron::is_valid_energy_deposit(const std::vector<double> &energy_deposit
     throw std::runtime_error("Error: No four momentum initialised");
   }
 }
+
+// Virtual copy function
+Particle *Electron::clone() const
+{
+  return new Electron(*this);
+}
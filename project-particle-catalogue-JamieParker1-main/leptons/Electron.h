@@ -4,6 +4,7 @@
 #include "Lepton.h"
 #include "../FourMomentum.h"
 
+#include <array>
 #include <vector>
 #include <string>
 #include <iostream>
@@ -12,17 +13,23 @@
 #include <stdexcept> 
 #include <iomanip>
  
+// Energy deposited in each calorimeter layer, stored inline in the electron
+constexpr size_t number_of_calorimeter_layers = 4;
+using LayerEnergies = std::array<double, number_of_calorimeter_layers>;
+
 // Electron class 
-class Electron : public Lepton
+class Electron final : public Lepton
 {
 private:
-  std::vector<double> energy_deposited_in_layers; // Specific to electrons
-  bool is_valid_energy_deposit(const std::vector<double>& energy_deposited_in_layers) const;
+  LayerEnergies energy_deposited_in_layers; // Specific to electrons
+  bool is_valid_energy_deposit(const LayerEnergies &energy_deposited_in_layers) const;
 
 public:
   // Constructors
-  Electron(std::unique_ptr<FourMomentum> four_momentum, const std::vector<double> &energy_deposited_in_layers, int lepton_number = 1);
-  Electron(const std::string &label, std::unique_ptr<FourMomentum> four_momentum, const std::vector<double> &energy_deposited_in_layers, int lepton_number = 1);
+  Electron(std::unique_ptr<FourMomentum> four_momentum, const LayerEnergies &energy_deposited_in_layers, int lepton_number = 1);
+  Electron(const std::string &label, std::unique_ptr<FourMomentum> four_momentum, const LayerEnergies &energy_deposited_in_layers, int lepton_number = 1);
+  // Trusted constructor, skipping the four-momentum checks
+  Electron(Trusted, std::unique_ptr<FourMomentum> four_momentum, const LayerEnergies &energy_deposited_in_layers, int lepton_number = 1);
   // Default constructor
   Electron(int lepton_number = 1);
 
@@ -34,12 +41,17 @@ public:
   Electron &operator=(Electron &&other) noexcept; // Move assignment operator
 
   // Getters and Setters
-  void set_energy_deposited_in_layers(const std::vector<double> &energies);
-  const std::vector<double> &get_energy_deposited_in_layers() const;
+  void set_energy_deposited_in_layers(const LayerEnergies &energies);
+  const LayerEnergies &get_energy_deposited_in_layers() const;
+  // Trusted setter for deposits known to sum to the energy, skipping the check
+  void set_trusted_energy_deposited_in_layers(const LayerEnergies &energies) { energy_deposited_in_layers = energies; }
 
   // Virtual function overrides
   virtual void print() const override;
+  virtual Particle *clone() const override;
+  virtual FlavourTag get_flavour_tag() const override { return FlavourTag::Electron; }
   virtual void set_four_momentum(std::unique_ptr<FourMomentum> fourMomentum) override;
+  virtual void set_trusted_four_momentum(const FourMomentum &four_momentum) override;
 };
 
 #endif // ELECTRON_H
@@ -0,0 +1,137 @@
+#include "ElectronShower.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+
+// Regularised lower incomplete gamma function P(a, x), from its series below a + 1 and from the
+// continued fraction of the upper function above it (Numerical Recipes, section 6.2)
+double regularised_lower_gamma(double a, double x)
+{
+  if (x <= 0)
+  {
+    return 0;
+  }
+  const double epsilon = std::numeric_limits<double>::epsilon();
+  const double log_prefactor = a * std::log(x) - x - std::lgamma(a);
+  if (x < a + 1)
+  {
+    double term = 1 / a;
+    double sum = term;
+    for (double n = a + 1; n < a + 500; n += 1)
+    {
+      term *= x / n;
+      sum += term;
+      if (std::abs(term) < std::abs(sum) * epsilon)
+      {
+        break;
+      }
+    }
+    return std::min(1.0, sum * std::exp(log_prefactor));
+  }
+
+  // Modified Lentz evaluation of the continued fraction for Q(a, x)
+  const double tiny = std::numeric_limits<double>::min() / epsilon;
+  double b = x + 1 - a;
+  double c = 1 / tiny;
+  double d = 1 / b;
+  double fraction = d;
+  for (int i = 1; i < 500; ++i)
+  {
+    const double an = -i * (i - a);
+    b += 2;
+    d = an * d + b;
+    d = std::abs(d) < tiny ? tiny : d;
+    c = b + an / c;
+    c = std::abs(c) < tiny ? tiny : c;
+    d = 1 / d;
+    const double delta = d * c;
+    fraction *= delta;
+    if (std::abs(delta - 1) < epsilon)
+    {
+      break;
+    }
+  }
+  return std::max(0.0, 1 - std::exp(log_prefactor) * fraction);
+}
+
+// Constructor
+ShowerModel::ShowerModel(double critical_energy, double layer_thickness, double scale_parameter)
+    : critical_energy(critical_energy), layer_thickness(layer_thickness), scale_parameter(scale_parameter)
+{
+  if (critical_energy <= 0 || layer_thickness <= 0 || scale_parameter <= 0)
+  {
+    throw std::invalid_argument("Error: Shower model parameters must be greater than 0.");
+  }
+}
+
+double ShowerModel::get_shower_maximum(double energy) const
+{
+  return std::log(energy / critical_energy) - 0.5;
+}
+
+// Below the critical energy the maximum would sit in front of the calorimeter, so the profile
+// is limited to a pure exponential
+double ShowerModel::get_shape_parameter(double energy) const
+{
+  return std::max(1.0, scale_parameter * get_shower_maximum(energy) + 1);
+}
+
+LayerEnergies ShowerModel::get_layer_energies(double energy) const
+{
+  LayerEnergies deposits{};
+  if (energy <= 0)
+  {
+    return deposits;
+  }
+  const double a = get_shape_parameter(energy);
+  const double step = scale_parameter * layer_thickness;
+  double contained = 0;
+  double deposited = 0;
+  for (size_t layer = 0; layer + 1 < deposits.size(); ++layer)
+  {
+    const double fraction = regularised_lower_gamma(a, step * (layer + 1));
+    deposits[layer] = energy * (fraction - contained);
+    deposited += deposits[layer];
+    contained = fraction;
+  }
+  // Last layer absorbs the tail and the leakage so the deposits sum to the energy
+  deposits.back() = std::max(0.0, energy - deposited);
+  return deposits;
+}
+
+void ShowerModel::get_layer_energies(const double *energies, LayerEnergies *deposits, size_t count) const
+{
+  for (size_t i = 0; i < count; ++i)
+  {
+    deposits[i] = get_layer_energies(energies[i]);
+  }
+}
+
+void ShowerModel::get_layer_energies(const std::vector<double> &energies, std::vector<LayerEnergies> &deposits) const
+{
+  deposits.resize(energies.size());
+  get_layer_energies(energies.data(), deposits.data(), energies.size());
+}
+
+void ShowerModel::deposit(const std::vector<Electron *> &electrons) const
+{
+  // Gather the energies into one column so the profile is evaluated in a single pass
+  std::vector<double> energies(electrons.size());
+  for (size_t i = 0; i < electrons.size(); ++i)
+  {
+    if (!electrons[i])
+    {
+      throw std::invalid_argument("Error: Electron is null.");
+    }
+    energies[i] = electrons[i]->get_four_momentum().get_energy();
+  }
+  std::vector<LayerEnergies> deposits;
+  get_layer_energies(energies, deposits);
+  // The last layer closes the sum by construction, so the deposits skip revalidation
+  for (size_t i = 0; i < electrons.size(); ++i)
+  {
+    electrons[i]->set_trusted_energy_deposited_in_layers(deposits[i]);
+  }
+}
@@ -0,0 +1,49 @@
+#ifndef ELECTRON_SHOWER_H
+#define ELECTRON_SHOWER_H
+
+#include "Electron.h"
+
+#include <vector>
+
+// Longitudinal electromagnetic shower model used to fill an electron's calorimeter layers.
+// The mean energy profile follows the Gamma distribution (Longo and Sestili)
+//   dE/dt = E b (b t)^(a - 1) e^(-b t) / Gamma(a)
+// in depth t measured in radiation lengths, with the maximum at t_max = ln(E / E_c) - 0.5 and
+// a = b t_max + 1. The energy in a layer is E times the difference of the regularised incomplete
+// gamma function across its depth, and the last layer also takes whatever leaks out of the back,
+// so the deposits always sum to the electron's energy.
+class ShowerModel
+{
+private:
+  double critical_energy;  // MeV, energy below which ionisation losses dominate
+  double layer_thickness;  // Radiation lengths per calorimeter layer
+  double scale_parameter;  // b, close to 0.5 for most absorbers
+
+public:
+  // Constructor, defaults describe an iron-like absorber with 6 radiation lengths per layer
+  explicit ShowerModel(double critical_energy = 21.0, double layer_thickness = 6.0, double scale_parameter = 0.5);
+
+  // Getters
+  double get_critical_energy() const { return critical_energy; }
+  double get_layer_thickness() const { return layer_thickness; }
+  double get_scale_parameter() const { return scale_parameter; }
+
+  // Returns the shape parameter a of the profile for an electron energy in MeV
+  double get_shape_parameter(double energy) const;
+  // Returns the depth of the shower maximum in radiation lengths
+  double get_shower_maximum(double energy) const;
+
+  // Returns the mean energy deposited in each layer by an electron of the given energy
+  LayerEnergies get_layer_energies(double energy) const;
+  // Fills the layer deposits for a column of electron energies
+  void get_layer_energies(const double *energies, LayerEnergies *deposits, size_t count) const;
+  void get_layer_energies(const std::vector<double> &energies, std::vector<LayerEnergies> &deposits) const;
+
+  // Sets the layer deposits of every electron in a batch from its four-momentum energy
+  void deposit(const std::vector<Electron *> &electrons) const;
+};
+
+// Regularised lower incomplete gamma function P(a, x)
+double regularised_lower_gamma(double a, double x);
+
+#endif // ELECTRON_SHOWER_H
@@ -11,6 +11,10 @@ Lepton::Lepton(std::string type, int charge, double rest_mass, std::unique_ptr<F
 Lepton::Lepton(std::string type, const std::string &label, int charge,  double rest_mass, std::unique_ptr<FourMomentum> four_momentum, int lepton_number, std::vector<DecayType> possible_decay_types)
     : Particle((lepton_number == 1) ? type : "anti" + type, label, charge, 0.5, rest_mass, std::move(four_momentum), possible_decay_types), lepton_number(lepton_number) {}
 
+// Protected trusted constructor without label with four momentum
+Lepton::Lepton(Trusted, std::string type, int charge, double rest_mass, std::unique_ptr<FourMomentum> four_momentum, int lepton_number, std::vector<DecayType> possible_decay_types)
+    : Particle(trusted, (lepton_number == 1) ? type : "anti" + type, charge, 0.5, rest_mass, std::move(four_momentum), std::move(possible_decay_types)), lepton_number(lepton_number) {}
+
 // Constructor without label without four momentum
 Lepton::Lepton(std::string type, int charge, double rest_mass, int lepton_number, std::vector<DecayType> possible_decay_types)
     : Particle((lepton_number == 1) ? type : "anti" + type, charge, 0.5, rest_mass, possible_decay_types), lepton_number(lepton_number) {}
@@ -63,4 +67,10 @@ void Lepton::print() const
   // Print Particle and Quark attributes side by side
   std::cout << std::setw(columnWidth) << "\033[1mLepton number:\033[0m " << lepton_number << std::endl;
 
-}
\ No newline at end of file
+}
+
+// Virtual copy function
+Particle *Lepton::clone() const
+{
+  return new Lepton(*this);
+}
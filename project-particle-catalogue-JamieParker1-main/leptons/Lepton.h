@@ -21,6 +21,8 @@ protected:
   Lepton(std::string type, int charge, double rest_mass, std::unique_ptr<FourMomentum> fourMomentum, int lepton_number, std::vector<DecayType> possible_decay_types = {DecayType::None});
   // Constructor with label
   Lepton(std::string type, const std::string &label, int charge, double rest_mass, std::unique_ptr<FourMomentum> fourMomentum, int lepton_number, std::vector<DecayType> possible_decay_types = {DecayType::None});
+  // Trusted constructor without label
+  Lepton(Trusted, std::string type, int charge, double rest_mass, std::unique_ptr<FourMomentum> four_momentum, int lepton_number, std::vector<DecayType> possible_decay_types = {DecayType::None});
 
 public:
   // Default constructor
@@ -52,6 +54,7 @@ public:
 
   // Virtual print function
   virtual void print() const override;
+  virtual Particle *clone() const override;
 };
 
 #endif // LEPTON_H
\ No newline at end of file
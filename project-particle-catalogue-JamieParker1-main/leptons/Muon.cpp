@@ -8,6 +8,10 @@ Muon::Muon(std::unique_ptr<FourMomentum> four_momentum, bool is_isolated, int le
 Muon::Muon(const std::string &label, std::unique_ptr<FourMomentum> four_momentum, bool is_isolated, int lepton_number)
     : Lepton("muon", label, (lepton_number == 1) ? -1 : 1, Mass::muon, std::move(four_momentum), lepton_number), is_isolated(is_isolated) {} // Muons have a charge of -1
 
+// Trusted constructor for Muon
+Muon::Muon(Trusted, std::unique_ptr<FourMomentum> four_momentum, bool is_isolated, int lepton_number)
+    : Lepton(trusted, "muon", (lepton_number == 1) ? -1 : 1, Mass::muon, std::move(four_momentum), lepton_number), is_isolated(is_isolated) {}
+
 // Default constructor for MUon
 Muon::Muon(int lepton_number) : Lepton("muon", (lepton_number == 1) ? -1 : 1, Mass::muon, lepton_number), is_isolated(true) {}
 
@@ -66,3 +70,9 @@ void Muon::print() const
   std::cout << "\033[1m\033[4mMuon-Specific Properties:\033[0m\n";
   std::cout << "\033[1mIs Isolated: \033[0m" << (is_isolated ? "Yes" : "No") << std::endl;
 }
+
+// Virtual copy function
+Particle *Muon::clone() const
+{
+  return new Muon(*this);
+}
@@ -8,7 +8,7 @@
 #include <string>
 #include <iostream> 
 
-class Muon : public Lepton
+class Muon final : public Lepton
 {
 private:
   bool is_isolated; // 0 for false 1 for true
@@ -17,6 +17,8 @@ public:
   // Constructors
   Muon(std::unique_ptr<FourMomentum> four_momentum, bool is_isolated, int lepton_number = 1);
   Muon(const std::string &label, std::unique_ptr<FourMomentum> four_momentum, bool is_isolated, int lepton_number = 1);
+  // Trusted constructor, skipping the four-momentum checks
+  Muon(Trusted, std::unique_ptr<FourMomentum> four_momentum, bool is_isolated, int lepton_number = 1);
   // Default constructor
   Muon(int lepton_number = 1);
 
@@ -41,6 +43,8 @@ public:
 
   // Override the print function to include muon-specific information
   virtual void print() const override;
+  virtual Particle *clone() const override;
+  virtual FlavourTag get_flavour_tag() const override { return FlavourTag::Muon; }
 };
 
 #endif // MUON_H
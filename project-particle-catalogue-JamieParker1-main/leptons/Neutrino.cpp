@@ -2,22 +2,26 @@
 
 // Constructor without label
 Neutrino::Neutrino(std::unique_ptr<FourMomentum> four_momentum, std::string flavour, bool has_interacted, int lepton_number)
-    : Lepton("neutrino", 0, determine_neutrino_mass(flavour), std::move(four_momentum), lepton_number), flavour(std::move(flavour)), has_interacted(has_interacted) {}
+    : Lepton("neutrino", 0, determine_neutrino_mass(flavour), std::move(four_momentum), lepton_number), flavour(std::move(flavour)), flavour_tag(determine_flavour_tag(this->flavour)), has_interacted(has_interacted) {}
 
 // Constructor with label
 Neutrino::Neutrino(const std::string &label, std::unique_ptr<FourMomentum> four_momentum, std::string flavour, bool has_interacted, int lepton_number)
-    : Lepton("neutrino", label, 0, determine_neutrino_mass(flavour), std::move(four_momentum), lepton_number), flavour(std::move(flavour)), has_interacted(has_interacted) {}
+    : Lepton("neutrino", label, 0, determine_neutrino_mass(flavour), std::move(four_momentum), lepton_number), flavour(std::move(flavour)), flavour_tag(determine_flavour_tag(this->flavour)), has_interacted(has_interacted) {}
+
+// Trusted constructor
+Neutrino::Neutrino(Trusted, std::unique_ptr<FourMomentum> four_momentum, std::string flavour, bool has_interacted, int lepton_number)
+    : Lepton(trusted, "neutrino", 0, determine_neutrino_mass(flavour), std::move(four_momentum), lepton_number), flavour(std::move(flavour)), flavour_tag(determine_flavour_tag(this->flavour)), has_interacted(has_interacted) {}
 
 // Default constructor
-Neutrino::Neutrino(std::string flavour, int lepton_number) : Lepton("neutrino", 0, determine_neutrino_mass(flavour), lepton_number), flavour(flavour), has_interacted(false) {}
+Neutrino::Neutrino(std::string flavour, int lepton_number) : Lepton("neutrino", 0, determine_neutrino_mass(flavour), lepton_number), flavour(flavour), flavour_tag(determine_flavour_tag(this->flavour)), has_interacted(false) {}
 
 // Copy constructor
 Neutrino::Neutrino(const Neutrino &other)
-    : Lepton(other), flavour(other.flavour), has_interacted(other.has_interacted) {}
+    : Lepton(other), flavour(other.flavour), flavour_tag(other.flavour_tag), has_interacted(other.has_interacted) {}
 
 // Move constructor
 Neutrino::Neutrino(Neutrino &&other) noexcept
-    : Lepton(std::move(other)), flavour(std::move(other.flavour)), has_interacted(other.has_interacted) {}
+    : Lepton(std::move(other)), flavour(std::move(other.flavour)), flavour_tag(other.flavour_tag), has_interacted(other.has_interacted) {}
 
 // Destructor
 Neutrino::~Neutrino() {}
@@ -29,6 +33,7 @@ Neutrino &Neutrino::operator=(const Neutrino &other)
   {
     Lepton::operator=(other);
     flavour = other.flavour;
+    flavour_tag = other.flavour_tag;
     has_interacted = other.has_interacted;
   }
   return *this;
@@ -41,6 +46,7 @@ Neutrino &Neutrino::operator=(Neutrino &&other) noexcept
   {
     Lepton::operator=(std::move(other));
     flavour = std::move(other.flavour);
+    flavour_tag = other.flavour_tag;
     has_interacted = other.has_interacted;
   }
   return *this;
@@ -55,9 +61,27 @@ void Neutrino::set_has_interacted(bool has_interacted)
 void Neutrino::set_flavour(std::string flavour)
 {
   this->rest_mass = determine_neutrino_mass(flavour);
+  this->flavour_tag = determine_flavour_tag(flavour);
   this->flavour = std::move(flavour);
 }
 
+FlavourTag Neutrino::determine_flavour_tag(const std::string &flavour)
+{
+  if (flavour == "electron")
+  {
+    return FlavourTag::Electron;
+  }
+  else if (flavour == "muon")
+  {
+    return FlavourTag::Muon;
+  }
+  else if (flavour == "tau")
+  {
+    return FlavourTag::Tau;
+  }
+  return FlavourTag::None;
+}
+
 double Neutrino::determine_neutrino_mass(std::string flavour)
 {
   if (flavour == "electron")
@@ -96,3 +120,9 @@ void Neutrino::print() const
   std::cout << std::setw(columnWidth) << "\033[1mNeutrino Flavour:\033[0m" << flavour << std::endl;
   std::cout << std::setw(columnWidth) << "\033[1mHas Interacted:\033[0m" << (has_interacted ? "Yes" : "No") << std::endl;
 }
+
+// Virtual copy function
+Particle *Neutrino::clone() const
+{
+  return new Neutrino(*this);
+}
@@ -10,17 +10,21 @@
 #include <iomanip>
 
 // Neutrino class
-class Neutrino : public Lepton
+class Neutrino final : public Lepton
 {
 private:
   std::string flavour; 
+  FlavourTag flavour_tag; // Kept in step with flavour, so reading it needs no string compare
   bool has_interacted;
   double determine_neutrino_mass(std::string flavour); 
+  static FlavourTag determine_flavour_tag(const std::string &flavour);
 
 public:
   // Constructors
   Neutrino(std::unique_ptr<FourMomentum> four_momentum, std::string flavour, bool has_interacted, int lepton_number);
   Neutrino(const std::string &label, std::unique_ptr<FourMomentum> four_momentum, std::string flavour, bool has_interacted, int lepton_number);
+  // Trusted constructor, skipping the four-momentum checks
+  Neutrino(Trusted, std::unique_ptr<FourMomentum> four_momentum, std::string flavour, bool has_interacted, int lepton_number);
   // Default constructor
   Neutrino(std::string flavour = "none", int lepton_number = 1);
 
@@ -36,10 +40,12 @@ public:
   void set_flavour(std::string flavour);
 
   std::string get_flavour() const override {return flavour;}
+  FlavourTag get_flavour_tag() const override {return flavour_tag;}
   bool get_has_interacted() const {return has_interacted;}
 
   // Virtual function overrides
   virtual void print() const override;
+  virtual Particle *clone() const override;
 };
 
 #endif // NEUTRINO_H
@@ -8,6 +8,10 @@ Tau::Tau(std::unique_ptr<FourMomentum> four_momentum, std::vector<std::unique_pt
 Tau::Tau(const std::string &label, std::unique_ptr<FourMomentum> four_momentum, std::vector<std::unique_ptr<Particle>> decay_products, int lepton_number)
     : Lepton("tau", label, (lepton_number == 1) ? -1 : 1, Mass::tau, std::move(four_momentum), lepton_number, std::vector<DecayType>{DecayType::Weak}) {}
 
+// Trusted constructor
+Tau::Tau(Trusted, std::unique_ptr<FourMomentum> four_momentum, int lepton_number)
+    : Lepton(trusted, "tau", (lepton_number == 1) ? -1 : 1, Mass::tau, std::move(four_momentum), lepton_number, std::vector<DecayType>{DecayType::Weak}) {}
+
 // Default constructor
 Tau::Tau(int lepton_number) : Lepton("tau", (lepton_number == 1) ? -1 : 1, Mass::tau, lepton_number, std::vector<DecayType>{DecayType::Weak}) {}
 
@@ -74,3 +78,9 @@ void Tau::print() const
     std::cout << "\033[1mDecay Products: \033[0mNo Specific Decay Products To Display" << std::endl;
   }
 }
+
+// Virtual copy function
+Particle *Tau::clone() const
+{
+  return new Tau(*this);
+}
@@ -15,12 +15,14 @@
 
 
 // Tau class
-class Tau : public Lepton
+class Tau final : public Lepton
 {
 public:
   // Constructors
   Tau(std::unique_ptr<FourMomentum> four_momentum, std::vector<std::unique_ptr<Particle>> decay_products, int lepton_number = 1);
   Tau(const std::string &label, std::unique_ptr<FourMomentum> four_momentum, std::vector<std::unique_ptr<Particle>> decay_products, int lepton_number = 1);
+  // Trusted constructor, skipping the four-momentum checks
+  Tau(Trusted, std::unique_ptr<FourMomentum> four_momentum, int lepton_number = 1);
   // Default constructor
   Tau(int lepton_number = 1);
 
@@ -33,6 +35,8 @@ public:
 
   // Virtual function overrides
   virtual void print() const override;
+  virtual Particle *clone() const override;
+  virtual FlavourTag get_flavour_tag() const override { return FlavourTag::Tau; }
 };
 
 #endif // TAU_H
@@ -46,31 +46,49 @@ struct QuarkName<4>
 // Utilise
 
 
-class Up : public QuarkTemplate<Up, QuarkName<3>, 2, 3, 23, 10>
+class Up final : public QuarkTemplate<Up, QuarkName<3>, 2, 3, 23, 10>
 {
   using QuarkTemplate<Up, QuarkName<3>, 2, 3, 23, 10>::QuarkTemplate;
+
+public:
+  static constexpr FlavourTag flavour_tag = FlavourTag::Up;
 };
-class Charm : public QuarkTemplate<Charm, QuarkName<6>, 2, 3, 1275, 1>
+class Charm final : public QuarkTemplate<Charm, QuarkName<6>, 2, 3, 1275, 1>
 {
   using QuarkTemplate<Charm, QuarkName<6>, 2, 3, 1275, 1>::QuarkTemplate;
+
+public:
+  static constexpr FlavourTag flavour_tag = FlavourTag::Charm;
 };
-class Top : public QuarkTemplate<Top, QuarkName<4>, 2, 3, 173070, 1>
+class Top final : public QuarkTemplate<Top, QuarkName<4>, 2, 3, 173070, 1>
 {
   using QuarkTemplate<Top, QuarkName<4>, 2, 3, 173070, 1>::QuarkTemplate;
+
+public:
+  static constexpr FlavourTag flavour_tag = FlavourTag::Top;
 };
 
 
-class Down : public QuarkTemplate<Down, QuarkName<5>, -1, 3, 48, 10>
+class Down final : public QuarkTemplate<Down, QuarkName<5>, -1, 3, 48, 10>
 {
   using QuarkTemplate<Down, QuarkName<5>, -1, 3, 48, 10>::QuarkTemplate;
+
+public:
+  static constexpr FlavourTag flavour_tag = FlavourTag::Down;
 };
-class Strange : public QuarkTemplate<Strange, QuarkName<8>, -1, 3, 95, 1>
+class Strange final : public QuarkTemplate<Strange, QuarkName<8>, -1, 3, 95, 1>
 {
   using QuarkTemplate<Strange, QuarkName<8>, -1, 3, 95, 1>::QuarkTemplate;
+
+public:
+  static constexpr FlavourTag flavour_tag = FlavourTag::Strange;
 };
-class Bottom : public QuarkTemplate<Bottom, QuarkName<7>, -1, 3, 4180, 1>
+class Bottom final : public QuarkTemplate<Bottom, QuarkName<7>, -1, 3, 4180, 1>
 {
   using QuarkTemplate<Bottom, QuarkName<7>, -1, 3, 4180, 1>::QuarkTemplate;
+
+public:
+  static constexpr FlavourTag flavour_tag = FlavourTag::Bottom;
 };
 
 #endif // INDIVIDUAL_QUARKS_H
\ No newline at end of file
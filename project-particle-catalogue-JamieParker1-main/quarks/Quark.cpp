@@ -27,6 +27,13 @@ Quark::Quark(std::string flavour, const std::string &label, double charge,  doub
 }
 
 
+// Protected trusted constructor without label with four momentum
+Quark::Quark(Trusted, std::string flavour, double charge, double rest_mass, std::unique_ptr<FourMomentum> four_momentum, double baryon_number, Colour colour_charge)
+    : Particle(trusted, (baryon_number > 0) ? "quark" : "antiquark", charge, 0.5, rest_mass, std::move(four_momentum), std::vector<DecayType>{DecayType::None}), baryon_number(baryon_number), flavour(std::move(flavour))
+{
+  set_colour_charge(colour_charge);
+}
+
 // Constructor without label without four momentum
 Quark::Quark(std::string flavour, double charge, double rest_mass, double baryon_number, Colour colour_charge)
     : Particle((baryon_number > 0) ? "quark" : "antiquark", charge, 0.5, rest_mass, std::vector<DecayType>{DecayType::None}), baryon_number(baryon_number), flavour(flavour)
@@ -43,11 +50,11 @@ Quark::Quark(std::string flavour, const std::string &label, double charge, doubl
 
 // Copy constructor
 Quark::Quark(const Quark &other)
-    : Particle(other), baryon_number(other.baryon_number), colour_charge(other.colour_charge) {}
+    : Particle(other), colour_charge(other.colour_charge), baryon_number(other.baryon_number), flavour(other.flavour) {}
 
 // Move constructor
 Quark::Quark(Quark &&other) noexcept
-    : Particle(std::move(other)), baryon_number(other.baryon_number), colour_charge(other.colour_charge) {} 
+    : Particle(std::move(other)), colour_charge(other.colour_charge), baryon_number(other.baryon_number), flavour(std::move(other.flavour)) {}
 
 // Virtual destructor
 Quark::~Quark() {}
@@ -60,6 +67,7 @@ Quark &Quark::operator=(const Quark &other)
     Particle::operator=(other); // Call the base class copy assignment operator
     baryon_number = other.baryon_number;
     colour_charge = other.colour_charge;
+    flavour = other.flavour;
   }
   return *this;
 }
@@ -72,6 +80,7 @@ Quark &Quark::operator=(Quark &&other) noexcept
     Particle::operator=(std::move(other)); // Call the base class move assignment operator
     baryon_number = other.baryon_number;   
     colour_charge = other.colour_charge;
+    flavour = std::move(other.flavour);
   }
   return *this;
 }
@@ -118,4 +127,10 @@ void Quark::print() const {
     std::cout << std::setw(columnWidth) << "\033[1mFlavour:\033[0m " << flavour << std::endl;
     std::cout << std::setw(columnWidth) << "\033[1mBaryon Number:\033[0m " << baryon_number << std::endl;
     std::cout << std::setw(columnWidth) << "\033[1mColour Charge:\033[0m " << to_string(colour_charge) << std::endl;
-}
\ No newline at end of file
+}
+
+// Virtual copy function
+Particle *Quark::clone() const
+{
+  return new Quark(*this);
+}
@@ -20,6 +20,8 @@ protected:
   Quark(std::string flavour, double charge, double rest_mass, std::unique_ptr<FourMomentum> fourMomentum, double baryon_number, Colour colour_charge);
   // Constructor with label
   Quark(std::string flavour, const std::string &label, double charge, double rest_mass, std::unique_ptr<FourMomentum> fourMomentum, double baryon_number, Colour colour_charge);
+  // Trusted constructor without label
+  Quark(Trusted, std::string flavour, double charge, double rest_mass, std::unique_ptr<FourMomentum> four_momentum, double baryon_number, Colour colour_charge);
 
 public:
   // Default constructor
@@ -57,6 +59,7 @@ public:
   
   // Virtual print function
   virtual void print() const override;
+  virtual Particle *clone() const override;
 };
 
 #endif // QUARK_H
\ No newline at end of file
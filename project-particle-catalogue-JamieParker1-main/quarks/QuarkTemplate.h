@@ -21,6 +21,10 @@ public:
   QuarkTemplate(const std::string &label, bool anti, Colour colour_charge, std::unique_ptr<FourMomentum> four_momentum)
       : Quark(Name::name, label, (anti) ? -static_cast<double>(charge_integer) / static_cast<double>(charge_denominator) : static_cast<double>(charge_integer) / static_cast<double>(charge_denominator), static_cast<double>(mass_integer) / static_cast<double>(mass_denominator), std::move(four_momentum), (anti) ? -1.0/3.0 : 1.0/3.0, colour_charge) {}
 
+  // Trusted constructor, skipping the four-momentum checks
+  QuarkTemplate(Trusted, bool anti, Colour colour_charge, std::unique_ptr<FourMomentum> four_momentum)
+      : Quark(trusted, Name::name, (anti) ? -static_cast<double>(charge_integer) / static_cast<double>(charge_denominator) : static_cast<double>(charge_integer) / static_cast<double>(charge_denominator), static_cast<double>(mass_integer) / static_cast<double>(mass_denominator), std::move(four_momentum), (anti) ? -1.0/3.0 : 1.0/3.0, colour_charge) {}
+
   QuarkTemplate(bool anti = false)
       : Quark(Name::name, (anti) ? -static_cast<double>(charge_integer) / static_cast<double>(charge_denominator) : static_cast<double>(charge_integer) / static_cast<double>(charge_denominator), static_cast<double>(mass_integer) / static_cast<double>(mass_denominator), (anti) ? -1.0/3.0 : 1.0/3.0, (anti) ? Colour::AntiRed : Colour::Red) {}
 
@@ -42,6 +46,15 @@ public:
       Quark::operator=(std::move(other));
     return static_cast<Derived&>(*this);
   }
+
+  // Flavour of the concrete quark class, e.g. FlavourTag::Up for Up
+  FlavourTag get_flavour_tag() const override { return Derived::flavour_tag; }
+
+  // Virtual copy function, copying as the derived quark
+  Particle *clone() const override
+  {
+    return new Derived(static_cast<const Derived &>(*this));
+  }
 };
 
 #endif // QUARK_TEMPLATE_H
\ No newline at end of file
@@ -2,6 +2,15 @@
 #include "Particle.h"
 #include "ParticleCatalogue.h"
 #include "helper_functions.h"
+#include "VariantCatalogue.h"
+#include "ConcurrentParticleCatalogue.h"
+#include "TaskScheduler.h"
+#include "DalitzSampler.h"
+#include "DecayValidator.h"
+#include "Combinatorics.h"
+#include "AngularIndex.h"
+#include "JetClustering.h"
+#include "EventStore.h"
 
 #include "leptons/Lepton.h"
 #include "leptons/Electron.h"
@@ -25,6 +34,11 @@
 #include <algorithm>
 #include <sstream>
 #include <limits>
+#include <atomic>
+#include <thread>
+#include <random>
+#include <cmath>
+#include <stdexcept>
 
 // Showcase the basic class hierarchy of particles
 // Demonstrates the attributes of the base classes: Particle, Lepton, Quark, and Boson
@@ -74,7 +88,7 @@ void showcase_particle_attributes()
   electron.print();
 
   print_loading_string("\nNow attempting to change energy deposits", 4, true);
-  std::vector<double> electron_energy_deposit = {2.5, 3.7, 1.2, 0.8};
+  LayerEnergies electron_energy_deposit = {2.5, 3.7, 1.2, 0.8};
   std::cout << "New Energy Deposits: " << electron_energy_deposit[0] << ", " << electron_energy_deposit[1] << ", " << electron_energy_deposit[2] << ", " << electron_energy_deposit[3] << std::endl;
   try
   {
@@ -335,4 +349,898 @@ void showcase_particle_catalogue()
   catalogue.print_all();
 
   wait_for_enter("\n\x1b[33mHit Enter to go back to the menu:\x1b[0m");
-}
\ No newline at end of file
+}
+// Showcase the VariantCatalogue class
+// Demonstrates storing particles by value in one contiguous bucket per concrete type
+void showcase_variant_catalogue()
+{
+  std::cout << "==== Variant Catalogue Showcase ====\n";
+
+  // Creating a variant catalogue over every concrete particle type
+  print_loading_string("Creating a variant catalogue and adding particles by value", 4, true);
+  ParticleVariantCatalogue catalogue;
+  catalogue.reserve<Electron>(2);
+  catalogue.emplace_particle<Electron>();
+  catalogue.emplace_particle<Electron>(-1);
+  catalogue.emplace_particle<Muon>();
+  catalogue.emplace_particle<Photon>();
+  catalogue.emplace_particle<Up>(Colour::Red);
+  catalogue.add_particle(ParticleVariant{Tau(-1)});
+  catalogue.print_all();
+
+  wait_for_enter("\n\x1b[33mHit Enter to go to next step:\x1b[0m");
+
+  // Counting particles, by type from the size of each bucket
+  print_loading_string("\nGetting the number of particles of each type", 4, true);
+  std::cout << "Total number of particles: " << catalogue.get_number_of_particles() << std::endl;
+  for (const auto &pair : catalogue.get_particle_count_by_type())
+  {
+    std::cout << pair.first << ": " << pair.second << std::endl;
+  }
+  std::cout << "Electrons in their contiguous bucket: " << catalogue.get_number_of_particles<Electron>() << std::endl;
+
+  // Conserved totals, computed without virtual calls
+  print_loading_string("\nSumming conserved quantities over the catalogue", 4, true);
+  std::cout << "Total charge: " << catalogue.get_total_charge() << std::endl;
+  std::cout << "Total lepton number: " << catalogue.get_total_lepton_number() << std::endl;
+  std::cout << "Total baryon number: " << catalogue.get_total_baryon_number() << std::endl;
+  std::cout << "Total four-momentum: " << catalogue.sum_four_momenta() << std::endl;
+
+  wait_for_enter("\n\x1b[33mHit Enter to go to next step:\x1b[0m");
+
+  // Visiting a particle by position
+  print_loading_string("\nVisiting the particle at index 3 as its concrete type", 4, true);
+  catalogue.visit(3, [](const auto &particle)
+                  { std::cout << "Particle at index 3 has rest mass " << particle.get_rest_mass() << " MeV\n"; });
+
+  // Removing every particle of one type
+  print_loading_string("\nRemoving every electron", 4, true);
+  catalogue.remove_particles_by_type<Electron>();
+  std::cout << "Total number of particles: " << catalogue.get_number_of_particles() << std::endl;
+
+  wait_for_enter("\n\x1b[33mHit Enter to go back to the menu:\x1b[0m");
+}
+
+// Showcase the ConcurrentParticleCatalogue class
+// Demonstrates several producer threads filling one catalogue while a reader takes snapshots
+void showcase_concurrent_catalogue()
+{
+  std::cout << "==== Concurrent Particle Catalogue Showcase ====\n";
+
+  const size_t number_of_producers = 4;
+  const size_t particles_per_producer = 2500;
+  std::shared_ptr<const ConcurrentParticleCatalogue<Particle>::Snapshot> kept_snapshot;
+  {
+    // Filling the catalogue from several threads, publishing as each producer finishes
+    print_loading_string("Filling a concurrent catalogue from " + std::to_string(number_of_producers) + " producer threads", 4, true);
+    ConcurrentParticleCatalogue<Particle> catalogue(number_of_producers);
+    std::atomic<bool> producing{true};
+    std::atomic<size_t> snapshots_read{0};
+    std::thread reader([&catalogue, &producing, &snapshots_read]
+                       {
+      // Snapshots never change while held, so the reader needs no lock
+      while (producing)
+      {
+        size_t counted = 0;
+        catalogue.get_snapshot()->for_each([&counted](const Particle *)
+                                           { ++counted; });
+        snapshots_read++;
+        std::this_thread::yield();
+      } });
+    std::vector<std::thread> producers;
+    for (size_t producer = 0; producer < number_of_producers; ++producer)
+    {
+      producers.emplace_back([&catalogue, producer, particles_per_producer]
+                             {
+        for (size_t i = 0; i < particles_per_producer; ++i)
+        {
+          if (producer % 2 == 0)
+          {
+            catalogue.add_particle(new Electron());
+          }
+          else
+          {
+            catalogue.add_particle(new Muon());
+          }
+        }
+        catalogue.publish(); });
+    }
+    for (auto &producer : producers)
+    {
+      producer.join();
+    }
+    producing = false;
+    reader.join();
+
+    std::cout << "Published particles: " << catalogue.get_number_of_particles() << std::endl;
+    for (const auto &pair : catalogue.get_particle_count_by_type())
+    {
+      std::cout << pair.first << ": " << pair.second << std::endl;
+    }
+    std::cout << "Snapshots read while filling: " << (snapshots_read > 0 ? "yes" : "no") << std::endl;
+
+    wait_for_enter("\n\x1b[33mHit Enter to go to next step:\x1b[0m");
+
+    // Duplicates are skipped on publish, and a pointer left pending twice is freed once
+    print_loading_string("\nAdding one particle pointer twice, then publishing", 4, true);
+    Particle *duplicate = new Photon();
+    catalogue.add_particle(duplicate);
+    catalogue.add_particle(duplicate);
+    catalogue.publish();
+    Particle *unpublished = new Photon();
+    catalogue.add_particle(unpublished);
+    catalogue.add_particle(unpublished);
+    std::cout << "Published particles: " << catalogue.get_number_of_particles() << std::endl;
+
+    kept_snapshot = catalogue.get_snapshot();
+    print_loading_string("\nDestroying the catalogue while holding a snapshot", 4, true);
+  }
+
+  // The snapshot shares ownership of its particles, so it outlives the catalogue
+  size_t counted = 0;
+  kept_snapshot->for_each([&counted](const Particle *)
+                          { ++counted; });
+  std::cout << "Particles still readable through the snapshot: " << counted << std::endl;
+  kept_snapshot.reset();
+
+  wait_for_enter("\n\x1b[33mHit Enter to go back to the menu:\x1b[0m");
+}
+
+// Showcase the TaskScheduler
+// Demonstrates parallel_for, parallel_reduce and a TaskGraph on a batch of tau decays
+void showcase_task_scheduler()
+{
+  std::cout << "==== Task Scheduler Showcase ====\n";
+
+  TaskScheduler &scheduler = TaskScheduler::get_default();
+  std::cout << "Threads in the default scheduler: " << scheduler.get_number_of_threads() << std::endl;
+
+  // Tau parents with random momenta, and the products of tau- -> mu- anti-nu_mu nu_tau
+  const size_t number_of_decays = 100000;
+  const DecaySpecies products[3] = {DecaySpecies{Mass::muon}, DecaySpecies{Mass::muon_neutrino}, DecaySpecies{Mass::tau_neutrino}};
+  std::vector<FourMomentum> parents(number_of_decays);
+  std::vector<FourMomentum> momenta(3 * number_of_decays);
+  std::vector<FourMomentum> serial_momenta(3 * number_of_decays);
+
+  // Parallel for, every chunk drawing from its own random stream so the parents are the same for any thread count
+  print_loading_string("\nGenerating " + std::to_string(number_of_decays) + " taus with parallel_for", 4, true);
+  const std::uint64_t seed = 2024;
+  const size_t taus_per_chunk = 4096;
+  scheduler.parallel_for(number_of_decays, taus_per_chunk, [&parents, seed, taus_per_chunk](size_t first, size_t last)
+                         {
+    std::mt19937_64 generator(get_stream_seed(seed, first / taus_per_chunk));
+    std::normal_distribution<double> momentum(0.0, 5000.0);
+    for (size_t tau = first; tau < last; ++tau)
+    {
+      const double px = momentum(generator), py = momentum(generator), pz = momentum(generator);
+      parents[tau] = FourMomentum(std::sqrt(Mass::tau * Mass::tau + px * px + py * py + pz * pz), px, py, pz);
+    } });
+  std::cout << "First tau: " << parents[0] << std::endl;
+
+  wait_for_enter("\n\x1b[33mHit Enter to go to next step:\x1b[0m");
+
+  // Task graph, decaying the taus on the scheduler and serially, side by side with summing the parents' energy
+  print_loading_string("\nDecaying the taus with a task graph", 4, true);
+  long double parent_energy = 0;
+  bool same_as_serial = false;
+  TaskGraph graph;
+  const size_t decay = graph.add_task([&]
+                                      { compute_decay_momenta(parents.data(), number_of_decays, Mass::tau, products, 3, momenta.data(), scheduler); });
+  const size_t serial_decay = graph.add_task([&]
+                                             { compute_decay_momenta(parents.data(), number_of_decays, Mass::tau, products, 3, serial_momenta.data()); });
+  graph.add_task([&]
+                 {
+    for (const FourMomentum &parent : parents)
+    {
+      parent_energy += parent.get_energy();
+    } });
+  graph.add_task([&]
+                 {
+    same_as_serial = true;
+    for (size_t i = 0; i < momenta.size(); ++i)
+    {
+      same_as_serial = same_as_serial && momenta[i].get_energy() == serial_momenta[i].get_energy() && momenta[i].get_Px() == serial_momenta[i].get_Px() &&
+                       momenta[i].get_Py() == serial_momenta[i].get_Py() && momenta[i].get_Pz() == serial_momenta[i].get_Pz();
+    } },
+                 {decay, serial_decay});
+  scheduler.run(graph);
+  std::cout << "First tau's products:\n  " << momenta[0] << "\n  " << momenta[1] << "\n  " << momenta[2] << std::endl;
+  std::cout << "Scheduled decays match the serial ones: " << (same_as_serial ? "yes" : "no") << std::endl;
+
+  wait_for_enter("\n\x1b[33mHit Enter to go to next step:\x1b[0m");
+
+  // Parallel reduce, summing the products' energy in chunk order so the total is the same every run
+  print_loading_string("\nSumming the products' energy with parallel_reduce", 4, true);
+  const long double product_energy = scheduler.parallel_reduce(
+      momenta.size(), 0, 0.0L, [&momenta](size_t first, size_t last)
+      {
+        long double energy = 0;
+        for (size_t i = first; i < last; ++i)
+        {
+          energy += momenta[i].get_energy();
+        }
+        return energy; },
+      [](long double a, long double b)
+      { return a + b; });
+  std::cout << "Total tau energy (MeV): " << static_cast<double>(parent_energy) << std::endl;
+  std::cout << "Total product energy (MeV): " << static_cast<double>(product_energy) << std::endl;
+  std::cout << "Relative difference: " << static_cast<double>(std::fabs(product_energy - parent_energy) / parent_energy) << std::endl;
+
+  wait_for_enter("\n\x1b[33mHit Enter to go to next step:\x1b[0m");
+
+  // A failing task skips the tasks after it, but the graph still finishes and rethrows the error
+  print_loading_string("\nRunning a task graph in which one task throws", 4, true);
+  std::atomic<size_t> tasks_run{0};
+  TaskGraph failing_graph;
+  const size_t first_task = failing_graph.add_task([&tasks_run]
+                                                   { tasks_run++; });
+  failing_graph.add_task([]
+                         { throw std::runtime_error("Error: Task failed on purpose."); });
+  failing_graph.add_task([&tasks_run]
+                         { tasks_run++; },
+                         {first_task});
+  try
+  {
+    scheduler.run(failing_graph);
+    std::cout << "The graph finished without rethrowing the failure" << std::endl;
+  }
+  catch (const std::runtime_error &error)
+  {
+    std::cout << "The graph finished and rethrew: " << error.what() << std::endl;
+  }
+  std::cout << "Other tasks that ran before the failure: " << tasks_run << " of 2" << std::endl;
+
+  wait_for_enter("\n\x1b[33mHit Enter to go back to the menu:\x1b[0m");
+}
+
+// Showcase the DalitzSampler
+// Demonstrates a tau decay sampled from the V-A matrix element and a batch of muon decays
+void showcase_dalitz_sampler()
+{
+  std::cout << "==== Dalitz Sampler Showcase ====\n";
+
+  // One moving tau- -> mu- anti-nu_mu nu_tau, with the products' momenta drawn from the V-A matrix element
+  print_loading_string("Decaying a moving tau into a muon and two neutrinos", 4, true);
+  Tau tau;
+  tau.set_four_momentum(std::make_unique<FourMomentum>(std::sqrt(Mass::tau * Mass::tau + 3000.0 * 3000.0), 3000, 0, 0));
+  std::vector<std::unique_ptr<Particle>> tau_decay_products;
+  tau_decay_products.push_back(std::make_unique<Muon>());
+  tau_decay_products.push_back(std::make_unique<Neutrino>("muon", -1));
+  tau_decay_products.push_back(std::make_unique<Neutrino>("tau"));
+  set_leptonic_decay_products(tau, std::move(tau_decay_products), DecayType::Weak, 2024);
+  std::cout << "Tau: " << tau.get_four_momentum() << std::endl;
+  FourMomentum product_total;
+  for (const auto &product : tau.get_decay_products())
+  {
+    std::cout << product->get_type() << ": " << product->get_four_momentum() << std::endl;
+    product_total = product_total + product->get_four_momentum();
+  }
+  std::cout << "Sum of products: " << product_total << std::endl;
+
+  wait_for_enter("\n\x1b[33mHit Enter to go to next step:\x1b[0m");
+
+  // A batch of mu- -> e- anti-nu_e nu_mu at rest, whose electron energies follow the Michel spectrum
+  const size_t number_of_decays = 200000;
+  print_loading_string("\nSampling " + std::to_string(number_of_decays) + " muon decays at rest on the task scheduler", 4, true);
+  const std::array<DecaySpecies, 3> muon_decay_products = {DecaySpecies{Mass::electron}, DecaySpecies{Mass::electron_neutrino}, DecaySpecies{Mass::muon_neutrino}};
+  const DalitzSampler sampler(Mass::muon, muon_decay_products, get_leptonic_decay_matrix_element(Mass::muon, muon_decay_products));
+  std::vector<FourMomentum> momenta(3 * number_of_decays);
+  sampler.sample_batch(number_of_decays, 2024, momenta.data());
+
+  // Electron energy as a fraction x of its maximum, about m_mu / 2, against dN/dx = 2x^2(3 - 2x)
+  const size_t number_of_bins = 10;
+  std::vector<size_t> histogram(number_of_bins, 0);
+  for (size_t decay = 0; decay < number_of_decays; ++decay)
+  {
+    const double x = 2 * momenta[3 * decay].get_energy() / Mass::muon;
+    histogram[std::min(static_cast<size_t>(x * number_of_bins), number_of_bins - 1)]++;
+  }
+  std::cout << "Electron energy fraction   sampled   Michel spectrum\n";
+  for (size_t bin = 0; bin < number_of_bins; ++bin)
+  {
+    const double low = static_cast<double>(bin) / number_of_bins;
+    const double high = static_cast<double>(bin + 1) / number_of_bins;
+    const double expected = (2 * high * high * high - high * high * high * high) - (2 * low * low * low - low * low * low * low);
+    std::cout << "  " << low << " - " << high << "\t\t" << static_cast<double>(histogram[bin]) / number_of_decays << "\t  " << expected << std::endl;
+  }
+
+  wait_for_enter("\n\x1b[33mHit Enter to go back to the menu:\x1b[0m");
+}
+
+// Showcase the DecayBatch
+// Demonstrates checking many random decays in one pass, with every verdict compared to Particle::validate_decay_products
+void showcase_decay_batch()
+{
+  std::cout << "==== Decay Batch Showcase ====\n";
+
+  // Moving parents decaying either into products that conserve everything they should or into random products,
+  // with some products knocked off by 1 MeV so four momentum is not conserved
+  const size_t number_of_decays = 5000;
+  print_loading_string("Building " + std::to_string(number_of_decays) + " random decays of moving parents", 4, true);
+  std::mt19937_64 generator(2024);
+  std::normal_distribution<double> momentum(0.0, 1000.0);
+  std::uniform_int_distribution<int> parent_kind(0, 6);
+  std::uniform_int_distribution<int> product_kind(0, 11);
+  std::uniform_int_distribution<int> decay_kind(0, 2);
+  std::uniform_int_distribution<int> one_in_four(0, 3);
+  const DecayType decay_types[3] = {DecayType::Weak, DecayType::Strong, DecayType::Electromagnetic};
+
+  auto make_parent = [](int kind) -> std::unique_ptr<Particle>
+  {
+    switch (kind)
+    {
+    case 0:
+      return std::make_unique<Z>();
+    case 1:
+      return std::make_unique<W>(1);
+    case 2:
+      return std::make_unique<W>(-1);
+    case 3:
+      return std::make_unique<Higgs>();
+    case 4:
+      return std::make_unique<Tau>();
+    case 5:
+      return std::make_unique<Tau>(-1);
+    default:
+      return std::make_unique<Charm>();
+    }
+  };
+  // Z -> e- e+, W+ -> e+ nu_e, W- -> mu- anti-nu_mu, H -> b anti-b, tau- -> mu- anti-nu_mu nu_tau,
+  // tau+ -> e+ nu_e anti-nu_tau and c -> s e+ nu_e, which leaves the products' colour unbalanced
+  auto make_expected_products = [](int kind)
+  {
+    std::vector<std::unique_ptr<Particle>> products;
+    switch (kind)
+    {
+    case 0:
+      products.push_back(std::make_unique<Electron>());
+      products.push_back(std::make_unique<Electron>(-1));
+      break;
+    case 1:
+      products.push_back(std::make_unique<Electron>(-1));
+      products.push_back(std::make_unique<Neutrino>("electron"));
+      break;
+    case 2:
+      products.push_back(std::make_unique<Muon>());
+      products.push_back(std::make_unique<Neutrino>("muon", -1));
+      break;
+    case 3:
+      products.push_back(std::make_unique<Bottom>());
+      products.push_back(std::make_unique<Bottom>(true));
+      break;
+    case 4:
+      products.push_back(std::make_unique<Muon>());
+      products.push_back(std::make_unique<Neutrino>("muon", -1));
+      products.push_back(std::make_unique<Neutrino>("tau"));
+      break;
+    case 5:
+      products.push_back(std::make_unique<Electron>(-1));
+      products.push_back(std::make_unique<Neutrino>("electron"));
+      products.push_back(std::make_unique<Neutrino>("tau", -1));
+      break;
+    default:
+      products.push_back(std::make_unique<Strange>());
+      products.push_back(std::make_unique<Electron>(-1));
+      products.push_back(std::make_unique<Neutrino>("electron"));
+      break;
+    }
+    return products;
+  };
+  auto make_random_product = [](int kind) -> std::unique_ptr<Particle>
+  {
+    switch (kind)
+    {
+    case 0:
+      return std::make_unique<Electron>();
+    case 1:
+      return std::make_unique<Electron>(-1);
+    case 2:
+      return std::make_unique<Muon>();
+    case 3:
+      return std::make_unique<Muon>(-1);
+    case 4:
+      return std::make_unique<Neutrino>("electron");
+    case 5:
+      return std::make_unique<Neutrino>("electron", -1);
+    case 6:
+      return std::make_unique<Neutrino>("muon");
+    case 7:
+      return std::make_unique<Neutrino>("tau", -1);
+    case 8:
+      return std::make_unique<Up>();
+    case 9:
+      return std::make_unique<Down>(true);
+    case 10:
+      return std::make_unique<Strange>(true);
+    default:
+      return std::make_unique<Photon>();
+    }
+  };
+
+  std::vector<std::unique_ptr<Particle>> parents;
+  std::vector<std::vector<std::unique_ptr<Particle>>> products;
+  std::vector<DecayType> types;
+  DecayBatch batch;
+  batch.reserve(number_of_decays, 3 * number_of_decays);
+  for (size_t decay = 0; decay < number_of_decays; ++decay)
+  {
+    const int kind = parent_kind(generator);
+    std::unique_ptr<Particle> parent = make_parent(kind);
+    const double px = momentum(generator), py = momentum(generator), pz = momentum(generator);
+    const double mass = parent->get_rest_mass();
+    parent->set_four_momentum(std::make_unique<FourMomentum>(std::sqrt(mass * mass + px * px + py * py + pz * pz), px, py, pz));
+
+    // Random products are drawn again until they are light enough for the parent to decay into
+    std::vector<std::unique_ptr<Particle>> decay_products;
+    if (one_in_four(generator) < 2)
+    {
+      decay_products = make_expected_products(kind);
+    }
+    else
+    {
+      double product_mass = mass;
+      while (product_mass >= mass)
+      {
+        decay_products.clear();
+        product_mass = 0;
+        const size_t number_of_products = 2 + one_in_four(generator) % 2;
+        for (size_t i = 0; i < number_of_products; ++i)
+        {
+          decay_products.push_back(make_random_product(product_kind(generator)));
+          product_mass += decay_products.back()->get_rest_mass();
+        }
+      }
+    }
+
+    DecaySpecies species[3];
+    FourMomentum momenta[3];
+    for (size_t i = 0; i < decay_products.size(); ++i)
+    {
+      species[i] = decay_products[i]->get_decay_species();
+    }
+    parent->compute_decay_momenta(species, decay_products.size(), momenta);
+    if (one_in_four(generator) == 0)
+    {
+      momenta[0] = FourMomentum(momenta[0].get_energy(), momenta[0].get_Px() + 1.0, momenta[0].get_Py(), momenta[0].get_Pz());
+    }
+    for (size_t i = 0; i < decay_products.size(); ++i)
+    {
+      decay_products[i]->set_trusted_four_momentum(momenta[i]);
+    }
+
+    const DecayType decay_type = decay_types[decay_kind(generator)];
+    batch.add_decay(*parent, decay_products, decay_type);
+    parents.push_back(std::move(parent));
+    products.push_back(std::move(decay_products));
+    types.push_back(decay_type);
+  }
+  std::cout << "Decays in the batch: " << batch.get_number_of_decays() << std::endl;
+
+  wait_for_enter("\n\x1b[33mHit Enter to go to next step:\x1b[0m");
+
+  // The whole batch is checked at once, serially and on the task scheduler
+  print_loading_string("\nChecking every decay in the batch", 4, true);
+  const std::vector<std::uint16_t> failures = batch.validate();
+  const std::vector<std::uint16_t> scheduled_failures = batch.validate(TaskScheduler::get_default());
+  for (size_t decay = 0; decay < 5; ++decay)
+  {
+    std::cout << parents[decay]->get_type() << " ->";
+    for (const auto &product : products[decay])
+    {
+      std::cout << " " << product->get_type();
+    }
+    std::cout << "\n  Violated: " << to_string_conservation_failures(failures[decay]) << std::endl;
+  }
+  const std::uint16_t flags[7] = {ConservationFailure::four_momentum, ConservationFailure::charge, ConservationFailure::lepton_number,
+                                  ConservationFailure::baryon_number, ConservationFailure::lepton_flavour, ConservationFailure::quark_flavour,
+                                  ConservationFailure::colour};
+  std::cout << "\nDecays violating each law:\n";
+  for (const std::uint16_t flag : flags)
+  {
+    const size_t count = std::count_if(failures.begin(), failures.end(), [flag](std::uint16_t failure)
+                                       { return (failure & flag) != 0; });
+    std::cout << "  " << to_string_conservation_failures(flag) << ": " << count << std::endl;
+  }
+  std::cout << "Decays conserving everything: " << std::count(failures.begin(), failures.end(), ConservationFailure::none) << " of " << number_of_decays << std::endl;
+  std::cout << "Scheduled results match the serial ones: " << (scheduled_failures == failures ? "yes" : "no") << std::endl;
+
+  wait_for_enter("\n\x1b[33mHit Enter to go to next step:\x1b[0m");
+
+  // Each decay checked on its own by the parent, which must give the same verdict as the batch
+  print_loading_string("\nComparing with Particle::validate_decay_products one decay at a time", 4, true);
+  size_t disagreements = 0;
+  for (size_t decay = 0; decay < number_of_decays; ++decay)
+  {
+    const bool batch_valid = failures[decay] == ConservationFailure::none;
+    if (parents[decay]->validate_decay_products(products[decay], types[decay]) != batch_valid)
+    {
+      if (disagreements < 5)
+      {
+        std::cout << "Decay " << decay << " of a " << parents[decay]->get_type() << ": batch says " << (batch_valid ? "valid" : to_string_conservation_failures(failures[decay])) << std::endl;
+      }
+      disagreements++;
+    }
+  }
+  std::cout << "Decays where the two validators disagree: " << disagreements << " of " << number_of_decays << std::endl;
+
+  wait_for_enter("\n\x1b[33mHit Enter to go back to the menu:\x1b[0m");
+}
+
+// Showcase the pair and triple finders
+// Demonstrates finding Z -> e- e+ candidates and three-particle combinations in a catalogue, checked against a brute-force scan
+void showcase_combinatorics()
+{
+  std::cout << "==== Combinatorics Showcase ====\n";
+
+  // Random leptons, quarks and bosons, plus the electrons of three moving Z bosons decaying to e- e+
+  print_loading_string("Filling a catalogue with 40 random particles and the decay products of 3 Z bosons", 4, true);
+  ParticleCatalogue<Particle> catalogue;
+  fill_random_particles(catalogue, 40, 2024);
+  std::mt19937_64 generator(2025);
+  std::normal_distribution<double> momentum(0.0, 20000.0);
+  for (int z_number = 1; z_number <= 3; ++z_number)
+  {
+    Z z;
+    const double px = momentum(generator), py = momentum(generator), pz = momentum(generator);
+    z.set_four_momentum(std::make_unique<FourMomentum>(std::sqrt(Mass::z * Mass::z + px * px + py * py + pz * pz), px, py, pz));
+    std::vector<std::unique_ptr<Particle>> z_decay_products;
+    z_decay_products.push_back(std::make_unique<Electron>());
+    z_decay_products.push_back(std::make_unique<Electron>(-1));
+    z.auto_set_decay_products(std::move(z_decay_products), DecayType::Weak);
+    for (const auto &product : z.get_decay_products())
+    {
+      Particle *electron = product->clone();
+      electron->set_label("Z" + std::to_string(z_number) + " " + product->get_type());
+      catalogue.add_particle(electron);
+    }
+  }
+  std::vector<const Particle *> particles;
+  catalogue.get_view().for_each([&particles](const Particle *particle)
+                                { particles.push_back(particle); });
+  const EventColumns event = make_event_columns(catalogue);
+  std::cout << "Particles in the catalogue: " << event.get_number_of_particles() << std::endl;
+
+  wait_for_enter("\n\x1b[33mHit Enter to go to next step:\x1b[0m");
+
+  // Same-flavour opposite-sign pairs within 10 GeV of the Z mass
+  print_loading_string("\nFinding same-flavour opposite-sign pairs with a mass between 81 and 101 GeV", 4, true);
+  CombinationCuts z_cuts;
+  z_cuts.same_flavour = true;
+  z_cuts.min_mass = Mass::z - 10000;
+  z_cuts.max_mass = Mass::z + 10000;
+  const std::vector<PairCandidate> pairs = find_pairs(event, z_cuts);
+  for (const PairCandidate &pair : pairs)
+  {
+    std::cout << "  " << particles[pair.first]->get_label() << " + " << particles[pair.second]->get_label() << ": " << pair.mass << " MeV" << std::endl;
+  }
+
+  // Brute force over every pair, with the cuts written out directly on the particles
+  std::vector<PairCandidate> expected_pairs;
+  for (std::uint32_t first = 0; first < particles.size(); ++first)
+  {
+    for (std::uint32_t second = first + 1; second < particles.size(); ++second)
+    {
+      const Particle &a = *particles[first], &b = *particles[second];
+      const double mass = (a.get_four_momentum() + b.get_four_momentum()).invariant_mass();
+      if (typeid(a) == typeid(b) && a.get_flavour() == b.get_flavour() && a.get_charge() * b.get_charge() < 0 &&
+          mass >= z_cuts.min_mass && mass <= z_cuts.max_mass)
+      {
+        expected_pairs.push_back(PairCandidate{first, second, mass});
+      }
+    }
+  }
+  bool pairs_match = pairs.size() == expected_pairs.size();
+  for (size_t i = 0; pairs_match && i < pairs.size(); ++i)
+  {
+    pairs_match = pairs[i].first == expected_pairs[i].first && pairs[i].second == expected_pairs[i].second &&
+                  std::abs(pairs[i].mass - expected_pairs[i].mass) < 1e-6 * expected_pairs[i].mass;
+  }
+  std::cout << "Pairs found by a brute-force scan: " << expected_pairs.size() << ", same pairs: " << (pairs_match ? "yes" : "no") << std::endl;
+
+  wait_for_enter("\n\x1b[33mHit Enter to go to next step:\x1b[0m");
+
+  // Triples of any flavour with a net charge of at most one unit, so quarks' thirds have to add up exactly
+  print_loading_string("\nFinding triples with a net charge of at most 1 and a mass between 100 and 120 GeV", 4, true);
+  CombinationCuts triple_cuts;
+  triple_cuts.min_mass = 100000;
+  triple_cuts.max_mass = 120000;
+  const std::vector<TripleCandidate> triples = find_triples(event, triple_cuts);
+  for (size_t i = 0; i < std::min<size_t>(triples.size(), 5); ++i)
+  {
+    const TripleCandidate &triple = triples[i];
+    std::cout << "  " << particles[triple.first]->get_label() << " + " << particles[triple.second]->get_label() << " + " << particles[triple.third]->get_label()
+              << ": " << triple.mass << " MeV" << std::endl;
+  }
+  std::vector<TripleCandidate> expected_triples;
+  for (std::uint32_t first = 0; first < particles.size(); ++first)
+  {
+    for (std::uint32_t second = first + 1; second < particles.size(); ++second)
+    {
+      for (std::uint32_t third = second + 1; third < particles.size(); ++third)
+      {
+        const Particle &a = *particles[first], &b = *particles[second], &c = *particles[third];
+        const double mass = (a.get_four_momentum() + b.get_four_momentum() + c.get_four_momentum()).invariant_mass();
+        if (std::abs(a.get_charge() + b.get_charge() + c.get_charge()) < 1 + 1e-9 && mass >= triple_cuts.min_mass && mass <= triple_cuts.max_mass)
+        {
+          expected_triples.push_back(TripleCandidate{first, second, third, mass});
+        }
+      }
+    }
+  }
+  bool triples_match = triples.size() == expected_triples.size();
+  for (size_t i = 0; triples_match && i < triples.size(); ++i)
+  {
+    triples_match = triples[i].first == expected_triples[i].first && triples[i].second == expected_triples[i].second &&
+                    triples[i].third == expected_triples[i].third && std::abs(triples[i].mass - expected_triples[i].mass) < 1e-6 * expected_triples[i].mass;
+  }
+  std::cout << "Triples found: " << triples.size() << std::endl;
+  std::cout << "Triples found by a brute-force scan: " << expected_triples.size() << ", same triples: " << (triples_match ? "yes" : "no") << std::endl;
+
+  wait_for_enter("\n\x1b[33mHit Enter to go back to the menu:\x1b[0m");
+}
+
+// Showcase the AngularIndex
+// Demonstrates radius and nearest-neighbour queries in (eta, phi) checked against a brute-force scan, and the rebuild after a boost
+void showcase_angular_index()
+{
+  std::cout << "==== Angular Index Showcase ====\n";
+
+  print_loading_string("Filling a catalogue with 300 random particles and indexing it", 4, true);
+  ParticleCatalogue<Particle> catalogue;
+  fill_random_particles(catalogue, 300, 2024);
+  AngularIndex<Particle> index(catalogue);
+  std::vector<const Particle *> particles;
+  catalogue.get_view().for_each([&particles](const Particle *particle)
+                                { particles.push_back(particle); });
+  std::cout << "Index built before the first query: " << (index.is_current() ? "yes" : "no") << std::endl;
+
+  // Every other particle's distance from one particle, from its four momentum, sorted by distance then index
+  auto brute_force = [&particles](size_t particle)
+  {
+    const double eta = particles[particle]->get_four_momentum().get_eta();
+    const double phi = particles[particle]->get_four_momentum().get_phi();
+    std::vector<AngularNeighbour> neighbours;
+    for (size_t other = 0; other < particles.size(); ++other)
+    {
+      if (other != particle)
+      {
+        const double delta_eta = particles[other]->get_four_momentum().get_eta() - eta;
+        const double delta_phi = std::remainder(particles[other]->get_four_momentum().get_phi() - phi, 2 * M_PI);
+        neighbours.push_back(AngularNeighbour{static_cast<std::uint32_t>(other), std::sqrt(delta_eta * delta_eta + delta_phi * delta_phi)});
+      }
+    }
+    std::sort(neighbours.begin(), neighbours.end(), [](const AngularNeighbour &a, const AngularNeighbour &b)
+              { return a.delta_r < b.delta_r || (a.delta_r == b.delta_r && a.index < b.index); });
+    return neighbours;
+  };
+  // The index computes phi with a fast approximation good to about 1e-8, so distances are compared loosely
+  auto same_indices = [](std::vector<AngularNeighbour> a, std::vector<AngularNeighbour> b, bool sort_by_index)
+  {
+    auto by_index = [](const AngularNeighbour &x, const AngularNeighbour &y)
+    { return x.index < y.index; };
+    if (sort_by_index)
+    {
+      std::sort(a.begin(), a.end(), by_index);
+      std::sort(b.begin(), b.end(), by_index);
+    }
+    return std::equal(a.begin(), a.end(), b.begin(), b.end(), [](const AngularNeighbour &x, const AngularNeighbour &y)
+                      { return x.index == y.index && std::abs(x.delta_r - y.delta_r) < 1e-6; });
+  };
+  const double radius = 0.4;
+  const size_t k = 5;
+
+  wait_for_enter("\n\x1b[33mHit Enter to go to next step:\x1b[0m");
+
+  // Both queries for every particle, each compared with the brute-force scan
+  print_loading_string("\nQuerying the neighbours within 0.4 and the 5 nearest of every particle", 4, true);
+  size_t matching_radius = 0, matching_nearest = 0, total_within = 0;
+  for (size_t particle = 0; particle < particles.size(); ++particle)
+  {
+    const std::vector<AngularNeighbour> expected = brute_force(particle);
+    const std::vector<AngularNeighbour> within = index.find_within(particle, radius);
+    const std::vector<AngularNeighbour> expected_within(expected.begin(), std::find_if(expected.begin(), expected.end(), [radius](const AngularNeighbour &neighbour)
+                                                                                       { return neighbour.delta_r > radius; }));
+    matching_radius += same_indices(within, expected_within, true);
+    matching_nearest += same_indices(index.find_nearest(particle, k), std::vector<AngularNeighbour>(expected.begin(), expected.begin() + k), false);
+    total_within += within.size();
+  }
+  std::cout << particles[0]->get_label() << " at eta = " << index.get_eta(0) << ", phi = " << index.get_phi(0) << ", nearest particles:\n";
+  for (const AngularNeighbour &neighbour : index.find_nearest(0, k))
+  {
+    std::cout << "  " << particles[neighbour.index]->get_label() << ": delta R = " << neighbour.delta_r << std::endl;
+  }
+  std::cout << "Neighbours within 0.4 found: " << total_within << std::endl;
+  std::cout << "Radius queries matching a brute-force scan: " << matching_radius << " of " << particles.size() << std::endl;
+  std::cout << "Nearest-neighbour queries matching a brute-force scan: " << matching_nearest << " of " << particles.size() << std::endl;
+
+  wait_for_enter("\n\x1b[33mHit Enter to go to next step:\x1b[0m");
+
+  // A boost changes the kinematics revision, so the next query rebuilds the index without being told
+  print_loading_string("\nBoosting " + particles[0]->get_label() + " to 0.9c along the beam and querying again", 4, true);
+  std::cout << "Index current before the boost: " << (index.is_current() ? "yes" : "no") << std::endl;
+  catalogue.find_particles_by_label(particles[0]->get_label())[0]->lorentz_boost(0, 0, 0.9);
+  std::cout << "Index current after the boost: " << (index.is_current() ? "yes" : "no") << std::endl;
+  std::cout << particles[0]->get_label() << " now at eta = " << index.get_eta(0) << ", phi = " << index.get_phi(0) << ", nearest particles:\n";
+  const std::vector<AngularNeighbour> nearest = index.find_nearest(0, k);
+  for (const AngularNeighbour &neighbour : nearest)
+  {
+    std::cout << "  " << particles[neighbour.index]->get_label() << ": delta R = " << neighbour.delta_r << std::endl;
+  }
+  const std::vector<AngularNeighbour> expected = brute_force(0);
+  std::cout << "Matches a brute-force scan: " << (same_indices(nearest, std::vector<AngularNeighbour>(expected.begin(), expected.begin() + k), false) ? "yes" : "no") << std::endl;
+  std::cout << "Index current after the query: " << (index.is_current() ? "yes" : "no") << std::endl;
+
+  wait_for_enter("\n\x1b[33mHit Enter to go back to the menu:\x1b[0m");
+}
+
+// Showcase jet clustering
+// Demonstrates clustering the quarks and gluons of a catalogue into anti-kt jets, with constituents given as catalogue positions
+void showcase_jet_clustering()
+{
+  std::cout << "==== Jet Clustering Showcase ====\n";
+
+  // Random particles, then three sprays of quarks and gluons each with an electron after every parton,
+  // so the quarks and gluons are scattered through the catalogue between particles that are not clustered
+  print_loading_string("Filling a catalogue with 20 random particles and three sprays of quarks and gluons", 4, true);
+  ParticleCatalogue<Particle> catalogue;
+  fill_random_particles(catalogue, 20, 2024);
+  std::mt19937_64 generator(2025);
+  std::uniform_real_distribution<double> spray_eta(-2.0, 2.0), spray_phi(-M_PI, M_PI), spray_pt(10000.0, 60000.0);
+  std::normal_distribution<double> spread(0.0, 0.1);
+  std::uniform_int_distribution<int> parton_kind(0, 2);
+  for (int spray = 1; spray <= 3; ++spray)
+  {
+    const double eta = spray_eta(generator), phi = spray_phi(generator);
+    for (int parton = 0; parton < 5; ++parton)
+    {
+      Particle *particle;
+      switch (parton_kind(generator))
+      {
+      case 0:
+        particle = new Gluon();
+        break;
+      case 1:
+        particle = new Up();
+        break;
+      default:
+        particle = new Down(true);
+        break;
+      }
+      const double pt = spray_pt(generator) / (parton + 1);
+      const double parton_eta = eta + spread(generator), parton_phi = phi + spread(generator);
+      const double px = pt * std::cos(parton_phi), py = pt * std::sin(parton_phi), pz = pt * std::sinh(parton_eta);
+      const double mass = particle->get_rest_mass();
+      particle->set_trusted_four_momentum(FourMomentum(std::sqrt(mass * mass + px * px + py * py + pz * pz), px, py, pz));
+      const std::string flavour = (particle->get_flavour() == "none") ? "" : " (" + particle->get_flavour() + ")";
+      particle->set_label("spray " + std::to_string(spray) + " " + particle->get_type() + flavour);
+      catalogue.add_particle(particle);
+
+      Electron *electron = new Electron();
+      electron->set_label("spray " + std::to_string(spray) + " electron");
+      electron->set_trusted_four_momentum(FourMomentum(std::sqrt(Mass::electron * Mass::electron + 1000.0 * 1000.0), 0, 1000.0, 0));
+      catalogue.add_particle(electron);
+    }
+  }
+  std::vector<const Particle *> particles;
+  catalogue.get_view().for_each([&particles](const Particle *particle)
+                                { particles.push_back(particle); });
+  const size_t number_coloured = std::count_if(particles.begin(), particles.end(), is_coloured);
+  std::cout << "Particles in the catalogue: " << particles.size() << ", of which quarks and gluons: " << number_coloured << std::endl;
+
+  wait_for_enter("\n\x1b[33mHit Enter to go to next step:\x1b[0m");
+
+  // Anti-kt jets above 30 GeV, listing each constituent by its position in the catalogue
+  print_loading_string("\nClustering the quarks and gluons into anti-kt jets with R = 0.4 and pt above 30 GeV", 4, true);
+  JetDefinition definition;
+  definition.min_pt = 30000;
+  const std::vector<Jet> jets = cluster_jets(catalogue, definition);
+  for (size_t jet = 0; jet < jets.size(); ++jet)
+  {
+    const FourMomentum &four_momentum = jets[jet].four_momentum;
+    std::cout << "Jet " << jet + 1 << ": pt = " << four_momentum.get_pt() << " MeV, eta = " << four_momentum.get_eta() << ", phi = " << four_momentum.get_phi() << std::endl;
+    for (const std::uint32_t constituent : jets[jet].constituents)
+    {
+      std::cout << "  [" << constituent << "] " << particles[constituent]->get_label() << ": pt = " << particles[constituent]->get_four_momentum().get_pt()
+                << " MeV, delta R = " << particles[constituent]->get_four_momentum().delta_r(four_momentum) << std::endl;
+    }
+  }
+
+  wait_for_enter("\n\x1b[33mHit Enter to go to next step:\x1b[0m");
+
+  // Without a pt cut every quark and gluon ends up in exactly one jet, and every jet is the sum of the
+  // catalogue particles its constituents point to
+  print_loading_string("\nChecking the constituents of all jets against the catalogue", 4, true);
+  const std::vector<Jet> all_jets = cluster_jets(catalogue, JetDefinition());
+  std::vector<size_t> times_clustered(particles.size(), 0);
+  size_t jets_matching = 0;
+  for (const Jet &jet : all_jets)
+  {
+    FourMomentum constituent_sum;
+    for (const std::uint32_t constituent : jet.constituents)
+    {
+      times_clustered[constituent]++;
+      constituent_sum = constituent_sum + particles[constituent]->get_four_momentum();
+    }
+    const FourMomentum difference = constituent_sum - jet.four_momentum;
+    jets_matching += std::abs(difference.get_energy()) < 1e-6 * jet.four_momentum.get_energy() && std::abs(difference.get_Px()) < 1e-6 * jet.four_momentum.get_energy() &&
+                     std::abs(difference.get_Py()) < 1e-6 * jet.four_momentum.get_energy() && std::abs(difference.get_Pz()) < 1e-6 * jet.four_momentum.get_energy();
+  }
+  size_t clustered_once = 0, others_clustered = 0;
+  for (size_t particle = 0; particle < particles.size(); ++particle)
+  {
+    if (is_coloured(particles[particle]))
+    {
+      clustered_once += times_clustered[particle] == 1;
+    }
+    else
+    {
+      others_clustered += times_clustered[particle];
+    }
+  }
+  std::cout << "Jets without a pt cut: " << all_jets.size() << std::endl;
+  std::cout << "Quarks and gluons in exactly one jet: " << clustered_once << " of " << number_coloured << std::endl;
+  std::cout << "Other particles in a jet: " << others_clustered << std::endl;
+  std::cout << "Jets equal to the sum of their constituents in the catalogue: " << jets_matching << " of " << all_jets.size() << std::endl;
+
+  wait_for_enter("\n\x1b[33mHit Enter to go back to the menu:\x1b[0m");
+}
+
+// Showcase the EventStore
+// Demonstrates storing many events in shared columns and processing them on a task scheduler, checked against a serial pass
+void showcase_event_store()
+{
+  std::cout << "==== Event Store Showcase ====\n";
+
+  // Events of between 5 and 40 random particles, each built in a catalogue and copied into the store
+  const size_t number_of_events = 500;
+  print_loading_string("Filling an event store with " + std::to_string(number_of_events) + " events of random particles", 4, true);
+  EventStore store;
+  std::vector<FourMomentum> catalogue_sums;
+  std::mt19937_64 generator(2024);
+  std::uniform_int_distribution<size_t> event_size(5, 40);
+  for (size_t event = 0; event < number_of_events; ++event)
+  {
+    ParticleCatalogue<Particle> catalogue;
+    fill_random_particles(catalogue, event_size(generator), get_stream_seed(2024, event));
+    store.add_event(catalogue);
+    catalogue_sums.push_back(catalogue.sum_four_momenta());
+  }
+  std::cout << "Events: " << store.get_number_of_events() << ", particles: " << store.get_number_of_particles() << std::endl;
+  const Event first_event = store[0];
+  std::cout << "First event: " << first_event.get_number_of_particles() << " particles, total four momentum " << first_event.sum_four_momenta() << std::endl;
+
+  wait_for_enter("\n\x1b[33mHit Enter to go to next step:\x1b[0m");
+
+  // Per-event sums and opposite-sign pair counts, written by event index once in order and once on four threads
+  print_loading_string("\nSumming every event's four momentum and counting its opposite-sign pairs, serially and on four threads", 4, true);
+  std::vector<FourMomentum> sums(number_of_events), parallel_sums(number_of_events);
+  std::vector<size_t> pair_counts(number_of_events), parallel_pair_counts(number_of_events);
+  store.for_each_event([&sums, &pair_counts](const Event &event)
+                       {
+    sums[event.get_index()] = event.sum_four_momenta();
+    pair_counts[event.get_index()] = find_pairs(event.get_columns()).size(); });
+  TaskScheduler scheduler(4);
+  store.for_each_event_parallel([&parallel_sums, &parallel_pair_counts](const Event &event)
+                                {
+    parallel_sums[event.get_index()] = event.sum_four_momenta();
+    parallel_pair_counts[event.get_index()] = find_pairs(event.get_columns()).size(); },
+                                16, scheduler);
+  size_t matching = 0, matching_catalogue = 0;
+  for (size_t event = 0; event < number_of_events; ++event)
+  {
+    const FourMomentum &sum = sums[event], &parallel_sum = parallel_sums[event], &catalogue_sum = catalogue_sums[event];
+    matching += sum.get_energy() == parallel_sum.get_energy() && sum.get_Px() == parallel_sum.get_Px() && sum.get_Py() == parallel_sum.get_Py() &&
+                sum.get_Pz() == parallel_sum.get_Pz() && pair_counts[event] == parallel_pair_counts[event];
+    const double tolerance = 1e-9 * catalogue_sum.get_energy();
+    matching_catalogue += std::abs(sum.get_energy() - catalogue_sum.get_energy()) < tolerance && std::abs(sum.get_Px() - catalogue_sum.get_Px()) < tolerance &&
+                          std::abs(sum.get_Py() - catalogue_sum.get_Py()) < tolerance && std::abs(sum.get_Pz() - catalogue_sum.get_Pz()) < tolerance;
+  }
+  for (size_t event = 0; event < 5; ++event)
+  {
+    std::cout << "Event " << event << ": energy " << sums[event].get_energy() << " MeV, " << pair_counts[event] << " opposite-sign pairs" << std::endl;
+  }
+  std::cout << "Events where both passes agree: " << matching << " of " << number_of_events << std::endl;
+  std::cout << "Events whose sum matches their catalogue's: " << matching_catalogue << " of " << number_of_events << std::endl;
+
+  wait_for_enter("\n\x1b[33mHit Enter to go back to the menu:\x1b[0m");
+}
@@ -21,4 +21,40 @@ void showcase_four_momentum_class();
 // Showcase the ParticleCatalogue class
 // Demonstrates the usage and functionality of the ParticleCatalogue class
 void showcase_particle_catalogue();
+
+// Showcase the VariantCatalogue class
+// Demonstrates storing particles by value in one contiguous bucket per concrete type
+void showcase_variant_catalogue();
+
+// Showcase the ConcurrentParticleCatalogue class
+// Demonstrates several producer threads filling one catalogue while a reader takes snapshots
+void showcase_concurrent_catalogue();
+
+// Showcase the TaskScheduler
+// Demonstrates parallel_for, parallel_reduce and a TaskGraph on a batch of tau decays
+void showcase_task_scheduler();
+
+// Showcase the DalitzSampler
+// Demonstrates a tau decay sampled from the V-A matrix element and a batch of muon decays
+void showcase_dalitz_sampler();
+
+// Showcase the DecayBatch
+// Demonstrates checking many random decays in one pass, with every verdict compared to Particle::validate_decay_products
+void showcase_decay_batch();
+
+// Showcase the pair and triple finders
+// Demonstrates finding Z -> e- e+ candidates and three-particle combinations in a catalogue, checked against a brute-force scan
+void showcase_combinatorics();
+
+// Showcase the AngularIndex
+// Demonstrates radius and nearest-neighbour queries in (eta, phi) checked against a brute-force scan, and the rebuild after a boost
+void showcase_angular_index();
+
+// Showcase jet clustering
+// Demonstrates clustering the quarks and gluons of a catalogue into anti-kt jets, with constituents given as catalogue positions
+void showcase_jet_clustering();
+
+// Showcase the EventStore
+// Demonstrates storing many events in shared columns and processing them on a task scheduler, checked against a serial pass
+void showcase_event_store();
 #endif // SHOWCASE_H
\ No newline at end of file
@@ -201,7 +201,16 @@ void display_program_showcase_menu()
   std::cout << "  4. Decay Product functionality\n";
   std::cout << "  5. Four Momentum\n";
   std::cout << "  6. Particle Catalogue\n";
-  std::cout << "  7. Back\n";
+  std::cout << "  7. Variant Catalogue\n";
+  std::cout << "  8. Concurrent Particle Catalogue\n";
+  std::cout << "  9. Task Scheduler\n";
+  std::cout << "  10. Dalitz Sampler\n";
+  std::cout << "  11. Decay Batch\n";
+  std::cout << "  12. Combinatorics\n";
+  std::cout << "  13. Angular Index\n";
+  std::cout << "  14. Jet Clustering\n";
+  std::cout << "  15. Event Store\n";
+  std::cout << "  16. Back\n";
 }
 // Function to display the custom usage menu
 void display_custom_usage_menu(int sub_num)
@@ -366,13 +375,14 @@ void get_gluon_details(std::vector<Colour> &colour_charges)
     break;
   }
 }
-void get_electron_details(std::vector<double> &energy_deposited_in_layers, double energy)
+void get_electron_details(LayerEnergies &energy_deposited_in_layers, double energy)
 {
-  energy_deposited_in_layers.clear();
+  energy_deposited_in_layers.fill(0);
   std::cout << "Energy Deposited in layers:\n";
   std::cout << "1. Enter energy levels manually\n";
   std::cout << "2. Autoset energy levels to match energy of electron\n";
-  int choice = get_integer_input("Enter choice (1 or 2): ", 1, 2);
+  std::cout << "3. Generate energy levels from an electromagnetic shower profile\n";
+  int choice = get_integer_input("Enter choice (1, 2 or 3): ", 1, 3);
   if (choice == 1)
   {
     std::cout << "Enter 4 values of energy that sum to " << energy << std::endl;
@@ -387,23 +397,28 @@ void get_electron_details(std::vector<double> &energy_deposited_in_layers, doubl
         {
           std::cout << "Total must exactly match " << energy << ". Please re-enter all values.\n";
           sum = 0.0; // Reset sum and restart input
-          energy_deposited_in_layers.clear();
+          energy_deposited_in_layers.fill(0);
           i = -1; // Reset loop to the first item
         }
         else
         {
           sum += input;
-          energy_deposited_in_layers.push_back(input);
+          energy_deposited_in_layers[i] = input;
           break;
         }
       } while (true);
     }
   }
-  else
+  else if (choice == 2)
   {
     energy_deposited_in_layers = {energy / 4, energy / 4, energy / 4, energy / 4};
     std::cout << "Energy has been automatically distributed among the layers." << std::endl;
   }
+  else
+  {
+    energy_deposited_in_layers = ShowerModel().get_layer_energies(energy);
+    std::cout << "Energy has been distributed among the layers by the shower profile." << std::endl;
+  }
 }
 void get_neutrino_details(std::string &flavour, bool &has_interacted)
 {
@@ -1020,7 +1035,7 @@ void add_particles_menu_navigation(ParticleCatalogue<Particle> &user_catalogue)
           int lepton_number = (is_anti) ? -1 : 1;
           if (particle_type_string == "electron")
           {
-            std::vector<double> energy_deposited_in_layers;
+            LayerEnergies energy_deposited_in_layers;
             std::cout << std::endl;
             get_electron_details(energy_deposited_in_layers, four_momentum->get_energy());
             Electron *electron = new Electron(label, std::move(four_momentum), energy_deposited_in_layers, lepton_number);
@@ -1045,7 +1060,15 @@ void add_particles_menu_navigation(ParticleCatalogue<Particle> &user_catalogue)
             Tau *tau = new Tau(lepton_number);
             tau->set_label(label);
             tau->set_four_momentum(std::move(four_momentum));
-            tau->auto_set_decay_products(std::move(decay_products), decay_type);
+            // Leptonic decays are sampled from the V-A matrix element, the hadronic one keeps the fixed kinematics
+            if (!decay_products.empty() && dynamic_cast<const Lepton *>(decay_products[0].get()))
+            {
+              set_leptonic_decay_products(*tau, std::move(decay_products), decay_type, std::random_device{}());
+            }
+            else
+            {
+              tau->auto_set_decay_products(std::move(decay_products), decay_type);
+            }
             tau->print();
             wait_for_enter("\nHit Enter To Continue:");
             user_catalogue.add_particle(tau);
@@ -1312,18 +1335,19 @@ void view_catalogue_menu_navigation(ParticleCatalogue<Particle> &user_catalogue,
     std::cout << "6. Print Information by Exact Type\n";
     std::cout << "7. Find Particles by Label\n";
     std::cout << "8. Sort Particles by Property\n";
+    std::cout << "9. Summary Statistics\n";
     if (sub_catalogue)
     {
-      std::cout << "9. Back to Viewing Particle Catalogue Menu\n-";
+      std::cout << "10. Back to Viewing Particle Catalogue Menu\n-";
     }
     else
     {
-      std::cout << "9. Back to Particle Catalogue Menu\n-";
+      std::cout << "10. Back to Particle Catalogue Menu\n-";
     }
 
-    choice = get_integer_input("Enter your choice: ", 1, 9);
+    choice = get_integer_input("Enter your choice: ", 1, 10);
     size_t total_particles = user_catalogue.get_number_of_particles();
-    if (total_particles == 0 && choice != 9)
+    if (total_particles == 0 && choice != 10)
     {
       std::cout << "Catalogue is empty\n";
     }
@@ -1466,7 +1490,27 @@ void view_catalogue_menu_navigation(ParticleCatalogue<Particle> &user_catalogue,
         user_catalogue.print_all();
         break;
       }
-      case 9: // Back to Main Menu
+      case 9: // Summary Statistics
+      {
+        // One pass over the catalogue, in chunks on the shared task scheduler
+        CatalogueStatistics statistics = compute_statistics(user_catalogue);
+        std::cout << std::endl;
+        statistics.print();
+
+        std::cout << "\nPlot a histogram of:\n";
+        std::cout << "0. Nothing\n";
+        for (size_t property = 0; property < number_of_properties; ++property)
+        {
+          std::cout << property + 1 << ". " << get_property_name(static_cast<Property>(property)) << "\n";
+        }
+        int histogram_choice = get_integer_input("Enter your choice: ", 0, static_cast<int>(number_of_properties));
+        if (histogram_choice != 0)
+        {
+          print_histogram(statistics.get_all().get_histogram(static_cast<Property>(histogram_choice - 1)));
+        }
+        break;
+      }
+      case 10: // Back to Main Menu
         return;
       default:
         std::cout << "Invalid choice. Please try again.\n";
@@ -1484,81 +1528,82 @@ ParticleCatalogue<Particle> get_sub_catalogue(ParticleCatalogue<Particle> &user_
   std::string particle_type_string = input_particle_type();
   if (!particle_type_string.empty())
   {
+    // Select through a non-owning view, copying only the matching particles into the new catalogue
     if (particle_type_string == "up")
     {
-      return user_catalogue.get_sub_container_of_same_type<Up>();
+      return user_catalogue.get_view_of_type<Up>().materialise();
     }
     else if (particle_type_string == "charm")
     {
-      return user_catalogue.get_sub_container_of_same_type<Charm>();
+      return user_catalogue.get_view_of_type<Charm>().materialise();
     }
     else if (particle_type_string == "top")
     {
-      return user_catalogue.get_sub_container_of_same_type<Top>();
+      return user_catalogue.get_view_of_type<Top>().materialise();
     }
     else if (particle_type_string == "down")
     {
-      return user_catalogue.get_sub_container_of_same_type<Down>();
+      return user_catalogue.get_view_of_type<Down>().materialise();
     }
     else if (particle_type_string == "strange")
     {
-      return user_catalogue.get_sub_container_of_same_type<Strange>();
+      return user_catalogue.get_view_of_type<Strange>().materialise();
     }
     else if (particle_type_string == "bottom")
     {
-      return user_catalogue.get_sub_container_of_same_type<Bottom>();
+      return user_catalogue.get_view_of_type<Bottom>().materialise();
     }
     else if (particle_type_string == "electron")
     {
-      return user_catalogue.get_sub_container_of_same_type<Electron>();
+      return user_catalogue.get_view_of_type<Electron>().materialise();
     }
     else if (particle_type_string == "muon")
     {
-      return user_catalogue.get_sub_container_of_same_type<Muon>();
+      return user_catalogue.get_view_of_type<Muon>().materialise();
     }
     else if (particle_type_string == "tau")
     {
-      return user_catalogue.get_sub_container_of_same_type<Tau>();
+      return user_catalogue.get_view_of_type<Tau>().materialise();
     }
     else if (particle_type_string == "neutrino")
     {
-      return user_catalogue.get_sub_container_of_same_type<Neutrino>();
+      return user_catalogue.get_view_of_type<Neutrino>().materialise();
     }
     else if (particle_type_string == "gluon")
     {
-      return user_catalogue.get_sub_container_of_same_type<Gluon>();
+      return user_catalogue.get_view_of_type<Gluon>().materialise();
     }
     else if (particle_type_string == "photon")
     {
-      return user_catalogue.get_sub_container_of_same_type<Photon>();
+      return user_catalogue.get_view_of_type<Photon>().materialise();
     }
     else if (particle_type_string == "z")
     {
-      return user_catalogue.get_sub_container_of_same_type<Z>();
+      return user_catalogue.get_view_of_type<Z>().materialise();
     }
     else if (particle_type_string == "w")
     {
-      return user_catalogue.get_sub_container_of_same_type<W>();
+      return user_catalogue.get_view_of_type<W>().materialise();
     }
     else if (particle_type_string == "higgs")
     {
-      return user_catalogue.get_sub_container_of_same_type<Higgs>();
+      return user_catalogue.get_view_of_type<Higgs>().materialise();
     }
     else if (particle_type_string == "lepton")
     {
-      return user_catalogue.get_sub_container_of_same_type<Lepton>();
+      return user_catalogue.get_view_of_type<Lepton>().materialise();
     }
     else if (particle_type_string == "particle")
     {
-      return user_catalogue.get_sub_container_of_same_type<Particle>();
+      return user_catalogue.get_view_of_type<Particle>().materialise();
     }
     else if (particle_type_string == "boson")
     {
-      return user_catalogue.get_sub_container_of_same_type<Boson>();
+      return user_catalogue.get_view_of_type<Boson>().materialise();
     }
     else if (particle_type_string == "quark")
     {
-      return user_catalogue.get_sub_container_of_same_type<Quark>();
+      return user_catalogue.get_view_of_type<Quark>().materialise();
     }
     else
     {
@@ -1577,6 +1622,7 @@ void custom_usage_menu_navigation(ParticleCatalogue<Particle> &user_catalogue)
   while (true)
   {
     ParticleCatalogue<Particle> *current_catalogue = &user_catalogue;
+    std::vector<std::unique_ptr<ParticleCatalogue<Particle>>> sub_catalogues; // Owns the sub-catalogues made from this menu
     int sub_num = 0;
 
     while (true)
@@ -1602,7 +1648,7 @@ void custom_usage_menu_navigation(ParticleCatalogue<Particle> &user_catalogue)
         try
         {
           int current_num_of_particle = current_catalogue->get_number_of_particles();
-          ParticleCatalogue<Particle> *sub_container = new ParticleCatalogue<Particle>(get_sub_catalogue(*current_catalogue));
+          std::unique_ptr<ParticleCatalogue<Particle>> sub_container = std::make_unique<ParticleCatalogue<Particle>>(get_sub_catalogue(*current_catalogue));
           if (sub_container->get_number_of_particles() == current_num_of_particle)
           {
             std::cout << "No particles removed from current catalogue." << std::endl;
@@ -1610,7 +1656,8 @@ void custom_usage_menu_navigation(ParticleCatalogue<Particle> &user_catalogue)
           }
           else if (sub_container->get_number_of_particles() > 0)
           {
-            current_catalogue = sub_container;
+            current_catalogue = sub_container.get();
+            sub_catalogues.push_back(std::move(sub_container));
             sub_num++;
           }
           else
@@ -1650,7 +1697,7 @@ void program_showcase_menu_navigation()
   while (true)
   {
     display_program_showcase_menu();
-    choice = get_integer_input("Enter your choice: ", 1, 7);
+    choice = get_integer_input("Enter your choice: ", 1, 16);
     switch (choice)
     {
     case 1: // Full showcase
@@ -1689,7 +1736,43 @@ void program_showcase_menu_navigation()
       clear_screen();
       showcase_particle_catalogue();
       break;
-    case 7: // Back
+    case 7: // Variant catalogue
+      clear_screen();
+      showcase_variant_catalogue();
+      break;
+    case 8: // Concurrent particle catalogue
+      clear_screen();
+      showcase_concurrent_catalogue();
+      break;
+    case 9: // Task scheduler
+      clear_screen();
+      showcase_task_scheduler();
+      break;
+    case 10: // Dalitz sampler
+      clear_screen();
+      showcase_dalitz_sampler();
+      break;
+    case 11: // Decay batch
+      clear_screen();
+      showcase_decay_batch();
+      break;
+    case 12: // Pair and triple finders
+      clear_screen();
+      showcase_combinatorics();
+      break;
+    case 13: // Angular index
+      clear_screen();
+      showcase_angular_index();
+      break;
+    case 14: // Jet clustering
+      clear_screen();
+      showcase_jet_clustering();
+      break;
+    case 15: // Event store
+      clear_screen();
+      showcase_event_store();
+      break;
+    case 16: // Back
       clear_screen();
       return;
     default:
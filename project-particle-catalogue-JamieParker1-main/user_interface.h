@@ -4,9 +4,12 @@
 #include "ParticleCatalogue.h"
 #include "Particle.h"
 #include "helper_functions.h"
+#include "Statistics.h"
+#include "DalitzSampler.h"
 
 #include "leptons/Lepton.h"
 #include "leptons/Electron.h"
+#include "leptons/ElectronShower.h"
 #include "leptons/Muon.h"
 #include "leptons/Tau.h"
 #include "leptons/Neutrino.h"
@@ -30,6 +33,7 @@
 #include <limits>
 #include <variant>
 #include <stack>
+#include <random>
 
 // Gets a valid number from user
 double get_valid_number(const std::string &prompt, double minVal = -std::numeric_limits<double>::infinity(), double maxVal = std::numeric_limits<double>::infinity());
@@ -59,7 +63,7 @@ void display_operations_menu();
 // Functions to get particle info from user
 void get_momentum_values(double &px, double &py, double &pz);
 void get_quark_details(Colour &colour_charge, bool is_anti);
-void get_electron_details(std::vector<double> &energy_deposited_in_layers, double energy);
+void get_electron_details(LayerEnergies &energy_deposited_in_layers, double energy);
 void get_neutrino_details(std::string &flavour, bool &has_interacted);
 void get_w_details(int &charge);
 